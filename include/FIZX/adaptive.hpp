@@ -0,0 +1,120 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+
+namespace fizx
+{
+
+/**
+ * Counters of the steps taken by an adaptive integrator.
+*/
+struct AdaptiveStats
+{
+    size_t accepted = 0;
+    size_t rejected = 0;
+
+    /**
+     * Number of times the acceleration field was evaluated.
+    */
+    size_t evaluations = 0;
+
+    real smallest_step = 0;
+    real largest_step = 0;
+};
+
+/**
+ * Integrates particles with the embedded Runge-Kutta method of Dormand and Prince (RK5(4)).
+ * Every step estimates its own error from the embedded 4th order solution; steps above the
+ * tolerance are retried smaller, and the next step size is chosen from the error, so quiet
+ * periods take long steps and fast events short ones. The step size is kept between calls.
+ * Accelerations come from the particles' constant acceleration and accumulated forces, which
+ * are held over the call, plus an optional field evaluated at every stage. Damping is not
+ * applied, particles with infinite mass do not move. Fits the integration stage of
+ * BasicParticleWorld. The state kept between calls is handed to the field as plain std::vectors,
+ * so it is not charged to the memory account.
+*/
+template <size_t Dim>
+class BasicAdaptiveIntegrator
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+    /**
+     * Writes the acceleration of every particle given all positions and velocities.
+    */
+    using Field = std::function<void(const std::vector<vec_type>& positions,
+        const std::vector<vec_type>& velocities, std::vector<vec_type>& accelerations)>;
+
+private:
+    static constexpr int STAGES = 7;
+
+    real absolute_tolerance;
+    real relative_tolerance;
+    Field field;
+
+    /**
+     * Step size to try next, zero until the first step.
+    */
+    real next_step;
+
+    AdaptiveStats stats;
+
+    // State, stage derivatives and trial state, reused every call.
+    std::vector<vec_type> positions;
+    std::vector<vec_type> velocities;
+    std::vector<vec_type> constant;
+    std::vector<real> inverse_masses;
+    std::vector<vec_type> stage_velocities[STAGES];
+    std::vector<vec_type> stage_accelerations[STAGES];
+    std::vector<vec_type> trial_positions;
+    std::vector<vec_type> trial_velocities;
+
+    void evaluate(int stage);
+    real try_step(real step);
+
+public:
+    /**
+     * @param absolute_tolerance - error allowed on any position or velocity component.
+     * @param relative_tolerance - error allowed relative to the size of the component.
+    */
+    explicit BasicAdaptiveIntegrator(real absolute_tolerance = 1e-6, real relative_tolerance = 1e-6);
+
+    /**
+     * Moves the particles forward in time by duration, in as many steps as the tolerance needs.
+     * Clears the accumulated forces.
+     * @return the number of accepted steps.
+    */
+    size_t advance(std::vector<particle_type>& particles, real duration);
+
+    void set_tolerance(real absolute_tolerance, real relative_tolerance);
+    void set_field(Field field);
+
+    /**
+     * Sets the size of the next step tried, zero lets the integrator pick.
+    */
+    void set_next_step(real step);
+    real get_next_step() const;
+
+    const AdaptiveStats& get_stats() const;
+    void reset_stats();
+};
+
+using AdaptiveIntegrator = BasicAdaptiveIntegrator<3>;
+using AdaptiveIntegrator2D = BasicAdaptiveIntegrator<2>;
+
+// Implemented in adaptive.cpp for these dimensions only.
+extern template class BasicAdaptiveIntegrator<2>;
+extern template class BasicAdaptiveIntegrator<3>;
+
+} // namespace fizx
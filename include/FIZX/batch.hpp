@@ -0,0 +1,143 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Many small independent worlds of the same particle count, stepped in lockstep.
+ * Particle i of every world is stored side by side, field by field: the x position of particle i
+ * in worlds 0, 1, 2, ... is one contiguous row, so a SIMD lane is a world and one pass over the
+ * rows steps every world at once. Worlds are padded up to a multiple of the widest SIMD width;
+ * padding lanes hold infinite masses and never move. The rows are charged to Subsystem::particles;
+ * the list of force generators is not.
+*/
+template <size_t Dim>
+class BasicWorldBatch
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+    /**
+     * Fields of a particle, in the order BasicParticle stores them.
+     * Vector fields have Dim rows, one per component.
+    */
+    enum class Field
+    {
+        position = 0,
+        velocity = Dim,
+        acceleration = 2 * Dim,
+        damping = 3 * Dim,
+        inverse_mass = 3 * Dim + 1,
+        net_force = 3 * Dim + 2
+    };
+
+    /**
+     * Adds forces to every world through the net force rows, given the step duration.
+    */
+    using ForceGenerator = std::function<void(BasicWorldBatch&, real)>;
+
+    static constexpr std::size_t ROWS = 4 * Dim + 2;
+    static constexpr std::size_t LANE_ALIGNMENT = 8;
+
+private:
+    std::size_t worlds;
+    std::size_t particles;
+
+    /**
+     * Reals per row, worlds rounded up to LANE_ALIGNMENT.
+    */
+    std::size_t stride;
+
+    tracked_vector<real, Subsystem::particles> state;
+
+    /**
+     * State every world returns to on reset.
+    */
+    tracked_vector<real, Subsystem::particles> initial;
+
+    /**
+     * damping^duration per particle and world, recomputed when the duration or damping changes.
+    */
+    tracked_vector<real, Subsystem::particles> drag;
+    real drag_duration;
+    bool drag_stale;
+
+    std::vector<ForceGenerator> force_generators;
+
+    void check(std::size_t world, std::size_t index) const;
+
+public:
+    /**
+     * @param world_count - number of worlds.
+     * @param particle_count - number of particles in every world.
+    */
+    BasicWorldBatch(std::size_t world_count, std::size_t particle_count);
+
+    /**
+     * Runs the force generators, then integrates every world by duration.
+    */
+    void step(real duration);
+
+    /**
+     * Sets the particles of a world, and the state reset returns it to.
+     * @param particles - exactly particle_count particles.
+    */
+    void load(std::size_t world, const std::vector<particle_type>& particles);
+
+    /**
+     * Copies the particles of a world out.
+    */
+    void store(std::size_t world, std::vector<particle_type>& particles) const;
+
+    /**
+     * Returns a world to the state it was last loaded with.
+    */
+    void reset(std::size_t world);
+
+    void set_particle(std::size_t world, std::size_t index, const particle_type& particle);
+    particle_type get_particle(std::size_t world, std::size_t index) const;
+
+    /**
+     * Gets the row of one field component of a particle, holding it for every world.
+     * @param component - component of a vector field, 0 for damping and inverse mass.
+    */
+    real* row(Field field, std::size_t index, std::size_t component = 0);
+    const real* row(Field field, std::size_t index, std::size_t component = 0) const;
+
+    /**
+     * Adds a force generator, run in order of registration at the start of every step.
+    */
+    void add_force_generator(ForceGenerator generator);
+
+    std::size_t world_count() const;
+    std::size_t particle_count() const;
+
+    /**
+     * Number of reals in a row, at least world_count.
+    */
+    std::size_t get_stride() const;
+};
+
+using WorldBatch = BasicWorldBatch<3>;
+using WorldBatch2D = BasicWorldBatch<2>;
+
+// Implemented in batch.cpp for these dimensions only.
+extern template class BasicWorldBatch<2>;
+extern template class BasicWorldBatch<3>;
+
+} // namespace fizx
@@ -0,0 +1,119 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Finds when a sphere moving in a straight line first touches a still one.
+ * @param start - centre of the moving sphere at the start of the motion.
+ * @param displacement - motion of the moving sphere.
+ * @param other - centre of the still sphere.
+ * @param radius_sum - sum of both radii.
+ * @return the fraction of the motion in [0, 1] at which they touch, or a negative value if they
+ * do not touch while approaching. Spheres that start overlapping and approach touch at 0.
+*/
+template <size_t Dim>
+real time_of_impact(const Vector<real, Dim>& start, const Vector<real, Dim>& displacement,
+    const Vector<real, Dim>& other, real radius_sum);
+
+// Implemented in ccd.cpp for these dimensions only.
+extern template real time_of_impact<2>(const Vector<real, 2>&, const Vector<real, 2>&, const Vector<real, 2>&, real);
+extern template real time_of_impact<3>(const Vector<real, 3>&, const Vector<real, 3>&, const Vector<real, 3>&, real);
+
+/**
+ * Integrates particles, sweeping the fast ones so they cannot pass through other particles.
+ * Particles are spheres of one radius. Those flagged as fast, or moving more than their radius in
+ * a step, are swept from their start to their end position against every other particle; at the
+ * first impact they bounce and the rest of the step is swept again, up to a number of sub-steps.
+ * Everything else takes the discrete integration of Particle. The particles hit are taken at
+ * their end positions, which is exact for still ones and off by less than a radius for slow
+ * ones. Fits the integration stage of BasicParticleWorld.
+*/
+template <size_t Dim>
+class BasicSweptIntegrator
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+private:
+    real radius;
+    size_t max_substeps;
+    real restitution;
+
+    /**
+     * Non zero for particles always swept.
+    */
+    tracked_vector<std::uint8_t, Subsystem::broadphase> flags;
+
+    // Working arrays, reused every step.
+    tracked_vector<size_t, Subsystem::broadphase> fast;
+    tracked_vector<vec_type, Subsystem::broadphase> starts;
+    tracked_vector<std::uint8_t, Subsystem::broadphase> swept;
+    tracked_vector<std::pair<real, size_t>, Subsystem::broadphase> sorted;
+
+    size_t impact_count;
+
+    /**
+     * Finds the first particle hit by particle index moving from start by displacement.
+     * @return the fraction of the motion at impact, negative if nothing is hit.
+    */
+    real first_impact(const std::vector<particle_type>& particles, size_t index,
+        const vec_type& start, const vec_type& displacement, size_t& hit) const;
+
+public:
+    /**
+     * @param radius - radius of every particle (m).
+     * @param max_substeps - most impacts resolved per particle per step, at least one.
+     * @param restitution - fraction of the approach speed kept after an impact, in [0, 1].
+    */
+    explicit BasicSweptIntegrator(real radius, size_t max_substeps = 4, real restitution = 0.5);
+
+    /**
+     * Moves the particles forward in time by duration.
+    */
+    void integrate(std::vector<particle_type>& particles, real duration);
+
+    /**
+     * Flags a particle to be swept every step, whatever its speed.
+    */
+    void set_fast(size_t index, bool fast);
+    bool is_fast(size_t index) const;
+
+    void set_radius(real radius);
+    void set_max_substeps(size_t max_substeps);
+    void set_restitution(real restitution);
+
+    /**
+     * Number of particles swept in the last step.
+    */
+    size_t get_swept_count() const;
+
+    /**
+     * Number of impacts resolved in the last step.
+    */
+    size_t get_impact_count() const;
+};
+
+using SweptIntegrator = BasicSweptIntegrator<3>;
+using SweptIntegrator2D = BasicSweptIntegrator<2>;
+
+// Implemented in ccd.cpp for these dimensions only.
+extern template class BasicSweptIntegrator<2>;
+extern template class BasicSweptIntegrator<3>;
+
+} // namespace fizx
@@ -0,0 +1,184 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Mass spring cloth and soft bodies over Dim dimensional particles, stepped with backward Euler so
+ * stiff springs stay stable at large steps. The springs are fixed once the first step is taken;
+ * every particle lists its springs in compressed sparse row form. A step linearises the spring
+ * forces and solves
+ *     (M + h * D + h^2 * K) dv = h * (f + h * -K * v)
+ * for the change in velocity with conjugate gradients preconditioned by the diagonal, where K and
+ * D are the stiffness and damping of the springs. The matrix is never assembled: products sum one
+ * Dim by Dim block per spring through the lists of every particle. Particles of infinite mass are
+ * pinned. The solver vectors are kept between steps, and the last change in velocity is the first
+ * guess of the next solve.
+*/
+template <size_t Dim>
+class BasicCloth
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+    using index_list = tracked_vector<size_t, Subsystem::other>;
+    using real_list = tracked_vector<real, Subsystem::scratch>;
+
+    struct Spring
+    {
+        size_t first;
+        size_t second;
+        real rest_length;
+        real stiffness;
+    };
+
+private:
+    tracked_vector<Spring, Subsystem::other> springs;
+
+    /**
+     * Start of every particle's springs in incident, with one extra entry at the end.
+    */
+    index_list offsets;
+
+    /**
+     * Spring indices of every particle, back to back.
+    */
+    index_list incident;
+
+    /**
+     * Particle at the other end of every spring in incident.
+    */
+    index_list neighbours;
+
+    /**
+     * Damping along every spring, opposing the relative speed of its ends (N s/m).
+    */
+    real damping;
+
+    real tolerance;
+    size_t max_iterations;
+
+    size_t iterations;
+    real residual;
+
+    /**
+     * Reals of the upper triangle of a symmetric Dim by Dim block.
+    */
+    static constexpr std::size_t BLOCK = Dim * (Dim + 1) / 2;
+
+    // Per step state, kept to avoid reallocating. Vectors hold Dim reals per particle, blocks
+    // BLOCK reals per spring.
+    real_list blocks;
+    real_list spring_forces;
+    real_list positions;
+    real_list velocities;
+    real_list masses;
+    real_list preconditioner;
+    real_list rhs;
+    real_list solution;
+    real_list residuals;
+    real_list preconditioned;
+    real_list direction;
+    real_list product;
+
+    /**
+     * Builds the lists of springs of every particle.
+    */
+    void build(size_t particle_count);
+
+    /**
+     * result = A * vector, zero at pinned particles.
+    */
+    void multiply(const real_list& vector, real_list& result) const;
+
+    /**
+     * Runs preconditioned conjugate gradients on the system set up by step.
+    */
+    void solve();
+
+public:
+    /**
+     * @param damping - damping along every spring (N s/m).
+    */
+    explicit BasicCloth(real damping = 0);
+
+    /**
+     * Adds a spring between two particles.
+     * @param stiffness - force per metre of stretch (N/m).
+     * @param rest_length - length at which the spring pulls neither way (m).
+     * @return the index of the spring.
+     * @throws std::logic_error once the cloth has been stepped.
+    */
+    size_t add_spring(size_t first, size_t second, real stiffness, real rest_length);
+
+    /**
+     * Adds a spring at rest at the current distance between two particles.
+    */
+    size_t add_spring(const std::vector<particle_type>& particles, size_t first, size_t second, real stiffness);
+
+    /**
+     * Integrates the particles by duration under the springs, the forces accumulated on them and
+     * their acceleration, then clears the forces. The particles must be the ones the springs
+     * were added for, in the same order.
+     * @throws std::runtime_error if a spring joins a particle that does not exist.
+    */
+    void step(std::vector<particle_type>& particles, real duration);
+
+    /**
+     * Setter for the damping along every spring.
+     * @param damping Non negative (N s/m).
+    */
+    void set_damping(real damping);
+
+    /**
+     * Setter for when the solve stops, as the residual relative to the right hand side.
+     * @param tolerance Positive.
+    */
+    void set_tolerance(real tolerance);
+
+    /**
+     * Setter for the most iterations of one solve; a solve that runs out keeps its best guess.
+    */
+    void set_max_iterations(size_t iterations);
+
+    real get_damping() const;
+    real get_tolerance() const;
+    size_t get_max_iterations() const;
+
+    /**
+     * Gets the iterations taken by the last solve.
+    */
+    size_t get_iterations() const;
+
+    /**
+     * Gets the relative residual left by the last solve.
+    */
+    real get_residual() const;
+
+    const Spring& get_spring(size_t index) const;
+    size_t spring_count() const;
+
+    const index_list& get_offsets() const;
+    const index_list& get_incident() const;
+};
+
+using Cloth = BasicCloth<3>;
+using Cloth2D = BasicCloth<2>;
+
+// Implemented in cloth.cpp for these dimensions only.
+extern template class BasicCloth<2>;
+extern template class BasicCloth<3>;
+
+} // namespace fizx
@@ -0,0 +1,219 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * A particle touching static geometry.
+*/
+struct StaticContact
+{
+    std::uint32_t particle;
+
+    /**
+     * Index of the collider touched, in order of addition.
+    */
+    std::uint32_t collider;
+
+    /**
+     * Closest point of the collider to the particle centre.
+    */
+    vec3f point;
+
+    /**
+     * Unit direction pushing the particle out of the collider.
+    */
+    vec3f normal;
+
+    /**
+     * Distance the particle must move along the normal to stop touching.
+    */
+    real depth;
+};
+
+/**
+ * Static 3D geometry the particles collide with, as spheres of one radius: planes, axis aligned
+ * boxes, regular grid heightfields and triangle meshes.
+ * Geometry is never moved or refit, so everything queries need is computed when a collider is
+ * added and read only afterwards: heightfield cells keep their triangle normals, and a mesh gets a
+ * bounding volume hierarchy flattened depth first into one array, the first child of a node right
+ * after it and its triangles stored in leaf order. Queries and resolution run over whole particle
+ * arrays, split across the worker pool. The geometry is charged to Subsystem::broadphase; the
+ * contacts returned by query live in the caller's vector.
+*/
+class StaticColliders
+{
+public:
+    /**
+     * Node of a mesh hierarchy. A leaf has count triangles from first; an inner node has count 0,
+     * its first child just after it and its second child at first.
+    */
+    struct Node
+    {
+        vec3f lower;
+        vec3f upper;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    /**
+     * Most triangles in a leaf.
+    */
+    static constexpr std::uint32_t LEAF_SIZE = 4;
+
+    /**
+     * Most contacts resolved for one particle per call.
+    */
+    static constexpr int RESOLVE_PASSES = 4;
+
+    using node_list = tracked_vector<Node, Subsystem::broadphase>;
+
+private:
+    enum class Kind
+    {
+        plane,
+        box,
+        heightfield,
+        mesh
+    };
+
+    struct Collider
+    {
+        Kind kind;
+
+        /**
+         * Plane normal, box lower corner, heightfield origin.
+        */
+        vec3f a;
+
+        /**
+         * Box upper corner, heightfield cell size along x and z in x and z.
+        */
+        vec3f b;
+
+        /**
+         * Plane offset along its normal.
+        */
+        real offset;
+
+        // Heightfield samples and cells, or the mesh root node, from first in the shared arrays.
+        std::uint32_t first;
+        std::uint32_t cells;
+        std::uint32_t columns;
+        std::uint32_t rows;
+    };
+
+    struct Triangle
+    {
+        vec3f a;
+        vec3f b;
+        vec3f c;
+        vec3f normal;
+    };
+
+    real radius;
+    real restitution;
+
+    using contact_list = tracked_vector<StaticContact, Subsystem::contacts>;
+
+    tracked_vector<Collider, Subsystem::broadphase> colliders;
+
+    // Heightfield heights, row major by z then x, and the normals of the two triangles of every cell.
+    tracked_vector<real, Subsystem::broadphase> heights;
+    tracked_vector<vec3f, Subsystem::broadphase> cell_normals;
+
+    node_list nodes;
+    tracked_vector<Triangle, Subsystem::broadphase> triangles;
+
+    /**
+     * Appends the contacts of one particle centre, at most one per collider.
+    */
+    void collide(const vec3f& centre, std::uint32_t particle, contact_list& contacts) const;
+
+    bool touch_heightfield(const Collider& field, const vec3f& centre, StaticContact& contact) const;
+    bool touch_mesh(const Collider& mesh, const vec3f& centre, StaticContact& contact) const;
+
+    /**
+     * Builds the node of the triangles order[begin, end) and its children.
+     * @return the index of the node.
+    */
+    std::uint32_t build(const tracked_vector<Triangle, Subsystem::scratch>& source,
+        const tracked_vector<vec3f, Subsystem::scratch>& centres, tracked_vector<std::uint32_t, Subsystem::scratch>& order,
+        std::uint32_t begin, std::uint32_t end, std::uint32_t base);
+
+public:
+    /**
+     * @param radius - radius of every particle (m).
+     * @param restitution - fraction of the approach speed kept when bouncing, in [0, 1].
+    */
+    explicit StaticColliders(real radius, real restitution = 0);
+
+    /**
+     * Adds the half space below a plane, the points x with normal * x <= offset.
+     * @return the index of the collider.
+    */
+    std::size_t add_plane(const vec3f& normal, real offset);
+
+    /**
+     * Adds a solid axis aligned box.
+    */
+    std::size_t add_box(const vec3f& lower, const vec3f& upper);
+
+    /**
+     * Adds a heightfield, solid below its surface. Samples are spaced along x and z from origin,
+     * with y = origin.y + height; every cell is split into two triangles. Particles beyond its edges
+     * do not touch it.
+     * @param heights - columns * rows heights, row by row along z, x varying fastest.
+    */
+    std::size_t add_heightfield(const vec3f& origin, real cell_x, real cell_z, std::size_t columns, std::size_t rows,
+        const std::vector<real>& heights);
+
+    /**
+     * Adds a triangle mesh and builds its hierarchy. Meshes are two sided surfaces, not solids.
+     * @param indices - three vertex indices per triangle.
+    */
+    std::size_t add_mesh(const std::vector<vec3f>& vertices, const std::vector<std::uint32_t>& indices);
+
+    /**
+     * Finds every particle touching a collider, at most one contact per particle and collider,
+     * ordered by particle then collider.
+    */
+    void query(const std::vector<Particle>& particles, std::vector<StaticContact>& contacts) const;
+
+    /**
+     * Pushes the particles touching colliders out along the contact normals and removes the part
+     * of their velocities going into the colliders, keeping restitution of it. Contacts are
+     * resolved one at a time, deepest first, and found again from the pushed centre, so colliders
+     * that overlap push a particle out once rather than once each; at most RESOLVE_PASSES per
+     * particle. Particles of infinite mass are left alone. Fits the resolver stage of
+     * BasicParticleWorld.
+    */
+    void resolve(std::vector<Particle>& particles, real duration);
+
+    void set_radius(real radius);
+    void set_restitution(real restitution);
+
+    std::size_t collider_count() const;
+
+    /**
+     * Nodes and triangles of every mesh hierarchy.
+    */
+    const node_list& get_nodes() const;
+    std::size_t triangle_count() const;
+};
+
+} // namespace fizx
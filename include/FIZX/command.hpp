@@ -0,0 +1,187 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "param.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * A bounded lock-free queue with any number of producers and a single consumer.
+ * Producers may push from any thread at any time; pushes from one producer are popped in the order
+ * they were made. Storage is allocated once, charged to Subsystem::other, so neither side ever
+ * allocates or blocks.
+*/
+template <typename T>
+class CommandQueue
+{
+private:
+    struct Cell
+    {
+        /**
+         * Equals the position for an empty cell and position + 1 once it holds a value.
+        */
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    Cell* cells;
+    std::size_t mask;
+
+    // Kept on separate cache lines so producers and the consumer do not contend.
+    alignas(64) std::atomic<std::size_t> push_position;
+    alignas(64) std::size_t pop_position;
+
+public:
+    /**
+     * @param capacity - most values held at once, rounded up to a power of two. Storage for all of
+     * them is allocated up front.
+    */
+    explicit CommandQueue(std::size_t capacity = 1024)
+    : push_position(0), pop_position(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells = static_cast<Cell*>(MemoryAccount::shared().allocate(Subsystem::other, size * sizeof(Cell), alignof(Cell)));
+        mask = size - 1;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            new (&cells[i]) Cell();
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~CommandQueue()
+    {
+        for (std::size_t i = 0; i <= mask; ++i)
+        {
+            cells[i].~Cell();
+        }
+        MemoryAccount::shared().deallocate(Subsystem::other, cells, (mask + 1) * sizeof(Cell), alignof(Cell));
+    }
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * Adds a value, may be called from any thread.
+     * @return false if the queue is full.
+    */
+    bool push(T value)
+    {
+        std::size_t position = push_position.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells[position & mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = push_position.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest value, may only be called from the consumer thread.
+     * @return false if no value is ready.
+    */
+    bool pop(T& value)
+    {
+        Cell* cell = &cells[pop_position & mask];
+        if (cell->sequence.load(std::memory_order_acquire) != pop_position + 1) return false;
+        value = std::move(cell->value);
+        cell->sequence.store(pop_position + mask + 1, std::memory_order_release);
+        ++pop_position;
+        return true;
+    }
+
+    std::size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
+
+/**
+ * An edit to the particles of a world, queued from any thread and applied during the next step.
+*/
+template <size_t Dim>
+struct BasicParticleCommand
+{
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+    enum class Type
+    {
+        spawn,
+        add_force,
+        set_position,
+        set_velocity
+    };
+
+    Type type;
+
+    /**
+     * Index of the particle to edit, unused by spawn.
+    */
+    size_t index;
+
+    /**
+     * Force, position or velocity to apply.
+    */
+    vec_type value;
+
+    /**
+     * Particle to add, used by spawn only.
+    */
+    particle_type particle;
+
+    static BasicParticleCommand spawn(const particle_type& particle)
+    {
+        return {Type::spawn, -1, vec_type(), particle};
+    }
+
+    static BasicParticleCommand add_force(size_t index, const vec_type& force)
+    {
+        return {Type::add_force, index, force, particle_type()};
+    }
+
+    static BasicParticleCommand set_position(size_t index, const vec_type& position)
+    {
+        return {Type::set_position, index, position, particle_type()};
+    }
+
+    static BasicParticleCommand set_velocity(size_t index, const vec_type& velocity)
+    {
+        return {Type::set_velocity, index, velocity, particle_type()};
+    }
+};
+
+using ParticleCommand = BasicParticleCommand<3>;
+using ParticleCommand2D = BasicParticleCommand<2>;
+
+} // namespace fizx
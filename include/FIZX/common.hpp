@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <charconv>
 #include <stdexcept>
+#include <string>
 #include <math.h>
 
 #include "param.hpp"
@@ -17,10 +19,40 @@ namespace fizx
 /**
  * Compares two floating point values with a tolarance of EPSILON_TOLERANCE
 */
-bool compare_real_equal(real a, real b) {
+inline bool compare_real_equal(real a, real b) {
     return std::abs(a - b) < EPSILON_TOLERANCE;
 }
 
+/**
+ * Largest number of characters format_real() writes.
+*/
+constexpr int REAL_CHARS = 32;
+
+/**
+ * Writes the shortest text that reads back as exactly value, without allocating.
+ * @param out - at least REAL_CHARS characters.
+ * @return the end of the text written.
+*/
+inline char* format_real(char* out, double value)
+{
+    return std::to_chars(out, out + REAL_CHARS, value).ptr;
+}
+
+inline char* format_real(char* out, float value)
+{
+    return std::to_chars(out, out + REAL_CHARS, value).ptr;
+}
+
+/**
+ * Appends the shortest text that reads back as exactly value.
+*/
+template <typename T>
+inline void append_real(std::string& out, T value)
+{
+    char text[REAL_CHARS];
+    out.append(text, format_real(text, value));
+}
+
 // REMOVE TEMPORARY MACROS
 #undef EPSILON_TOLERANCE
 
@@ -0,0 +1,190 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+#include "neighbour.hpp"
+
+namespace fizx
+{
+
+/**
+ * Contacts kept from one step to the next, keyed by particle pair.
+ * An open addressing hash table with linear probing. Storage only grows, so a scene with a steady
+ * number of contacts stops allocating after its first steps.
+*/
+class ContactCache
+{
+public:
+    struct Contact
+    {
+        /**
+         * Particle indices, a < b. a is EMPTY for an unused slot.
+        */
+        std::uint32_t a;
+        std::uint32_t b;
+
+        /**
+         * Impulse accumulated along the contact normal during the last solve.
+        */
+        real impulse;
+
+        /**
+         * Frame the contact was last touched in.
+        */
+        std::uint32_t stamp;
+    };
+
+    static constexpr std::uint32_t EMPTY = 0xFFFFFFFFu;
+
+private:
+    tracked_vector<Contact, Subsystem::contacts> slots;
+
+    /**
+     * Table the live contacts are moved to when evicting, swapped with slots afterwards.
+    */
+    tracked_vector<Contact, Subsystem::contacts> spare;
+
+    std::size_t count;
+    std::uint32_t stamp;
+
+    std::size_t probe(std::uint32_t a, std::uint32_t b) const;
+    void rehash(std::size_t capacity);
+
+public:
+    /**
+     * @param capacity - number of contacts to hold without growing.
+    */
+    explicit ContactCache(std::size_t capacity = 1024);
+
+    /**
+     * Makes room for more contacts, so touching them does not move existing ones.
+    */
+    void reserve(std::size_t additional);
+
+    /**
+     * Finds the contact of a pair or adds it with no impulse, and marks it live in this frame.
+     * @return index of the contact's slot, valid until the next reserve, touch past the reserved room or evict.
+    */
+    std::size_t touch(std::uint32_t a, std::uint32_t b);
+
+    /**
+     * Finds the contact of a pair.
+     * @return the contact, or nullptr if the pair is not cached.
+    */
+    const Contact* find(std::uint32_t a, std::uint32_t b) const;
+
+    Contact& operator[](std::size_t slot);
+    const Contact& operator[](std::size_t slot) const;
+
+    /**
+     * Removes the contacts not touched since the last evict, and starts a new frame.
+     * @return the number of contacts removed.
+    */
+    std::size_t evict();
+
+    void clear();
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+};
+
+/**
+ * Resolves contacts between particles treated as spheres of one radius.
+ * Uses sequential impulses with a position bias. The impulse of every contact is kept in a
+ * ContactCache and applied again at the start of the next step (warm starting), so resting and
+ * stacked particles converge in far fewer iterations than starting from zero every step.
+ * Contacts are found with a neighbour list, rebuilt only when particles have moved far enough.
+*/
+template <size_t Dim>
+class BasicContactSolver
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+private:
+    struct Row
+    {
+        std::uint32_t a;
+        std::uint32_t b;
+        std::size_t slot;
+        vec_type normal;
+        real bias;
+        real effective_mass;
+        real impulse;
+    };
+
+    real radius;
+    size_t iterations;
+    bool warm_starting;
+
+    /**
+     * Fraction of the penetration removed per step.
+    */
+    real bias_factor;
+
+    /**
+     * Penetration allowed without any bias, keeps resting contacts from jittering.
+    */
+    real slop;
+
+    BasicNeighbourList<Dim> neighbours;
+    ContactCache cache;
+
+    // Working arrays, reused every step.
+    tracked_vector<Row, Subsystem::contacts> rows;
+    tracked_vector<vec_type, Subsystem::contacts> velocities;
+    tracked_vector<real, Subsystem::contacts> inverse_masses;
+
+public:
+    /**
+     * @param radius - radius of every particle (m).
+     * @param iterations - solver passes over the contacts per step.
+    */
+    explicit BasicContactSolver(real radius, size_t iterations = 8);
+
+    /**
+     * Finds the touching particles and changes their velocities to stop them sinking into each other.
+     * Fits the resolver stage of BasicParticleWorld.
+    */
+    void solve(std::vector<particle_type>& particles, real duration);
+
+    void set_iterations(size_t iterations);
+    void set_warm_starting(bool enabled);
+
+    /**
+     * @param bias_factor - fraction of the penetration removed per step, in [0, 1].
+     * @param slop - penetration allowed without correction (m).
+    */
+    void set_bias(real bias_factor, real slop);
+
+    size_t get_iterations() const;
+    bool get_warm_starting() const;
+
+    /**
+     * Number of contacts solved in the last step.
+    */
+    size_t contact_count() const;
+
+    const ContactCache& get_cache() const;
+};
+
+using ContactSolver = BasicContactSolver<3>;
+using ContactSolver2D = BasicContactSolver<2>;
+
+// Implemented in contact.cpp for these dimensions only.
+extern template class BasicContactSolver<2>;
+extern template class BasicContactSolver<3>;
+
+} // namespace fizx
@@ -1,11 +1,20 @@
 /**
- * 
+ *
 */
 
 #pragma once
 
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "param.hpp"
 
@@ -13,6 +22,135 @@
 namespace fizx
 {
 
+/**
+ * A fixed set of worker threads fed from a single queue.
+ * Threads waiting on work in the pool are expected to help run the queued tasks they are waiting
+ * for (see TaskGroup), so tasks may safely submit and wait on more tasks.
+*/
+class WorkerPool
+{
+private:
+    struct Job
+    {
+        const void* owner;
+        std::function<void()> work;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queue;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping;
+
+    void work();
+
+public:
+    /**
+     * @param threads - number of worker threads, 0 uses one less than the hardware concurrency.
+    */
+    explicit WorkerPool(size_t threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Queues a task to run on a worker.
+     * @param task - the function to run.
+     * @param owner - tag identifying who waits on the task, see run_one.
+     * @warning the task must not throw, use a TaskGroup to carry exceptions back.
+    */
+    void submit(std::function<void()> task, const void* owner = nullptr);
+
+    /**
+     * Runs one queued task on the calling thread.
+     * @param owner - only run a task submitted with this tag, nullptr runs any task.
+     * @return false if there was no such task.
+    */
+    bool run_one(const void* owner = nullptr);
+
+    /**
+     * Number of worker threads, not counting threads that help while waiting.
+    */
+    size_t size() const;
+
+    /**
+     * Gets the pool shared by every part of the engine.
+    */
+    static WorkerPool& shared();
+};
+
+/**
+ * Tracks a set of tasks submitted to a worker pool so they can be waited on together.
+*/
+class TaskGroup
+{
+private:
+    std::atomic<size_t> pending;
+    std::mutex mutex;
+    std::exception_ptr error;
+
+public:
+    TaskGroup();
+
+    /**
+     * Submits a task to the pool as part of this group.
+    */
+    void run(WorkerPool& pool, std::function<void()> work);
+
+    /**
+     * Runs queued tasks on the calling thread until every task of the group has finished.
+     * Rethrows the first exception thrown by a task of the group.
+    */
+    void wait(WorkerPool& pool);
+
+    /**
+     * Checks if every task of the group has finished.
+    */
+    bool done() const;
+};
+
+/**
+ * Splits the range [0, count) into contiguous chunks and calls func(begin, end) for each chunk
+ * on the shared worker pool. Returns once every chunk has finished; exceptions thrown by a chunk
+ * are rethrown on the calling thread.
+ * @param count - number of elements in the range.
+ * @param func - callable taking the (begin, end) bounds of a chunk.
+ * @param min_chunk - smallest number of elements worth handing to a thread.
+*/
+template <typename Function>
+void parallel_for(size_t count, Function func, size_t min_chunk = 1024)
+{
+    if (count <= 0) return;
+
+    WorkerPool& pool = WorkerPool::shared();
+    size_t threads = pool.size() + 1;
+    size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, count / std::max<size_t>(1, min_chunk)));
+    if (chunks == 1)
+    {
+        func(0, count);
+        return;
+    }
 
+    TaskGroup group;
+    for (size_t c = 1; c < chunks; ++c)
+    {
+        size_t begin = static_cast<size_t>((static_cast<long long>(count) * c) / chunks);
+        size_t end = static_cast<size_t>((static_cast<long long>(count) * (c + 1)) / chunks);
+        group.run(pool, [&func, begin, end]() { func(begin, end); });
+    }
+    // The calling thread takes the first chunk.
+    std::exception_ptr error;
+    try
+    {
+        func(0, static_cast<size_t>(count / chunks));
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    group.wait(pool);
+    if (error) std::rethrow_exception(error);
+}
 
-} // namespace fizx
\ No newline at end of file
+} // namespace fizx
@@ -0,0 +1,135 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Totals of a particle array used to watch a simulation for blow ups. Particles of infinite mass
+ * are counted and bounded but carry no energy, momentum or mass.
+*/
+template <size_t Dim>
+struct BasicTotals
+{
+    using vec_type = Vector<real, Dim>;
+
+    std::size_t count = 0;
+    std::size_t infinite_mass_count = 0;
+
+    real kinetic_energy = 0;
+    vec_type momentum;
+    real mass = 0;
+
+    /**
+     * Sum of mass * position, the centre of mass times the mass.
+    */
+    vec_type moment;
+
+    /**
+     * Bounds of the positions, lower above upper when there are no particles.
+    */
+    vec_type lower;
+    vec_type upper;
+
+    /**
+     * False if any position or velocity is infinite or NaN.
+    */
+    bool finite = true;
+
+    /**
+     * Totals of no particles.
+    */
+    BasicTotals();
+
+    /**
+     * Centre of mass, the origin when there is no finite mass.
+    */
+    vec_type centre_of_mass() const;
+
+    /**
+     * Adds the totals of the particles after these ones.
+    */
+    void merge(const BasicTotals& other);
+};
+
+/**
+ * Computes BasicTotals in one pass over a particle array, reading the packed particle fields.
+ * The array is cut into blocks of a fixed size, each summed in order by one task, and the block
+ * totals are merged in a fixed binary tree. The grouping of the sums depends only on the particle
+ * count and the block size, never on the worker threads, so results are bit identical from run to
+ * run, in parallel or not. The block totals are kept between calls, charged to Subsystem::scratch.
+*/
+template <size_t Dim>
+class BasicDiagnostics
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using totals_type = BasicTotals<Dim>;
+
+private:
+    std::size_t block_size;
+    bool parallel;
+    tracked_vector<totals_type, Subsystem::scratch> blocks;
+
+    /**
+     * Totals of the last measure, guarded by last_mutex: a world runs its output on another thread.
+    */
+    totals_type last;
+    mutable std::mutex last_mutex;
+
+public:
+    /**
+     * @param block_size - particles summed in order by one task.
+    */
+    explicit BasicDiagnostics(std::size_t block_size = 2048);
+
+    /**
+     * Measures the particles. Not thread safe: one measure at a time.
+    */
+    totals_type measure(const std::vector<particle_type>& particles);
+
+    /**
+     * Measures the particles, fits BasicParticleWorld::Output; the totals are read with get_last.
+    */
+    void operator()(const std::vector<particle_type>& particles, size_t frame);
+
+    /**
+     * Gets a copy of the totals of the last measure; safe while a world's output measures in the
+     * background. Call BasicParticleWorld::finish first for the totals of the latest step.
+    */
+    totals_type get_last() const;
+
+    void set_block_size(std::size_t particles);
+
+    /**
+     * Turns splitting the blocks across the worker pool on or off; on by default. Either way gives
+     * the same bits.
+    */
+    void set_parallel(bool enabled);
+};
+
+using Totals = BasicTotals<3>;
+using Totals2D = BasicTotals<2>;
+using Diagnostics = BasicDiagnostics<3>;
+using Diagnostics2D = BasicDiagnostics<2>;
+
+// Implemented in diagnostics.cpp for these dimensions only.
+extern template struct BasicTotals<2>;
+extern template struct BasicTotals<3>;
+extern template class BasicDiagnostics<2>;
+extern template class BasicDiagnostics<3>;
+
+} // namespace fizx
@@ -0,0 +1,131 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "param.hpp"
+#include "vec.hpp"
+#include "mat.hpp"
+
+namespace fizx
+{
+
+/**
+ * Instruction set paths the hot kernels are compiled for.
+ * Paths are ordered, a CPU supporting a path supports every path before it.
+ * Every path is the same scalar source compiled again with the target attribute of its
+ * instruction set, so the vector code is whatever the compiler auto-vectorises; builds without
+ * optimisation, such as the default Debug build, get no vector code on any path.
+*/
+enum class CpuPath
+{
+    scalar,
+    sse42,
+    avx2,
+    avx512
+};
+
+/**
+ * Table of the hot kernels compiled for one path.
+ * Kernels work on tightly packed reals so any path can be swapped in for any other.
+*/
+struct Kernels
+{
+    /**
+     * Integrates particles stored back to back with the BasicParticle layout:
+     * position[dim], velocity[dim], acceleration[dim], damping, inverse_mass, net_force[dim].
+     * Same maths as BasicParticle::integrate, net forces are cleared.
+    */
+    void (*integrate_particles)(real* particles, std::size_t count, size_t dim, real duration);
+
+    /**
+     * Integrates count particles stored field by field across lanes: every particle is a block of
+     * 4 * dim + 2 rows of the BasicParticle fields, each row holding that field for stride lanes.
+     * Only the first lanes entries of every row are integrated; lanes is a multiple of 8. drag
+     * holds damping^duration for every particle and lane, with the same stride. Same maths as
+     * integrate_particles.
+    */
+    void (*integrate_lanes)(real* blocks, const real* drag, std::size_t count, std::size_t lanes,
+        std::size_t stride, size_t dim, real duration);
+
+    /**
+     * Scales count vectors of dim packed reals to unit length, leaving zero vectors unchanged.
+     * approximate uses inverse_sqrt_approx() instead of a square root and a division.
+    */
+    void (*normalize_vectors)(real* vectors, std::size_t count, size_t dim, bool approximate);
+
+    /**
+     * out[k] = a[k] * b[k] for count row major 3x3 matrices.
+    */
+    void (*multiply_mat3)(const real* a, const real* b, real* out, std::size_t count);
+
+    /**
+     * out[k] = matrix * in[k] for count 3D vectors and one row major 3x3 matrix.
+    */
+    void (*transform_vec3)(const real* matrix, const real* in, real* out, std::size_t count);
+};
+
+/**
+ * Gets the best path supported by both this build and the CPU.
+*/
+CpuPath detect_cpu_path();
+
+/**
+ * Gets the path used by kernels().
+ * Starts as detect_cpu_path(), unless the FIZX_CPU_PATH environment variable names another path
+ * (scalar, sse4.2, avx2 or avx512). Paths the CPU does not support, and names that are not paths,
+ * fall back to the detected path.
+*/
+CpuPath get_cpu_path();
+
+/**
+ * Changes the path used by kernels(), limited to what the CPU supports.
+ * @return the path actually selected.
+*/
+CpuPath set_cpu_path(CpuPath path);
+
+/**
+ * Parses a path name as accepted in FIZX_CPU_PATH.
+ * @throws std::invalid_argument for an unknown name.
+*/
+CpuPath parse_cpu_path(const char* name);
+
+const char* cpu_path_name(CpuPath path);
+
+/**
+ * Gets the kernels of a path, whether or not the CPU supports it.
+ * Only the scalar path is guaranteed to run everywhere.
+*/
+const Kernels& get_kernels(CpuPath path);
+
+/**
+ * Gets the kernels of the active path.
+*/
+const Kernels& kernels();
+
+/**
+ * Multiplies count pairs of matrices, out[k] = a[k] * b[k].
+*/
+void multiply(const mat3f* a, const mat3f* b, mat3f* out, std::size_t count);
+
+/**
+ * Transforms count vectors by one matrix, out[k] = matrix * in[k].
+*/
+void transform(const mat3f& matrix, const vec3f* in, vec3f* out, std::size_t count);
+
+/**
+ * Scales count vectors to unit length, leaving zero vectors unchanged.
+*/
+void normalize(vec3f* vectors, std::size_t count);
+void normalize(vec4f* vectors, std::size_t count);
+
+/**
+ * Scales count vectors to unit length with inverse_sqrt_approx(), leaving zero vectors unchanged.
+*/
+void fast_normalize(vec3f* vectors, std::size_t count);
+void fast_normalize(vec4f* vectors, std::size_t count);
+
+} // namespace fizx
@@ -0,0 +1,155 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "param.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+
+namespace fizx
+{
+
+/**
+ * Steps Dim dimensional particles split into domains, each stepped by its own worker process on
+ * this host. Space is cut into slabs along the first axis; the two outer slabs reach to infinity.
+ * Every step, a domain publishes the particles within ghost_width of each boundary to its
+ * neighbour, runs the force generators over its own particles followed by the ghosts of its
+ * neighbours, integrates its own particles and hands those that crossed a boundary to the domain
+ * on the other side. A particle moves at most one domain per step.
+ * All domain state lives in one POSIX shared memory region mapped before the workers are forked;
+ * steps are synchronised with process shared barriers. Force generators are copied into the workers
+ * when they are forked and run there on one thread; forces they add to ghosts are discarded.
+ * A worker that dies leaves the others waiting, so force generators must not crash. Linux only.
+*/
+template <size_t Dim>
+class BasicDomainDecomposition
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+    /**
+     * Adds forces to the particles of a domain, its own first and then the ghosts, given the step
+     * duration. Matches BasicParticleWorld::ForceGenerator.
+    */
+    using ForceGenerator = std::function<void(std::vector<particle_type>&, real)>;
+
+private:
+    struct Shared;
+    struct Slot;
+
+    size_t domains;
+    real lower;
+    real width;
+    real ghost_width;
+
+    /**
+     * Most particles a domain holds, and the size of every ghost and migration buffer.
+    */
+    std::size_t capacity;
+
+    std::vector<ForceGenerator> force_generators;
+
+    // The mapped region and its parts.
+    void* region;
+    std::size_t region_size;
+    Shared* shared;
+
+    std::vector<int> workers;
+
+    Slot* owned(size_t domain) const;
+
+    /**
+     * Buffer a domain fills for the neighbour on one side, 0 for the lower and 1 for the upper.
+    */
+    Slot* ghosts(size_t domain, int side) const;
+    Slot* outbox(size_t domain, int side) const;
+
+    /**
+     * Runs the steps of one domain until told to quit, in the worker process.
+    */
+    void work(size_t domain);
+    void step_domain(size_t domain, real duration, std::vector<particle_type>& local);
+
+    /**
+     * Releases the workers at the control barrier with a command and waits for them to finish it.
+    */
+    void command(int command);
+
+public:
+    /**
+     * @param domains - number of domains and worker processes.
+     * @param lower, upper - range of the first axis cut into domains of equal width; the first and
+     * last domain also take everything beyond it.
+     * @param ghost_width - distance from a boundary within which particles are shared, at least
+     * the interaction range of the force generators and at most the domain width (m).
+     * @param capacity - most particles a domain may hold.
+    */
+    BasicDomainDecomposition(size_t domains, real lower, real upper, real ghost_width, std::size_t capacity);
+
+    /**
+     * Stops the workers and unmaps the shared region.
+    */
+    ~BasicDomainDecomposition();
+
+    BasicDomainDecomposition(const BasicDomainDecomposition&) = delete;
+    BasicDomainDecomposition& operator=(const BasicDomainDecomposition&) = delete;
+
+    /**
+     * Adds a force generator, run in order of registration. Only allowed before start.
+    */
+    void add_force_generator(ForceGenerator generator);
+
+    /**
+     * Replaces all particles, each going to the domain holding its position. Particles keep their
+     * index as identity, gather returns them in the same order.
+     * @throws std::length_error if a domain would hold more than its capacity.
+    */
+    void load(const std::vector<particle_type>& particles);
+
+    /**
+     * Copies all particles back, in the order they were loaded.
+    */
+    void gather(std::vector<particle_type>& particles) const;
+
+    /**
+     * Forks one worker process per domain.
+    */
+    void start();
+
+    /**
+     * Runs steps of the given duration in every domain, waiting for them to finish.
+     * @throws std::runtime_error if the workers are not running, or if a domain overflowed its
+     * capacity or a force generator threw. Particles may have been lost then: load them again.
+     * @throws std::domain_error if steps is negative.
+    */
+    void step(real duration, size_t steps = 1);
+
+    /**
+     * Stops and reaps the worker processes. Particles stay readable and the workers can be started
+     * again.
+    */
+    void stop();
+
+    size_t domain_of(real x) const;
+    std::size_t domain_size(size_t domain) const;
+    size_t domain_count() const;
+    size_t size() const;
+    bool running() const;
+};
+
+using DomainDecomposition = BasicDomainDecomposition<3>;
+using DomainDecomposition2D = BasicDomainDecomposition<2>;
+
+// Implemented in domain.cpp for these dimensions only.
+extern template class BasicDomainDecomposition<2>;
+extern template class BasicDomainDecomposition<3>;
+
+} // namespace fizx
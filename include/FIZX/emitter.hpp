@@ -0,0 +1,136 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Spawns short lived particles in bulk into a pool reserved up front.
+ * Each particle gets a position, velocity, mass and lifetime drawn uniformly from the ranges set
+ * on the emitter. Expired particles are removed by one compaction pass per update, keeping the
+ * survivors in spawn order. Neither spawning nor killing allocates once the emitter is built. The
+ * pool is charged to Subsystem::particles.
+*/
+template <size_t Dim>
+class BasicEmitter
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+private:
+    tracked_vector<particle_type, Subsystem::particles> particles;
+
+    /**
+     * Time left to live of each particle (s), parallel to particles.
+    */
+    tracked_vector<real, Subsystem::particles> lifetimes;
+
+    // Particles are spawned within centre +- spread on each axis.
+    vec_type position_centre;
+    vec_type position_spread;
+    vec_type velocity_centre;
+    vec_type velocity_spread;
+    vec_type acceleration;
+    real mass_min;
+    real mass_max;
+    real lifetime_min;
+    real lifetime_max;
+    real damping;
+
+    std::uint64_t random_state;
+
+    real uniform(real min, real max);
+
+public:
+    /**
+     * @param capacity - most particles alive at once.
+     * @param seed - seed of the random draws, the same seed spawns the same particles.
+    */
+    explicit BasicEmitter(std::size_t capacity, std::uint64_t seed = 1);
+
+    /**
+     * Sets the range of spawn positions, centre +- spread on each axis.
+    */
+    void set_position(const vec_type& centre, const vec_type& spread = vec_type());
+
+    /**
+     * Sets the range of spawn velocities, centre +- spread on each axis.
+    */
+    void set_velocity(const vec_type& centre, const vec_type& spread = vec_type());
+
+    /**
+     * Sets the range of masses (kg), both must be positive.
+    */
+    void set_mass(real min, real max);
+
+    /**
+     * Sets the range of lifetimes (s), both must be positive.
+    */
+    void set_lifetime(real min, real max);
+
+    /**
+     * Sets the constant acceleration and damping given to spawned particles.
+    */
+    void set_acceleration(const vec_type& acceleration);
+    void set_damping(real damping);
+
+    /**
+     * Spawns particles at the end of the pool.
+     * @return the number spawned, less than count if the pool is full.
+    */
+    std::size_t emit(std::size_t count);
+
+    /**
+     * Integrates the particles, ages them and removes the expired ones.
+     * @return the number of particles removed.
+    */
+    std::size_t update(real duration);
+
+    /**
+     * Ages the particles without moving them and removes the expired ones.
+     * @return the number of particles removed.
+    */
+    std::size_t age(real duration);
+
+    /**
+     * Removes every particle.
+    */
+    void clear();
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+    particle_type* data();
+    const particle_type* data() const;
+
+    particle_type& operator[](std::size_t index);
+    const particle_type& operator[](std::size_t index) const;
+
+    /**
+     * Time left to live of a particle (s).
+    */
+    real get_lifetime(std::size_t index) const;
+};
+
+using Emitter = BasicEmitter<3>;
+using Emitter2D = BasicEmitter<2>;
+
+// Implemented in emitter.cpp for these dimensions only.
+extern template class BasicEmitter<2>;
+extern template class BasicEmitter<3>;
+
+} // namespace fizx
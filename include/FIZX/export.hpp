@@ -0,0 +1,120 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Streams particle arrays to a text stream as CSV, one row per particle: frame, index, then the
+ * selected columns, vector columns as one value per component.
+ * Reals are written with std::to_chars in their shortest form that reads back exactly. Rows are
+ * formatted into buffers kept between frames, so a frame allocates nothing once the buffers have
+ * grown. Large frames can be formatted in chunks on the worker pool, then written in order.
+ * Calling the exporter with a frame matches BasicParticleWorld::Output, so it can be the output of
+ * a world. The buffers are charged to Subsystem::scratch; the list of buffers and of columns is
+ * not.
+*/
+template <size_t Dim>
+class BasicCsvExporter
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+
+    enum class Column
+    {
+        position,
+        velocity,
+        acceleration,
+        net_force,
+        inverse_mass
+    };
+
+    using buffer_type = std::basic_string<char, std::char_traits<char>, TrackedAllocator<char, Subsystem::scratch>>;
+
+private:
+    std::ostream& out;
+    std::vector<Column> columns;
+    char separator;
+
+    bool parallel;
+    std::size_t chunk_size;
+
+    /**
+     * One formatting buffer per chunk, reused from frame to frame.
+    */
+    std::vector<buffer_type> buffers;
+
+    std::size_t bytes_written;
+
+    /**
+     * Pieces the last frame was formatted in, each run by one task.
+    */
+    std::size_t task_count;
+
+    void format(const particle_type* particles, std::size_t first, std::size_t count, size_t frame, buffer_type& buffer) const;
+
+public:
+    /**
+     * @param out - stream rows are written to, must outlive the exporter.
+     * @param columns - columns after the frame and index, in order.
+     * @param separator - between values.
+    */
+    explicit BasicCsvExporter(std::ostream& out,
+        std::initializer_list<Column> columns = {Column::position, Column::velocity}, char separator = ',');
+
+    /**
+     * Writes the names of the columns.
+    */
+    void write_header();
+
+    /**
+     * Writes one row per particle.
+    */
+    void write(const std::vector<particle_type>& particles, size_t frame);
+
+    void operator()(const std::vector<particle_type>& particles, size_t frame);
+
+    /**
+     * Formats chunks of a frame on the worker pool before writing them in order. Off by default.
+    */
+    void set_parallel(bool enabled);
+
+    /**
+     * Sets the particles per chunk, the unit of parallel formatting and of writes to the stream.
+    */
+    void set_chunk_size(std::size_t particles);
+
+    /**
+     * Number of characters written so far.
+    */
+    std::size_t get_bytes_written() const;
+
+    /**
+     * Number of tasks that formatted the last frame, 1 unless it was split across the worker pool.
+    */
+    std::size_t get_task_count() const;
+};
+
+using CsvExporter = BasicCsvExporter<3>;
+using CsvExporter2D = BasicCsvExporter<2>;
+
+// Implemented in export.cpp for these dimensions only.
+extern template class BasicCsvExporter<2>;
+extern template class BasicCsvExporter<3>;
+
+} // namespace fizx
@@ -0,0 +1,151 @@
+/**
+ * C interface of the engine, built as the fizx shared library.
+ * Every function is callable from C and from any language with a C foreign function interface.
+ * Particle state moves in whole columns through caller owned buffers, so a frame costs a handful
+ * of calls however many particles there are. No C++ exception crosses this interface: failures
+ * return a status and fizx_last_error() describes them.
+*/
+
+#ifndef FIZX_FIZX_H
+#define FIZX_FIZX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #ifdef FIZX_BUILDING_C_API
+        #define FIZX_API __declspec(dllexport)
+    #else
+        #define FIZX_API __declspec(dllimport)
+    #endif
+#elif defined(__GNUC__) || defined(__clang__)
+    #define FIZX_API __attribute__((visibility("default")))
+#else
+    #define FIZX_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Version of this interface. Functions are only ever added; a change to an existing function
+ * bumps the version.
+*/
+#define FIZX_API_VERSION 1
+
+/**
+ * Real numbers of the engine.
+*/
+typedef double fizx_real;
+
+/**
+ * A world of particles, opaque.
+*/
+typedef struct fizx_world fizx_world;
+
+typedef enum fizx_status
+{
+    FIZX_OK = 0,
+    FIZX_ERROR_INVALID_ARGUMENT = 1,
+    FIZX_ERROR_OUT_OF_RANGE = 2,
+    FIZX_ERROR_OUT_OF_MEMORY = 3,
+    FIZX_ERROR_INTERNAL = 4
+} fizx_status;
+
+/**
+ * Columns of particle state. Vector columns hold dimension reals per particle, scalar columns one.
+*/
+typedef enum fizx_field
+{
+    FIZX_FIELD_POSITION = 0,
+    FIZX_FIELD_VELOCITY = 1,
+    FIZX_FIELD_ACCELERATION = 2,
+    FIZX_FIELD_DAMPING = 3,
+    FIZX_FIELD_INVERSE_MASS = 4,
+    FIZX_FIELD_NET_FORCE = 5
+} fizx_field;
+
+/**
+ * Gets the version the library was built with, FIZX_API_VERSION of its header.
+*/
+FIZX_API uint32_t fizx_api_version(void);
+
+/**
+ * Gets the message of the last failure on the calling thread, or an empty string.
+*/
+FIZX_API const char* fizx_last_error(void);
+
+/**
+ * Creates an empty world.
+ * @param dimension - 2 or 3.
+ * @param world - receives the world, to release with fizx_world_destroy().
+*/
+FIZX_API fizx_status fizx_world_create(int dimension, fizx_world** world);
+
+/**
+ * Destroys a world, waiting for its step in flight. Null is ignored.
+*/
+FIZX_API void fizx_world_destroy(fizx_world* world);
+
+FIZX_API int fizx_world_dimension(const fizx_world* world);
+
+/**
+ * Number of particles.
+*/
+FIZX_API size_t fizx_world_size(const fizx_world* world);
+
+/**
+ * Changes the number of particles. New particles are at rest at the origin, with unit mass and
+ * no damping. Invalidates pointers from fizx_world_data().
+*/
+FIZX_API fizx_status fizx_world_resize(fizx_world* world, size_t count);
+
+/**
+ * Runs one step of the simulation.
+ * @param duration - positive length of the step (s).
+*/
+FIZX_API fizx_status fizx_world_step(fizx_world* world, fizx_real duration);
+
+/**
+ * Number of steps run so far.
+*/
+FIZX_API uint64_t fizx_world_frame(const fizx_world* world);
+
+/**
+ * Number of reals per particle of a field, dimension for vectors and 1 for scalars.
+*/
+FIZX_API size_t fizx_field_components(const fizx_world* world, fizx_field field);
+
+/**
+ * Copies a field of particles [first, first + count) into a caller buffer, packed particle after
+ * particle: count * fizx_field_components() reals.
+*/
+FIZX_API fizx_status fizx_world_read(const fizx_world* world, fizx_field field, size_t first, size_t count,
+    fizx_real* out);
+
+/**
+ * Sets a field of particles [first, first + count) from a caller buffer packed as fizx_world_read() writes.
+ * Writing FIZX_FIELD_INVERSE_MASS with 0 gives particles an infinite mass.
+*/
+FIZX_API fizx_status fizx_world_write(fizx_world* world, fizx_field field, size_t first, size_t count,
+    const fizx_real* in);
+
+/**
+ * Gets the particle storage itself, for callers whose layout matches it: particle i starts at
+ * data + i * stride, and a field starts fizx_field_offset() reals into the particle.
+ * Valid until the world is resized or destroyed; do not touch it during fizx_world_step().
+ * @param stride - receives the reals per particle.
+*/
+FIZX_API fizx_real* fizx_world_data(fizx_world* world, size_t* stride);
+
+/**
+ * Offset of a field in a particle of fizx_world_data(), in reals.
+*/
+FIZX_API size_t fizx_field_offset(const fizx_world* world, fizx_field field);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FIZX_FIZX_H
@@ -0,0 +1,190 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * A node of the Barnes-Hut octree.
+ * Nodes are stored depth first in one flat pool: the first child of an internal node is the node
+ * directly after it, and next is the index of the first node past its subtree. A leaf therefore
+ * always has next == index + 1.
+*/
+struct OctreeNode
+{
+    /**
+     * Centre of mass of every body under this node.
+    */
+    vec3f centre_of_mass;
+
+    /**
+     * Total mass of every body under this node.
+    */
+    real mass;
+
+    /**
+     * Edge length of the cube covered by this node.
+    */
+    real size;
+
+    /**
+     * Index of the node following this subtree.
+    */
+    size_t next;
+
+    /**
+     * Range of the bodies under this node, in octree (Morton) order.
+    */
+    size_t body_begin;
+    size_t body_end;
+};
+
+/**
+ * An octree over point masses, rebuilt from scratch every step.
+ * Bodies are sorted along a Morton curve and the eight subtrees below the root are built in
+ * parallel before being spliced into a single node pool. Everything it holds is charged to
+ * Subsystem::broadphase.
+*/
+class Octree
+{
+public:
+    using node_list = tracked_vector<OctreeNode, Subsystem::broadphase>;
+    using key_list = tracked_vector<std::pair<std::uint64_t, size_t>, Subsystem::broadphase>;
+
+private:
+    /**
+     * Flat pool of nodes, the root is at index 0.
+    */
+    node_list nodes;
+
+    /**
+     * Positions of the bodies in Morton order.
+    */
+    tracked_vector<vec3f, Subsystem::broadphase> body_positions;
+
+    /**
+     * Masses of the bodies in Morton order.
+    */
+    tracked_vector<real, Subsystem::broadphase> body_masses;
+
+    /**
+     * Morton key and source index of every body, in Morton order.
+    */
+    key_list keys;
+
+    /**
+     * Maximum number of bodies stored in a leaf.
+    */
+    size_t leaf_capacity;
+
+    void build_subtree(node_list& pool, size_t begin, size_t end, int level, real size);
+
+public:
+    Octree(size_t leaf_capacity = 8);
+
+    /**
+     * Rebuilds the tree over the given point masses.
+     * Bodies with a non positive mass are left out of the tree.
+     * @param positions - position of every body.
+     * @param masses - mass of every body.
+    */
+    void build(const std::vector<vec3f>& positions, const std::vector<real>& masses);
+
+    /**
+     * Rebuilds the tree over count point masses stored in arrays.
+    */
+    void build(const vec3f* positions, const real* masses, size_t count);
+
+    /**
+     * Computes the gravitational field (acceleration per unit of G) at a point.
+     * Nodes whose size over distance is below theta are treated as a single mass.
+     * @param point - where to sample the field.
+     * @param theta - opening angle, 0 gives the exact all-pairs sum.
+     * @param softening - length added to every distance to avoid singularities.
+     * @param skip - Morton order position of a body to leave out, use -1 to skip nothing.
+    */
+    vec3f field(const vec3f& point, real theta, real softening, size_t skip = -1) const;
+
+    const node_list& get_nodes() const;
+
+    /**
+     * Number of bodies held by the tree.
+    */
+    size_t size() const;
+
+    /**
+     * Gets the source index of the body at a position in Morton order.
+    */
+    size_t body_index(size_t order) const;
+};
+
+/**
+ * A built in n-body gravity force, where every particle attracts every other particle.
+ * Uses a Barnes-Hut octree, so one application costs O(n log n) instead of O(n^2).
+ * Only available for 3D particles, as the tree is an octree.
+*/
+class NBodyGravity
+{
+private:
+    /**
+     * Holds the gravitational constant.
+    */
+    real gravitational_constant;
+
+    /**
+     * Holds the opening angle, larger values trade accuracy for speed.
+    */
+    real theta;
+
+    /**
+     * Holds the softening length.
+    */
+    real softening;
+
+    Octree tree;
+
+    // Scratch arrays reused between steps.
+    tracked_vector<vec3f, Subsystem::scratch> positions;
+    tracked_vector<real, Subsystem::scratch> masses;
+
+public:
+    NBodyGravity(real gravitational_constant = 6.674'30e-11, real theta = 0.5, real softening = 0.0);
+
+    /**
+     * Setter for the opening angle.
+     * @param theta Non negative ratio of node size over distance below which a node is approximated.
+    */
+    void set_theta(real theta);
+
+    real get_theta() const;
+
+    /**
+     * Setter for the softening length.
+     * @param softening Non negative length (m).
+    */
+    void set_softening(real softening);
+
+    /**
+     * Adds the gravitational pull of every particle to every other particle.
+     * Particles with infinite mass neither attract nor get attracted.
+     * @param particles - particles to update with add_force.
+    */
+    void apply(std::vector<Particle>& particles);
+
+    const Octree& get_tree() const;
+};
+
+} // namespace fizx
@@ -0,0 +1,149 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "param.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * A rewind buffer of particle positions and velocities, for replays, rollback and debugging.
+ * Every keyframe_interval steps a full keyframe is stored; the steps in between only store the
+ * difference with the step before. Differences are either the XOR of the bit patterns with zero
+ * bytes stripped (lossless, the default) or deltas quantized to a fixed step and varint encoded.
+ * Keyframes are always lossless. When the memory budget is exceeded the oldest keyframe and its
+ * deltas are dropped.
+*/
+template <size_t Dim>
+class BasicHistory
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using real_list = tracked_vector<real, Subsystem::history>;
+    using vec_type = Vector<real, Dim>;
+
+private:
+    /**
+     * A keyframe and the deltas following it.
+    */
+    struct Segment
+    {
+        /**
+         * Step of the keyframe.
+        */
+        size_t first_step;
+
+        /**
+         * Number of particles in every frame of the segment.
+        */
+        size_t count;
+
+        /**
+         * Step number and start in data of every frame, the keyframe first.
+        */
+        tracked_vector<size_t, Subsystem::history> steps;
+        tracked_vector<size_t, Subsystem::history> offsets;
+
+        tracked_vector<std::uint8_t, Subsystem::history> data;
+    };
+
+    tracked_deque<Segment, Subsystem::history> segments;
+
+    /**
+     * Holds how many steps a segment covers, keyframe included.
+    */
+    size_t keyframe_interval;
+
+    /**
+     * Holds the memory budget in bytes.
+    */
+    std::size_t budget;
+
+    /**
+     * Holds the quantization step of the deltas, zero for lossless XOR deltas.
+    */
+    real quantum;
+
+    /**
+     * State of the last recorded step as it will be decoded, the reference of the next delta.
+    */
+    real_list previous;
+
+    // Scratch state, reused between calls.
+    real_list current;
+
+    void gather(const std::vector<particle_type>& particles, real_list& values) const;
+    void scatter(const real_list& values, std::vector<particle_type>& particles) const;
+    void decode(const Segment& segment, size_t frame, real_list& values) const;
+    const Segment& find(size_t step, size_t& frame) const;
+    void enforce_budget();
+
+public:
+    /**
+     * @param keyframe_interval - steps per keyframe, at least 1.
+     * @param budget - memory budget in bytes, the newest segment is always kept.
+     * @param quantum - quantization step of the deltas, 0 keeps the history lossless.
+    */
+    BasicHistory(size_t keyframe_interval = 32, std::size_t budget = 64 << 20, real quantum = 0);
+
+    /**
+     * Stores the positions and velocities of the particles.
+     * A new keyframe is started when the interval is reached or the particle count changed.
+     * @param step - step number, must be greater than the last recorded step.
+    */
+    void record(size_t step, const std::vector<particle_type>& particles);
+
+    /**
+     * Restores the positions and velocities of a stored step.
+     * @param step - step to restore.
+     * @param particles - particles to update, must be as many as when the step was recorded.
+    */
+    void load(size_t step, std::vector<particle_type>& particles) const;
+
+    /**
+     * Restores a stored step and drops every later step, so recording can resume from it.
+    */
+    void rewind(size_t step, std::vector<particle_type>& particles);
+
+    /**
+     * Drops every stored step.
+    */
+    void clear();
+
+    /**
+     * Checks if a step can be restored.
+    */
+    bool contains(size_t step) const;
+
+    size_t oldest_step() const;
+    size_t newest_step() const;
+
+    /**
+     * Number of stored steps.
+    */
+    size_t size() const;
+
+    /**
+     * Bytes held by the stored steps.
+    */
+    std::size_t bytes() const;
+};
+
+using History = BasicHistory<3>;
+using History2D = BasicHistory<2>;
+
+// Implemented in history.cpp for these dimensions only.
+extern template class BasicHistory<2>;
+extern template class BasicHistory<3>;
+
+} // namespace fizx
@@ -6,6 +6,7 @@
 
 #include "param.hpp"
 #include "vec.hpp"
+#include <iostream>
 #include <string>
 
 namespace fizx {
@@ -200,7 +201,7 @@ public:
      * O(MRows*NCols*L_ELEMS) runtime.
      * @return An MRows by L_ELEMS Matrix.
     */
-    template<typename T, size_t LElems>
+    template<size_t LElems>
     Matrix<T, MRows, LElems> operator*(const Matrix<T, NCols, LElems>& other) const
     {
         Matrix<T, MRows, LElems> temp;
@@ -223,9 +224,9 @@ public:
     /**
      * Multiply a matrix with a vector with dimensions NCols
     */
-    ROW_VEC operator*(const COL_VEC& vector) const
+    COL_VEC operator*(const ROW_VEC& vector) const
     {
-        ROW_VEC temp;
+        COL_VEC temp;
         for (size_t m = 0; m < MRows; ++m)
         {
             temp[m] = values[m] * vector;
@@ -238,14 +239,16 @@ public:
 
     std::string to_string() const
     {
-        std::string s = "";
+        std::string s;
+        s.reserve(MRows * (NCols * (REAL_CHARS + 1) + 1));
         for (size_t m = 0; m < MRows; ++m)
         {
             for (size_t n = 0; n < NCols; ++n)
             {
-                s += " " + std::to_string(values[m][n]);
+                s += ' ';
+                append_real(s, values[m][n]);
             }
-            s += "\n";
+            s += '\n';
         }
         return s;
     }
@@ -254,25 +257,25 @@ public:
      * Gets a row of the matrix (0 indexed)
      * @param index - the index of the row.
     */
-    ROW_VEC get_row(size_t index)
+    ROW_VEC get_row(size_t index) const
     {
-        if (index < MRows)
+        if (index >= MRows)
             throw std::runtime_error("Index Out Of Bounds");
-        return values[index]
+        return values[index];
     }
 
     /**
      * Gets a column of the matrix (0 indexed)
      * @param index - the index of the column.
     */
-    COL_VEC get_col(size_t index)
+    COL_VEC get_col(size_t index) const
     {
-        if (index < NCols)
+        if (index >= NCols)
             throw std::runtime_error("Index Out Of Bounds");
         COL_VEC temp;
         for (size_t m = 0; m < MRows; ++m)
         {
-            temp[m] = values[m][index]
+            temp[m] = values[m][index];
         }
         return temp;
     }
@@ -0,0 +1,452 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "param.hpp"
+#include "vec.hpp"
+#include "mat.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Many small matrices of the same shape, stored element by element: element (m, n) of matrices
+ * 0, 1, 2, ... is one contiguous row, so a SIMD lane is a matrix and the batched operations below
+ * run a single loop over the rows for every element. Rows are padded up to a multiple of
+ * LANE_ALIGNMENT; padding lanes hold zeros and are never read back. The values are charged to
+ * Subsystem::other.
+*/
+template <typename T, size_t MRows, size_t NCols>
+class MatrixBatch
+{
+public:
+    using matrix_type = Matrix<T, MRows, NCols>;
+    using column_type = Vector<T, MRows>;
+
+    static constexpr std::size_t ELEMENTS = MRows * NCols;
+    static constexpr std::size_t LANE_ALIGNMENT = 8;
+
+private:
+    std::size_t count;
+
+    /**
+     * Values per row, count rounded up to LANE_ALIGNMENT.
+    */
+    std::size_t stride;
+
+    tracked_vector<T, Subsystem::other> values;
+
+    void check(std::size_t index) const
+    {
+        if (index >= count) throw std::runtime_error("Index Out of Bounds");
+    }
+
+    static const T* elements(const matrix_type& matrix)
+    {
+        static_assert(sizeof(matrix_type) == ELEMENTS * sizeof(T), "Matrix must be packed values");
+        return reinterpret_cast<const T*>(&matrix);
+    }
+
+    static T* elements(matrix_type& matrix)
+    {
+        return reinterpret_cast<T*>(&matrix);
+    }
+
+public:
+    /**
+     * @param matrices - number of matrices, all zero.
+    */
+    explicit MatrixBatch(std::size_t matrices = 0) : count(0), stride(0)
+    {
+        resize(matrices);
+    }
+
+    /**
+     * Changes the number of matrices, keeping the first ones; new matrices are zero.
+    */
+    void resize(std::size_t matrices)
+    {
+        const std::size_t padded = (matrices + LANE_ALIGNMENT - 1) / LANE_ALIGNMENT * LANE_ALIGNMENT;
+        if (padded != stride)
+        {
+            tracked_vector<T, Subsystem::other> moved(ELEMENTS * padded, T(0));
+            const std::size_t kept = matrices < count ? matrices : count;
+            for (std::size_t e = 0; e < ELEMENTS; ++e)
+            {
+                std::copy_n(values.data() + e * stride, kept, moved.data() + e * padded);
+            }
+            values.swap(moved);
+            stride = padded;
+        }
+        else
+        {
+            // Zero the lanes that drop out, so they read as zero when they come back.
+            for (std::size_t e = 0; matrices < count && e < ELEMENTS; ++e)
+            {
+                std::fill(values.data() + e * stride + matrices, values.data() + e * stride + count, T(0));
+            }
+        }
+        count = matrices;
+    }
+
+    void set(std::size_t index, const matrix_type& matrix)
+    {
+        check(index);
+        const T* source = elements(matrix);
+        for (std::size_t e = 0; e < ELEMENTS; ++e)
+        {
+            values[e * stride + index] = source[e];
+        }
+    }
+
+    matrix_type get(std::size_t index) const
+    {
+        check(index);
+        matrix_type matrix;
+        T* target = elements(matrix);
+        for (std::size_t e = 0; e < ELEMENTS; ++e)
+        {
+            target[e] = values[e * stride + index];
+        }
+        return matrix;
+    }
+
+    /**
+     * Sets a column vector, for batches of one column.
+    */
+    void set(std::size_t index, const column_type& vector)
+    {
+        static_assert(NCols == 1, "Only batches of column vectors hold vectors");
+        check(index);
+        for (size_t m = 0; m < MRows; ++m)
+        {
+            values[m * stride + index] = vector[m];
+        }
+    }
+
+    column_type get_vector(std::size_t index) const
+    {
+        static_assert(NCols == 1, "Only batches of column vectors hold vectors");
+        check(index);
+        column_type vector;
+        for (size_t m = 0; m < MRows; ++m)
+        {
+            vector[m] = values[m * stride + index];
+        }
+        return vector;
+    }
+
+    /**
+     * Replaces all matrices with copies of the given ones, in order.
+    */
+    void load(const std::vector<matrix_type>& matrices)
+    {
+        resize(matrices.size());
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const T* source = elements(matrices[k]);
+            for (std::size_t e = 0; e < ELEMENTS; ++e)
+            {
+                values[e * stride + k] = source[e];
+            }
+        }
+    }
+
+    /**
+     * Copies all matrices out, in order.
+    */
+    void store(std::vector<matrix_type>& matrices) const
+    {
+        matrices.resize(count);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            T* target = elements(matrices[k]);
+            for (std::size_t e = 0; e < ELEMENTS; ++e)
+            {
+                target[e] = values[e * stride + k];
+            }
+        }
+    }
+
+    /**
+     * Gets the row of element (m, n), holding it for every matrix.
+    */
+    T* row(size_t m, size_t n)
+    {
+        if (m >= MRows || n >= NCols) throw std::runtime_error("Index Out of Bounds");
+        return values.data() + (m * NCols + n) * stride;
+    }
+
+    const T* row(size_t m, size_t n) const
+    {
+        if (m >= MRows || n >= NCols) throw std::runtime_error("Index Out of Bounds");
+        return values.data() + (m * NCols + n) * stride;
+    }
+
+    /**
+     * Adds the matrices of another batch of the same size, element wise.
+    */
+    void operator+=(const MatrixBatch& other)
+    {
+        if (other.count != count) throw std::invalid_argument("Batches differ in size");
+        for (std::size_t e = 0; e < ELEMENTS; ++e)
+        {
+            T* target = values.data() + e * stride;
+            const T* source = other.values.data() + e * other.stride;
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                target[k] += source[k];
+            }
+        }
+    }
+
+    /**
+     * Scales every matrix by a constant.
+    */
+    void operator*=(T scalar)
+    {
+        for (std::size_t e = 0; e < ELEMENTS; ++e)
+        {
+            T* target = values.data() + e * stride;
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                target[k] *= scalar;
+            }
+        }
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * Number of values in a row, at least size.
+    */
+    std::size_t get_stride() const
+    {
+        return stride;
+    }
+};
+
+template <typename T, size_t NElems>
+using VectorBatch = MatrixBatch<T, NElems, 1>;
+
+using mat2fBatch = MatrixBatch<real, 2, 2>;
+using mat3fBatch = MatrixBatch<real, 3, 3>;
+using mat4fBatch = MatrixBatch<real, 4, 4>;
+
+using vec2fBatch = VectorBatch<real, 2>;
+using vec3fBatch = VectorBatch<real, 3>;
+using vec4fBatch = VectorBatch<real, 4>;
+
+// BATCHED OPERATIONS //--------------------------------------------------------------------------
+// Each resizes out to the size of its operands and throws std::invalid_argument when the operands
+// differ in size.
+
+/**
+ * out = a + b for every matrix; out may be a or b.
+*/
+template <typename T, size_t MRows, size_t NCols>
+void add(const MatrixBatch<T, MRows, NCols>& a, const MatrixBatch<T, MRows, NCols>& b,
+    MatrixBatch<T, MRows, NCols>& out)
+{
+    if (a.size() != b.size()) throw std::invalid_argument("Batches differ in size");
+    out.resize(a.size());
+    const std::size_t lanes = a.size();
+    for (size_t m = 0; m < MRows; ++m)
+    {
+        for (size_t n = 0; n < NCols; ++n)
+        {
+            const T* x = a.row(m, n);
+            const T* y = b.row(m, n);
+            T* z = out.row(m, n);
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                z[k] = x[k] + y[k];
+            }
+        }
+    }
+}
+
+/**
+ * out = a * scalar for every matrix; out may be a.
+*/
+template <typename T, size_t MRows, size_t NCols>
+void scale(const MatrixBatch<T, MRows, NCols>& a, T scalar, MatrixBatch<T, MRows, NCols>& out)
+{
+    out.resize(a.size());
+    const std::size_t lanes = a.size();
+    for (size_t m = 0; m < MRows; ++m)
+    {
+        for (size_t n = 0; n < NCols; ++n)
+        {
+            const T* x = a.row(m, n);
+            T* z = out.row(m, n);
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                z[k] = x[k] * scalar;
+            }
+        }
+    }
+}
+
+/**
+ * out = a * b for every matrix, the matrix product; with a VectorBatch for b this multiplies every
+ * matrix with its vector. out may not be a or b.
+*/
+template <typename T, size_t MRows, size_t NCols, size_t LElems>
+void multiply(const MatrixBatch<T, MRows, NCols>& a, const MatrixBatch<T, NCols, LElems>& b,
+    MatrixBatch<T, MRows, LElems>& out)
+{
+    if (a.size() != b.size()) throw std::invalid_argument("Batches differ in size");
+    if (static_cast<const void*>(&out) == &a || static_cast<const void*>(&out) == &b)
+        throw std::invalid_argument("Product written over an operand");
+    out.resize(a.size());
+    const std::size_t lanes = a.size();
+    for (size_t m = 0; m < MRows; ++m)
+    {
+        for (size_t l = 0; l < LElems; ++l)
+        {
+            T* z = out.row(m, l);
+            const T* x = a.row(m, 0);
+            const T* y = b.row(0, l);
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                z[k] = x[k] * y[k];
+            }
+            for (size_t n = 1; n < NCols; ++n)
+            {
+                x = a.row(m, n);
+                y = b.row(n, l);
+                for (std::size_t k = 0; k < lanes; ++k)
+                {
+                    z[k] += x[k] * y[k];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * out = the transpose of a for every matrix; out may not be a.
+*/
+template <typename T, size_t MRows, size_t NCols>
+void transpose(const MatrixBatch<T, MRows, NCols>& a, MatrixBatch<T, NCols, MRows>& out)
+{
+    if (static_cast<const void*>(&out) == &a) throw std::invalid_argument("Transpose written over its operand");
+    out.resize(a.size());
+    for (size_t m = 0; m < MRows; ++m)
+    {
+        for (size_t n = 0; n < NCols; ++n)
+        {
+            std::copy_n(a.row(m, n), a.size(), out.row(n, m));
+        }
+    }
+}
+
+/**
+ * out = the inverse of a for every matrix, by cofactors. Square matrices of 2, 3 or 4 rows only.
+ * out may not be a.
+ * @throws std::domain_error if any matrix is singular; out then holds infinities or NaNs for it.
+*/
+template <typename T, size_t NElems>
+void inverse(const MatrixBatch<T, NElems, NElems>& a, MatrixBatch<T, NElems, NElems>& out)
+{
+    static_assert(NElems >= 2 && NElems <= 4, "Inverse of 2, 3 or 4 rows only");
+    if (&out == &a) throw std::invalid_argument("Inverse written over its operand");
+    out.resize(a.size());
+    const std::size_t lanes = a.size();
+    const T* e[NElems * NElems];
+    T* r[NElems * NElems];
+    for (size_t i = 0; i < NElems * NElems; ++i)
+    {
+        e[i] = a.row(i / NElems, i % NElems);
+        r[i] = out.row(i / NElems, i % NElems);
+    }
+
+    bool singular = false;
+    if constexpr (NElems == 2)
+    {
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            const T det = e[0][k] * e[3][k] - e[1][k] * e[2][k];
+            singular |= det == 0;
+            const T s = T(1) / det;
+            r[0][k] = e[3][k] * s;
+            r[1][k] = -e[1][k] * s;
+            r[2][k] = -e[2][k] * s;
+            r[3][k] = e[0][k] * s;
+        }
+    }
+    else if constexpr (NElems == 3)
+    {
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            const T c0 = e[4][k] * e[8][k] - e[5][k] * e[7][k];
+            const T c1 = e[5][k] * e[6][k] - e[3][k] * e[8][k];
+            const T c2 = e[3][k] * e[7][k] - e[4][k] * e[6][k];
+            const T det = e[0][k] * c0 + e[1][k] * c1 + e[2][k] * c2;
+            singular |= det == 0;
+            const T s = T(1) / det;
+            r[0][k] = c0 * s;
+            r[1][k] = (e[2][k] * e[7][k] - e[1][k] * e[8][k]) * s;
+            r[2][k] = (e[1][k] * e[5][k] - e[2][k] * e[4][k]) * s;
+            r[3][k] = c1 * s;
+            r[4][k] = (e[0][k] * e[8][k] - e[2][k] * e[6][k]) * s;
+            r[5][k] = (e[2][k] * e[3][k] - e[0][k] * e[5][k]) * s;
+            r[6][k] = c2 * s;
+            r[7][k] = (e[1][k] * e[6][k] - e[0][k] * e[7][k]) * s;
+            r[8][k] = (e[0][k] * e[4][k] - e[1][k] * e[3][k]) * s;
+        }
+    }
+    else
+    {
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            // 2x2 determinants of the top two rows and of the bottom two rows.
+            const T s0 = e[0][k] * e[5][k] - e[4][k] * e[1][k];
+            const T s1 = e[0][k] * e[6][k] - e[4][k] * e[2][k];
+            const T s2 = e[0][k] * e[7][k] - e[4][k] * e[3][k];
+            const T s3 = e[1][k] * e[6][k] - e[5][k] * e[2][k];
+            const T s4 = e[1][k] * e[7][k] - e[5][k] * e[3][k];
+            const T s5 = e[2][k] * e[7][k] - e[6][k] * e[3][k];
+            const T c5 = e[10][k] * e[15][k] - e[14][k] * e[11][k];
+            const T c4 = e[9][k] * e[15][k] - e[13][k] * e[11][k];
+            const T c3 = e[9][k] * e[14][k] - e[13][k] * e[10][k];
+            const T c2 = e[8][k] * e[15][k] - e[12][k] * e[11][k];
+            const T c1 = e[8][k] * e[14][k] - e[12][k] * e[10][k];
+            const T c0 = e[8][k] * e[13][k] - e[12][k] * e[9][k];
+            const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            singular |= det == 0;
+            const T s = T(1) / det;
+            r[0][k] = (e[5][k] * c5 - e[6][k] * c4 + e[7][k] * c3) * s;
+            r[1][k] = (-e[1][k] * c5 + e[2][k] * c4 - e[3][k] * c3) * s;
+            r[2][k] = (e[13][k] * s5 - e[14][k] * s4 + e[15][k] * s3) * s;
+            r[3][k] = (-e[9][k] * s5 + e[10][k] * s4 - e[11][k] * s3) * s;
+            r[4][k] = (-e[4][k] * c5 + e[6][k] * c2 - e[7][k] * c1) * s;
+            r[5][k] = (e[0][k] * c5 - e[2][k] * c2 + e[3][k] * c1) * s;
+            r[6][k] = (-e[12][k] * s5 + e[14][k] * s2 - e[15][k] * s1) * s;
+            r[7][k] = (e[8][k] * s5 - e[10][k] * s2 + e[11][k] * s1) * s;
+            r[8][k] = (e[4][k] * c4 - e[5][k] * c2 + e[7][k] * c0) * s;
+            r[9][k] = (-e[0][k] * c4 + e[1][k] * c2 - e[3][k] * c0) * s;
+            r[10][k] = (e[12][k] * s4 - e[13][k] * s2 + e[15][k] * s0) * s;
+            r[11][k] = (-e[8][k] * s4 + e[9][k] * s2 - e[11][k] * s0) * s;
+            r[12][k] = (-e[4][k] * c3 + e[5][k] * c1 - e[6][k] * c0) * s;
+            r[13][k] = (e[0][k] * c3 - e[1][k] * c1 + e[2][k] * c0) * s;
+            r[14][k] = (-e[12][k] * s3 + e[13][k] * s1 - e[14][k] * s0) * s;
+            r[15][k] = (e[8][k] * s3 - e[9][k] * s1 + e[10][k] * s0) * s;
+        }
+    }
+    if (singular) throw std::domain_error("Singular matrix");
+}
+
+} // namespace fizx
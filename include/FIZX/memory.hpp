@@ -0,0 +1,244 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "param.hpp"
+
+namespace fizx
+{
+
+/**
+ * Parts of the engine memory is accounted to.
+*/
+enum class Subsystem
+{
+    particles,
+    broadphase,
+    contacts,
+    history,
+    scratch,
+    other,
+    count
+};
+
+/**
+ * Source of the memory the engine allocates. Implementations must be thread safe; the default one
+ * uses aligned operator new.
+*/
+class Allocator
+{
+public:
+    virtual ~Allocator() = default;
+
+    /**
+     * @return memory for bytes, aligned to alignment, or throws std::bad_alloc.
+    */
+    virtual void* allocate(std::size_t bytes, std::size_t alignment) = 0;
+
+    /**
+     * Frees memory from allocate, given the same size and alignment.
+    */
+    virtual void deallocate(void* pointer, std::size_t bytes, std::size_t alignment) = 0;
+};
+
+/**
+ * Thrown when an allocation would take the engine over its memory budget. Nothing is allocated,
+ * so the container or step that asked is left as it was.
+*/
+class BudgetExceeded : public std::bad_alloc
+{
+public:
+    Subsystem subsystem;
+
+    /**
+     * Size of the refused allocation.
+    */
+    std::size_t bytes;
+
+    BudgetExceeded(Subsystem subsystem, std::size_t bytes);
+
+    const char* what() const noexcept override;
+};
+
+/**
+ * Counts the bytes every subsystem holds, process wide, and routes engine allocations to the
+ * installed Allocator. A budget caps the total: allocations going over it throw BudgetExceeded
+ * instead of reaching the allocator. Counters are atomics, so any thread may allocate and query.
+ * Not counted: the worker pool's threads and queue, task graphs, lists of callbacks and columns,
+ * the state of BasicAdaptiveIntegrator and vectors owned by the caller.
+*/
+class MemoryAccount
+{
+private:
+    struct Counter
+    {
+        std::atomic<std::size_t> current{0};
+        std::atomic<std::size_t> peak{0};
+    };
+
+    Counter counters[static_cast<int>(Subsystem::count)];
+    Counter total;
+    std::atomic<std::size_t> budget;
+    std::atomic<Allocator*> allocator;
+
+    static void raise_peak(Counter& counter, std::size_t value);
+
+public:
+    MemoryAccount();
+
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    void* allocate(Subsystem subsystem, std::size_t bytes, std::size_t alignment);
+    void deallocate(Subsystem subsystem, void* pointer, std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Accounts memory the engine holds without allocating it here, such as particle arrays owned
+     * by std::vector. Charging checks the budget like an allocation.
+    */
+    void charge(Subsystem subsystem, std::size_t bytes);
+    void release(Subsystem subsystem, std::size_t bytes);
+
+    std::size_t get_current(Subsystem subsystem) const;
+    std::size_t get_peak(Subsystem subsystem) const;
+    std::size_t get_total() const;
+    std::size_t get_total_peak() const;
+
+    /**
+     * Lowers every peak to the current value.
+    */
+    void reset_peaks();
+
+    /**
+     * @param bytes - most bytes all subsystems may hold together, 0 for no limit.
+    */
+    void set_budget(std::size_t bytes);
+    std::size_t get_budget() const;
+
+    /**
+     * Installs the allocator later allocations go to, nullptr restores the default one.
+     * Memory already allocated is freed by the allocator it came from only if that one is still
+     * installed, so only change it while the engine holds no memory.
+    */
+    void set_allocator(Allocator* allocator);
+    Allocator& get_allocator() const;
+
+    /**
+     * Gets the account every part of the engine allocates through.
+    */
+    static MemoryAccount& shared();
+};
+
+/**
+ * Standard allocator charging a subsystem of the shared account, for engine containers.
+*/
+template <class T, Subsystem Tag>
+class TrackedAllocator
+{
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind
+    {
+        using other = TrackedAllocator<U, Tag>;
+    };
+
+    TrackedAllocator() = default;
+
+    template <class U>
+    TrackedAllocator(const TrackedAllocator<U, Tag>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(MemoryAccount::shared().allocate(Tag, count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count)
+    {
+        MemoryAccount::shared().deallocate(Tag, pointer, count * sizeof(T), alignof(T));
+    }
+
+    template <class U>
+    bool operator==(const TrackedAllocator<U, Tag>&) const { return true; }
+
+    template <class U>
+    bool operator!=(const TrackedAllocator<U, Tag>&) const { return false; }
+};
+
+template <class T, Subsystem Tag>
+using tracked_vector = std::vector<T, TrackedAllocator<T, Tag>>;
+
+template <class T, Subsystem Tag>
+using tracked_deque = std::deque<T, TrackedAllocator<T, Tag>>;
+
+/**
+ * Bump allocator for scratch data that lives until the next reset, such as temporaries of one
+ * step. Memory comes in blocks charged to Subsystem::scratch; a reset keeps them, and merges them
+ * into one block if the last cycle needed more than one, so a steady workload allocates nothing.
+ * Objects placed in it are never destroyed, so it suits trivially destructible types. Not thread
+ * safe: carve out what parallel work needs before starting it.
+*/
+class ScratchArena
+{
+private:
+    struct Block
+    {
+        unsigned char* data;
+        std::size_t size;
+    };
+
+    tracked_vector<Block, Subsystem::scratch> blocks;
+    std::size_t block_size;
+
+    // Block being filled and the bytes used in it.
+    std::size_t current;
+    std::size_t offset;
+
+    /**
+     * Bytes handed out since the last reset, padding included.
+    */
+    std::size_t used;
+
+    void add_block(std::size_t bytes);
+    void free_blocks();
+
+public:
+    /**
+     * @param block_size - size of the blocks taken when the arena is full (bytes).
+    */
+    explicit ScratchArena(std::size_t block_size = 1 << 20);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Space for count objects of type T, uninitialised.
+    */
+    template <class T>
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Makes all the memory available again. Everything allocated before is invalidated.
+    */
+    void reset();
+
+    std::size_t get_used() const;
+    std::size_t get_capacity() const;
+};
+
+} // namespace fizx
@@ -0,0 +1,152 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Verlet neighbour lists for short range interactions between Dim dimensional particles.
+ * Every particle lists the particles within cutoff + skin of it, stored in compressed sparse row
+ * form: the neighbours of particle i are indices[offsets[i]] to indices[offsets[i + 1] - 1].
+ * The lists stay valid until some particle has moved more than half the skin since the last build,
+ * so they can be reused for many steps.
+*/
+template <size_t Dim>
+class BasicNeighbourList
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+    using index_list = tracked_vector<size_t, Subsystem::broadphase>;
+
+private:
+    /**
+     * Holds the interaction range.
+    */
+    real cutoff;
+
+    /**
+     * Holds the extra distance added to the cutoff when building.
+    */
+    real skin;
+
+    /**
+     * Start of every particle's neighbours in indices, with one extra entry at the end.
+    */
+    index_list offsets;
+
+    /**
+     * Neighbour indices of every particle, back to back.
+    */
+    index_list indices;
+
+    /**
+     * Positions of the particles at the last build.
+    */
+    tracked_vector<vec_type, Subsystem::broadphase> reference_positions;
+
+    // Uniform grid used while building, kept to avoid reallocating.
+    index_list cell_offsets;
+    index_list cell_particles;
+    index_list particle_cells;
+
+    /**
+     * Number of times the lists were rebuilt.
+    */
+    size_t build_count;
+
+public:
+    BasicNeighbourList(real cutoff, real skin);
+
+    /**
+     * Rebuilds the lists only if they may have gone stale.
+     * @param particles - particles the lists are for.
+     * @return true if the lists were rebuilt.
+    */
+    bool update(const std::vector<particle_type>& particles);
+
+    /**
+     * Checks if the lists may be missing a neighbour.
+     * @return true if the particle count changed or a particle moved more than half the skin.
+    */
+    bool needs_rebuild(const std::vector<particle_type>& particles) const;
+
+    /**
+     * Rebuilds the lists from the current positions.
+    */
+    void build(const std::vector<particle_type>& particles);
+
+    /**
+     * Adds a pairwise short range force to every particle.
+     * Only pairs closer than the cutoff are evaluated, forces are accumulated per particle and
+     * added with a single add_force call.
+     * @param particles - particles the lists were built for.
+     * @param force - callable taking (self, other) particles, returning the force on self.
+    */
+    template <typename Force>
+    void apply(std::vector<particle_type>& particles, Force force) const
+    {
+        const real cutoff_squared = cutoff * cutoff;
+        parallel_for(static_cast<size_t>(offsets.size()) - 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const vec_type position = particles[i].get_position();
+                vec_type sum;
+                for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+                {
+                    const particle_type& other = particles[indices[k]];
+                    vec_type d = other.get_position() - position;
+                    if (d * d > cutoff_squared) continue;
+                    sum += force(particles[i], other);
+                }
+                particles[i].add_force(sum);
+            }
+        }, 256);
+    }
+
+    /**
+     * Setter for the interaction range, invalidates the lists.
+     * @param cutoff Positive distance (m).
+    */
+    void set_cutoff(real cutoff);
+
+    /**
+     * Setter for the skin distance, invalidates the lists.
+     * @param skin Non negative distance (m).
+    */
+    void set_skin(real skin);
+
+    real get_cutoff() const;
+    real get_skin() const;
+
+    const index_list& get_offsets() const;
+    const index_list& get_indices() const;
+
+    /**
+     * Gets the number of neighbours of a particle.
+    */
+    size_t neighbour_count(size_t index) const;
+
+    size_t get_build_count() const;
+};
+
+using NeighbourList = BasicNeighbourList<3>;
+using NeighbourList2D = BasicNeighbourList<2>;
+
+// Implemented in neighbour.cpp for these dimensions only.
+extern template class BasicNeighbourList<2>;
+extern template class BasicNeighbourList<3>;
+
+} // namespace fizx
@@ -0,0 +1,143 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Particles placed by single precision offsets from a double precision anchor (floating origin).
+ * Positions, velocities and forces are floats, half the memory traffic of real, and stay precise
+ * because the offsets stay small: whenever the tracked focus drifts further than the rebase
+ * distance from the anchor, the anchor moves to it and every offset is shifted by the same amount,
+ * computed in double. Absolute positions are always anchor + offset, in double.
+ * The store stands on its own: it holds no BasicParticle and does not convert to or from the
+ * particle arrays of BasicParticleWorld. Acceleration and damping are shared by every particle.
+*/
+template <size_t Dim>
+class BasicFloatingOrigin
+{
+public:
+    using anchor_type = Vector<double, Dim>;
+    using offset_type = Vector<float, Dim>;
+
+    static constexpr size_t NO_FOCUS = static_cast<size_t>(-1);
+
+private:
+    anchor_type anchor;
+
+    // Per particle state, relative to the anchor.
+    tracked_vector<offset_type, Subsystem::particles> offsets;
+    tracked_vector<offset_type, Subsystem::particles> velocities;
+    tracked_vector<offset_type, Subsystem::particles> net_forces;
+    tracked_vector<float, Subsystem::particles> inverse_masses;
+
+    /**
+     * Constant acceleration applied to every particle.
+    */
+    offset_type acceleration;
+
+    /**
+     * Proportion of the velocity kept after one second, as BasicParticle::damping.
+    */
+    float damping;
+
+    /**
+     * Particle the origin follows, or NO_FOCUS to follow focus_point.
+    */
+    size_t focus;
+    anchor_type focus_point;
+
+    double rebase_distance;
+    size_t rebase_count;
+
+public:
+    /**
+     * @param anchor - initial anchor.
+     * @param rebase_distance - distance of the focus from the anchor that triggers a rebase (m).
+    */
+    explicit BasicFloatingOrigin(const anchor_type& anchor = anchor_type(), double rebase_distance = 1024);
+
+    /**
+     * Adds a particle.
+     * @param inverse_mass - zero for an infinite mass.
+     * @return the index of the particle.
+    */
+    size_t add(const anchor_type& position, const offset_type& velocity = offset_type(), float inverse_mass = 1);
+
+    /**
+     * Moves the particles forward in time, as BasicParticle::integrate does with the shared
+     * acceleration and damping, then rebases if the focus has drifted too far. Clears the forces.
+    */
+    void integrate(float duration);
+
+    /**
+     * Moves the anchor to the focus if it is further than the rebase distance.
+     * @return true if the origin was rebased.
+    */
+    bool rebase_if_needed();
+
+    /**
+     * Moves the anchor, keeping every absolute position.
+    */
+    void rebase(const anchor_type& anchor);
+
+    /**
+     * Follows a particle.
+    */
+    void set_focus(size_t index);
+
+    /**
+     * Follows a fixed point, such as a camera.
+    */
+    void set_focus_point(const anchor_type& point);
+
+    anchor_type get_position(size_t index) const;
+    void set_position(size_t index, const anchor_type& position);
+
+    /**
+     * Gets the position relative to the anchor.
+    */
+    offset_type get_offset(size_t index) const;
+
+    offset_type get_velocity(size_t index) const;
+    void set_velocity(size_t index, const offset_type& velocity);
+
+    void add_force(size_t index, const offset_type& force);
+    void set_acceleration(const offset_type& acceleration);
+
+    /**
+     * Setter for the damping of every particle.
+     * @param damping In [0, 1], 1 for none.
+    */
+    void set_damping(float damping);
+    float get_damping() const;
+
+    const anchor_type& get_anchor() const;
+    void set_rebase_distance(double distance);
+
+    /**
+     * Number of rebases so far.
+    */
+    size_t get_rebase_count() const;
+
+    size_t size() const;
+};
+
+using FloatingOrigin = BasicFloatingOrigin<3>;
+using FloatingOrigin2D = BasicFloatingOrigin<2>;
+
+// Implemented in origin.cpp for these dimensions only.
+extern template class BasicFloatingOrigin<2>;
+extern template class BasicFloatingOrigin<3>;
+
+} // namespace fizx
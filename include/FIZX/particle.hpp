@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <stdexcept>
 #include <math.h>
 #include "param.hpp"
@@ -13,34 +14,41 @@
 namespace fizx
 {
 /**
- * A simple point.
+ * A simple point, in Dim dimensional space.
 */
-class Particle
+template <size_t Dim>
+class BasicParticle
 {
+public:
+    /**
+     * Vector type of the positions, velocities and forces of the particle.
+    */
+    using vec_type = Vector<real, Dim>;
+
 protected:
     /**
      * Holds the linear position of the particle in world space.
     */
-    vec3f position;
+    vec_type position;
 
     /**
      * Holds the linear velocity of the particle in world space.
     */
-    vec3f velocity;
+    vec_type velocity;
 
     /**
      * Holds the acceleration of the particle.
      * This value can be used to set acceleration due to gravity.
      * Or any other constant acceleration.
     */
-    vec3f acceleration;
+    vec_type acceleration;
 
     /**
     * Holds the amount of damping applied to linear
     * motion. Damping is required to remove energy added
     * through numerical instability in the integrator.
     */
-    real damping;
+    real damping = 1.0;
     
     /**
     * Holds the inverse of the mass of the particle. It
@@ -50,13 +58,16 @@ protected:
     * infinite mass (immovable) than zero mass
     * (completely unstable in numerical simulation).
     */
-    real inverse_mass;
+    real inverse_mass = 1.0;
 
     /**
     * Holds the accumulated forces on the particle.
     * Forces acting on a mass will result in acceleration.
     */
-    vec3f net_force;
+    vec_type net_force;
+
+    // Emitters fill the fields of the particles they spawn directly.
+    template <size_t> friend class BasicEmitter;
 
 public:
     /**
@@ -66,6 +77,12 @@ public:
     * may be inaccurate in some cases.
     */
     void integrate(real duration);
+
+    /**
+     * Integrates count particles stored back to back, using the kernel of the active CPU path.
+     * Gives the same result as calling integrate on each particle, within floating point rounding.
+    */
+    static void integrate_batch(BasicParticle* particles, std::size_t count, real duration);
     
 
     /**
@@ -76,27 +93,27 @@ public:
 
     /**
      * Setter for the position (m).
-     * @param pos 3D vector of the position of a particle in the world frame.
+     * @param pos Vector of the position of a particle in the world frame.
     */
-    void set_position(vec3f position);
+    void set_position(vec_type position);
 
     /**
      * Setter for the velocity (m/s).
-     * @param vel 3D vector of the relative velocity in the world frame.
+     * @param vel Vector of the relative velocity in the world frame.
     */
-    void set_velocity(vec3f velocity);
+    void set_velocity(vec_type velocity);
 
     /**
      * Setter for the acceleration (m/s^2)
-     * @param acc 3D vector of the relative acceleration in the world frame.
+     * @param acc Vector of the relative acceleration in the world frame.
     */
-    void set_acceleration(vec3f acceleration);
+    void set_acceleration(vec_type acceleration);
 
     /**
      * Adds a force to the particle for the next integration step.
-     * @param force 3D force vector
+     * @param force Force vector
     */
-    void add_force(vec3f force);
+    void add_force(vec_type force);
 
     /**
      * Sets the net force to the zero vector.
@@ -107,20 +124,51 @@ public:
      * Gets the position of the vector;
      * @return A copy of the position vector.
     */
-    vec3f get_position() const;
+    vec_type get_position() const;
 
     /**
      * Get the velocity of the vector;
      * @return A copy of the velocity vector.
     */
-    vec3f get_velocity() const;
+    vec_type get_velocity() const;
 
     /**
      * Get the acceleration of the vector;
      * @return A copy of the acceleration vector.
     */
-    vec3f get_acceleration() const;
+    vec_type get_acceleration() const;
+
+    /**
+     * Get the accumulated force for the next integration step.
+     * @return A copy of the net force vector.
+    */
+    vec_type get_net_force() const;
+
+    /**
+     * Get the mass of the particle (kg).
+     * @return The mass, or a negative value if the mass is infinite.
+    */
+    real get_mass() const;
+
+    /**
+     * Get the inverse of the mass of the particle.
+     * @return The inverse mass, zero if the mass is infinite.
+    */
+    real get_inverse_mass() const;
+
+    /**
+     * Checks if the particle can be moved by forces.
+     * @return true if the mass is finite.
+    */
+    bool has_finite_mass() const;
 
 };
 
+using Particle = BasicParticle<3>;
+using Particle2D = BasicParticle<2>;
+
+// Implemented in particle.cpp for these dimensions only.
+extern template class BasicParticle<2>;
+extern template class BasicParticle<3>;
+
 } // namespace fizx
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+/**
+ * Batched ray, sphere and box queries against Dim dimensional particles, as spheres of one radius.
+ * build() takes a snapshot of the positions and bins every particle into each cell of a uniform
+ * grid its sphere overlaps, in compressed sparse row form. Rays walk the grid cell by cell and stop
+ * as soon as the nearest hit so far is closer than the next cell; overlap queries visit the cells
+ * of their bounds and report a particle only from the first cell it shares with them, so never
+ * twice. Queries are read only and split across the worker pool: rays are processed in order of
+ * direction octant and origin cell, so neighbouring rays walk the same cells, while the results
+ * stay in the order of the queries.
+*/
+template <size_t Dim>
+class BasicSceneQuery
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+
+    static constexpr size_t NO_HIT = static_cast<size_t>(-1);
+
+    struct Ray
+    {
+        vec_type origin;
+
+        /**
+         * Need not be unit length; distances are along the normalised direction.
+        */
+        vec_type direction;
+
+        real max_distance;
+    };
+
+    struct RayHit
+    {
+        /**
+         * Index of the nearest particle hit, NO_HIT if none.
+        */
+        size_t particle;
+
+        /**
+         * Distance from the origin to the particle surface, 0 if the origin is inside it.
+        */
+        real distance;
+    };
+
+    struct Sphere
+    {
+        vec_type centre;
+        real radius;
+    };
+
+    struct Box
+    {
+        vec_type lower;
+        vec_type upper;
+    };
+
+private:
+    real radius;
+
+    /**
+     * Edge of the grid cells, or 0 to pick one from the particle count at every build.
+    */
+    real cell_size;
+
+    // Grid of the last build.
+    real cell;
+    vec_type lower;
+    size_t dims[Dim];
+    tracked_vector<size_t, Subsystem::broadphase> cell_offsets;
+    tracked_vector<size_t, Subsystem::broadphase> cell_particles;
+
+    /**
+     * Positions of the particles at the last build.
+    */
+    tracked_vector<vec_type, Subsystem::broadphase> positions;
+
+    size_t cell_coord(real x, size_t d) const;
+
+    /**
+     * Nearest hit of one ray, normalised, up to max_distance.
+    */
+    RayHit cast(vec_type origin, vec_type direction, real max_distance) const;
+
+    /**
+     * Calls visit(particle) once for every particle in the cells of [low, high], a particle only
+     * from the first of those cells holding it.
+    */
+    template <class Visit>
+    void visit_cells(const vec_type& low, const vec_type& high, Visit visit) const;
+
+    /**
+     * Runs count overlap queries twice, counting then writing, into the compressed rows of results.
+    */
+    template <class Touches>
+    void gather(std::size_t count, std::vector<size_t>& offsets, std::vector<size_t>& indices, Touches touches) const;
+
+public:
+    /**
+     * @param radius - radius of every particle (m).
+     * @param cell_size - edge of the grid cells, 0 to size them from the particle count. Cells are
+     * never smaller than the particle diameter.
+    */
+    explicit BasicSceneQuery(real radius, real cell_size = 0);
+
+    /**
+     * Rebuilds the grid over the current positions. Queries see the particles as they were here.
+    */
+    void build(const std::vector<particle_type>& particles);
+
+    /**
+     * Finds the nearest particle hit by every ray.
+     * @param hits - count results, in the order of the rays.
+    */
+    void raycast(const Ray* rays, std::size_t count, RayHit* hits) const;
+    void raycast(const std::vector<Ray>& rays, std::vector<RayHit>& hits) const;
+
+    /**
+     * Finds the particles overlapping every sphere, in compressed sparse row form: the particles of
+     * query q are indices[offsets[q]] to indices[offsets[q + 1] - 1], in increasing order.
+     * The caller's vectors are reused, so repeated batches allocate nothing once they have grown.
+    */
+    void overlap(const Sphere* spheres, std::size_t count, std::vector<size_t>& offsets, std::vector<size_t>& indices) const;
+    void overlap(const std::vector<Sphere>& spheres, std::vector<size_t>& offsets, std::vector<size_t>& indices) const;
+
+    /**
+     * Finds the particles overlapping every axis aligned box, as for spheres.
+    */
+    void overlap(const Box* boxes, std::size_t count, std::vector<size_t>& offsets, std::vector<size_t>& indices) const;
+    void overlap(const std::vector<Box>& boxes, std::vector<size_t>& offsets, std::vector<size_t>& indices) const;
+
+    /**
+     * The grid depends on the radius and cell size: build again before the next query.
+    */
+    void set_radius(real radius);
+    void set_cell_size(real cell_size);
+
+    real get_radius() const;
+
+    /**
+     * Cell edge of the last build.
+    */
+    real get_cell() const;
+
+    std::size_t cell_count() const;
+    size_t size() const;
+};
+
+using SceneQuery = BasicSceneQuery<3>;
+using SceneQuery2D = BasicSceneQuery<2>;
+
+// Implemented in query.cpp for these dimensions only.
+extern template class BasicSceneQuery<2>;
+extern template class BasicSceneQuery<3>;
+
+} // namespace fizx
@@ -0,0 +1,73 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+
+namespace fizx
+{
+
+/**
+ * A set of tasks with dependencies between them.
+ * Running the graph starts every task as soon as all of its dependencies have finished, so
+ * independent tasks run concurrently on the worker pool. The graph is kept between runs, so it
+ * only has to be described once and can be run every step.
+*/
+class TaskGraph
+{
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> work;
+        std::vector<size_t> successors;
+        size_t dependencies;
+    };
+
+    std::vector<Task> tasks;
+
+    // Dependencies left per task during a run.
+    std::unique_ptr<std::atomic<size_t>[]> remaining;
+
+    void launch(size_t task, WorkerPool& pool, TaskGroup& group, std::atomic<size_t>& finished);
+
+public:
+    /**
+     * Adds a task to the graph.
+     * @param name - label used in error messages.
+     * @param work - the function to run.
+     * @return the id of the task.
+    */
+    size_t add_task(std::string name, std::function<void()> work);
+
+    /**
+     * Makes a task wait for another task to finish.
+     * @param before - id of the task that runs first.
+     * @param after - id of the task that waits.
+    */
+    void add_dependency(size_t before, size_t after);
+
+    /**
+     * Runs every task once and returns when they have all finished.
+     * Rethrows the first exception thrown by a task; tasks depending on a failed task do not run.
+     * @throws std::logic_error if the dependencies form a cycle.
+    */
+    void run(WorkerPool& pool = WorkerPool::shared());
+
+    /**
+     * Number of tasks in the graph.
+    */
+    size_t size() const;
+
+    const std::string& get_name(size_t task) const;
+};
+
+} // namespace fizx
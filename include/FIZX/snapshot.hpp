@@ -0,0 +1,179 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "vec.hpp"
+#include "particle.hpp"
+#include "memory.hpp"
+
+namespace fizx
+{
+
+template <size_t Dim>
+class BasicStateBuffer;
+
+/**
+ * A read-only view of the positions and velocities published for one step.
+ * The arrays are not copied and stay valid and unchanged until the view is released or destroyed.
+*/
+template <size_t Dim>
+class BasicStateView
+{
+public:
+    using vec_type = Vector<real, Dim>;
+    using vec_list = tracked_vector<vec_type, Subsystem::particles>;
+
+private:
+    friend class BasicStateBuffer<Dim>;
+
+    BasicStateBuffer<Dim>* buffer;
+    size_t slot;
+
+    BasicStateView(BasicStateBuffer<Dim>* buffer, size_t slot) : buffer(buffer), slot(slot) {}
+
+public:
+    BasicStateView() : buffer(nullptr), slot(-1) {}
+
+    BasicStateView(BasicStateView&& other) : buffer(other.buffer), slot(other.slot)
+    {
+        other.buffer = nullptr;
+    }
+
+    BasicStateView& operator=(BasicStateView&& other)
+    {
+        if (this != &other)
+        {
+            release();
+            buffer = other.buffer;
+            slot = other.slot;
+            other.buffer = nullptr;
+        }
+        return *this;
+    }
+
+    BasicStateView(const BasicStateView&) = delete;
+    BasicStateView& operator=(const BasicStateView&) = delete;
+
+    ~BasicStateView()
+    {
+        release();
+    }
+
+    /**
+     * Hands the arrays back to the buffer, the view is empty afterwards.
+    */
+    void release();
+
+    /**
+     * Checks if the view holds a published step.
+    */
+    bool valid() const
+    {
+        return buffer != nullptr;
+    }
+
+    const vec_list& positions() const;
+    const vec_list& velocities() const;
+
+    /**
+     * Step number the arrays were published for.
+    */
+    size_t version() const;
+};
+
+/**
+ * Publishes particle positions and velocities for readers on other threads.
+ * The publisher writes into a slot no reader holds and then makes it the latest, so neither side
+ * takes a lock and readers never see a half written step. With three slots (triple buffering) a
+ * single reader holding a view never holds up publishing; if readers hold every spare slot, the
+ * step is skipped and readers keep seeing the previous one.
+ * The arrays of the slots are charged to Subsystem::particles; the few slot headers are not.
+*/
+template <size_t Dim>
+class BasicStateBuffer
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using vec_type = Vector<real, Dim>;
+    using view_type = BasicStateView<Dim>;
+
+private:
+    friend class BasicStateView<Dim>;
+
+    struct Slot
+    {
+        /**
+         * Number of readers, or WRITING while the publisher fills the slot.
+        */
+        std::atomic<int> readers;
+        size_t version;
+        typename view_type::vec_list positions;
+        typename view_type::vec_list velocities;
+    };
+
+    static constexpr int WRITING = -1;
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slot_count;
+
+    /**
+     * Slot holding the latest published step, -1 before the first publish.
+    */
+    std::atomic<int> latest;
+
+    /**
+     * Number of steps that could not be published, read from any thread.
+    */
+    std::atomic<size_t> skipped;
+
+public:
+    /**
+     * @param slot_count - number of buffers, at least 2. No step is ever skipped while at most
+     * slot_count - 2 readers hold views.
+    */
+    explicit BasicStateBuffer(size_t slot_count = 3);
+
+    BasicStateBuffer(const BasicStateBuffer&) = delete;
+    BasicStateBuffer& operator=(const BasicStateBuffer&) = delete;
+
+    /**
+     * Copies the state of the particles into a free slot and makes it the latest.
+     * Only one thread may publish.
+     * @return false if every spare slot was held by readers and the step was skipped.
+     * @throws BudgetExceeded if the slot cannot grow; the slot is given back and the latest step
+     * stays as it was.
+    */
+    bool publish(const std::vector<particle_type>& particles, size_t version);
+
+    /**
+     * Gets a view of the latest published step, may be called from any thread.
+     * @return an empty view if nothing was published yet.
+    */
+    view_type acquire();
+
+    /**
+     * Gets the number of steps skipped so far, may be called from any thread.
+    */
+    size_t get_skipped() const;
+};
+
+using StateView = BasicStateView<3>;
+using StateView2D = BasicStateView<2>;
+using StateBuffer = BasicStateBuffer<3>;
+using StateBuffer2D = BasicStateBuffer<2>;
+
+// Implemented in snapshot.cpp for these dimensions only.
+extern template class BasicStateView<2>;
+extern template class BasicStateView<3>;
+extern template class BasicStateBuffer<2>;
+extern template class BasicStateBuffer<3>;
+
+} // namespace fizx
@@ -5,7 +5,11 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string>
 #include <type_traits>
 
 #include "param.hpp"
@@ -18,6 +22,40 @@ namespace fizx {
 template<typename T, size_t NElems>
 class Vector;
 
+/**
+ * Approximates 1 / sqrt(x) for x > 0, within a relative error of 5e-6.
+ * A bit level first guess refined by two Newton steps: only multiplies and integer operations,
+ * so it pipelines and vectorizes where a square root and a division do not.
+*/
+inline double inverse_sqrt_approx(double x)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5fe6eb50c7b537a9ull - (bits >> 1);
+    double y;
+    std::memcpy(&y, &bits, sizeof(y));
+    const double half = 0.5 * x;
+    y *= 1.5 - half * y * y;
+    y *= 1.5 - half * y * y;
+    return y;
+}
+
+/**
+ * Approximates 1 / sqrt(x) for x > 0, within a relative error of 5e-6.
+*/
+inline float inverse_sqrt_approx(float x)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    const float half = 0.5f * x;
+    y *= 1.5f - half * y * y;
+    y *= 1.5f - half * y * y;
+    return y;
+}
+
 // Macro
 #define VECTOR Vector<T, NElems>
 
@@ -47,6 +85,19 @@ public:
     Vector(std::enable_if_t<sizeof...(Tail) + 1 == NElems, T> head, Tail... tail)
     : values{head, static_cast<T>(tail)...} {};
 
+    /**
+     * Converts a vector with another element type, element by element.
+     * @param other - vector of the same dimension.
+    */
+    template <typename U, typename = std::enable_if_t<!std::is_same<U, T>::value>>
+    explicit Vector(const Vector<U, NElems>& other)
+    {
+        for (size_t n = 0; n < NElems; ++n)
+        {
+            values[n] = static_cast<T>(other[n]);
+        }
+    }
+
     // OPERATORS //-------------------------------------------------------------------------------
 
     ////////////////////
@@ -67,7 +118,7 @@ public:
      * Element Assignment operator.
      * @param index - which element to change.
     */
-    real& operator[](size_t index)
+    T& operator[](size_t index)
     {
         if (index >= NElems)
             throw std::runtime_error("Index Out of Bounds");
@@ -80,7 +131,7 @@ public:
      * Gets the element at the specified index.
      * @returns the element at the index.
     */
-    real operator[](size_t index) const
+    T operator[](size_t index) const
     {
         if (index >= NElems)
             throw std::runtime_error("Index Out of Bounds");
@@ -220,10 +271,12 @@ public:
 
     std::string to_string() const
     {
-        std::string s = "";
+        std::string s;
+        s.reserve(NElems * (REAL_CHARS + 1));
         for (size_t n = 0; n < NElems; ++n)
         {
-            s += " " + std::to_string(values[n]);
+            s += ' ';
+            append_real(s, values[n]);
         }
         return s;
     }
@@ -276,7 +329,7 @@ public:
      * @param other - the other vector to add.
      * @param scalar - the value to scale the other vector by.
     */
-    void add_scaled_vector(VECTOR& other, real scalar)
+    void add_scaled_vector(const VECTOR& other, real scalar)
     {
         for (size_t n = 0; n < NElems; ++n) {
             values[n] +=  other[n] *scalar;
@@ -293,6 +346,106 @@ public:
         {
             values[n] = val;
         }
+        return *this;
+    }
+
+    /**
+     * Gets the squared length, cheaper than magnitude() for comparisons.
+    */
+    T square_magnitude() const
+    {
+        return (*this) * (*this);
+    }
+
+    /**
+     * Gets the length of the vector.
+    */
+    T magnitude() const
+    {
+        return std::sqrt(square_magnitude());
+    }
+
+    /**
+     * Gets the length of the vector from inverse_sqrt_approx().
+    */
+    T fast_magnitude() const
+    {
+        const T square = square_magnitude();
+        return square > 0 ? square * inverse_sqrt_approx(square) : 0;
+    }
+
+    /**
+     * Scales the vector to unit length. The zero vector is left unchanged.
+    */
+    void normalize()
+    {
+        const T square = square_magnitude();
+        if (square > 0) (*this) *= 1 / std::sqrt(square);
+    }
+
+    /**
+     * Scales the vector to unit length with inverse_sqrt_approx(). The zero vector is left unchanged.
+    */
+    void fast_normalize()
+    {
+        const T square = square_magnitude();
+        if (square > 0) (*this) *= inverse_sqrt_approx(square);
+    }
+
+    /**
+     * @returns a unit length copy of the vector, or the zero vector.
+    */
+    VECTOR unit() const
+    {
+        VECTOR temp = *this;
+        temp.normalize();
+        return temp;
+    }
+
+    /**
+     * @returns a unit length copy of the vector from inverse_sqrt_approx(), or the zero vector.
+    */
+    VECTOR fast_unit() const
+    {
+        VECTOR temp = *this;
+        temp.fast_normalize();
+        return temp;
+    }
+
+    /**
+     * Gets the distance between two points.
+    */
+    T distance(const VECTOR& other) const
+    {
+        return std::sqrt(square_distance(other));
+    }
+
+    /**
+     * Gets the squared distance between two points.
+    */
+    T square_distance(const VECTOR& other) const
+    {
+        T sum = 0;
+        for (size_t n = 0; n < NElems; ++n)
+        {
+            const T d = values[n] - other.values[n];
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    /**
+     * @returns the cross product with another vector.
+     * 4D vectors are treated as homogeneous directions: xyz are crossed and w is zero.
+    */
+    template <typename Q = T>
+    std::enable_if_t<(NElems == 3 || NElems == 4), Vector<Q, NElems>> cross(const VECTOR& other) const
+    {
+        VECTOR temp;
+        temp.values[0] = values[1] * other.values[2] - values[2] * other.values[1];
+        temp.values[1] = values[2] * other.values[0] - values[0] * other.values[2];
+        temp.values[2] = values[0] * other.values[1] - values[1] * other.values[0];
+        return temp;
     }
 
 };
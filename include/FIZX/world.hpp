@@ -0,0 +1,222 @@
+/**
+ *
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "param.hpp"
+#include "core.hpp"
+#include "particle.hpp"
+#include "command.hpp"
+#include "memory.hpp"
+#include "scheduler.hpp"
+#include "snapshot.hpp"
+
+namespace fizx
+{
+
+/**
+ * Holds a set of Dim dimensional particles and steps them forward in time.
+ * A step is a task graph of phases run on the worker pool:
+ * commands -> forces -> integration -> broadphase -> narrowphase -> resolution -> output.
+ * Other threads edit the particles by queueing commands, which are applied at the start of a step.
+ * Integration uses the particle kernel of the active CPU path (see dispatch.hpp), unless an
+ * integrator stage replaces it.
+ * The output phase copies the particles and hands the copy to the output callback in the
+ * background, so exporting frame N overlaps with stepping frame N + 1. It can also publish
+ * positions and velocities to a state buffer, for readers that must not wait on the step.
+ * The particle arrays are charged to Subsystem::particles of the shared MemoryAccount at the start
+ * and end of every step, and stages get a scratch arena that is reset at the start of every step.
+*/
+template <size_t Dim>
+class BasicParticleWorld
+{
+public:
+    using particle_type = BasicParticle<Dim>;
+    using command_type = BasicParticleCommand<Dim>;
+
+    /**
+     * Phases of a step, in order.
+    */
+    enum class Phase
+    {
+        commands,
+        forces,
+        integration,
+        broadphase,
+        narrowphase,
+        resolution,
+        output,
+        count
+    };
+
+    /**
+     * Adds forces to the particles, given the step duration.
+    */
+    using ForceGenerator = std::function<void(std::vector<particle_type>&, real)>;
+
+    /**
+     * Works on the particles during a collision phase, given the step duration.
+    */
+    using Stage = std::function<void(std::vector<particle_type>&, real)>;
+
+    /**
+     * Receives a copy of the particles at the end of a step, with the step number.
+    */
+    using Output = std::function<void(const std::vector<particle_type>&, size_t)>;
+
+private:
+    std::vector<particle_type> particles;
+
+    // Edits queued by other threads, and the batch being applied.
+    CommandQueue<command_type> commands;
+    tracked_vector<command_type, Subsystem::other> command_batch;
+
+    std::vector<ForceGenerator> force_generators;
+    Stage integrator;
+    Stage broadphase;
+    Stage narrowphase;
+    Stage resolver;
+    Output output;
+
+    WorkerPool& pool;
+    TaskGraph graph;
+    size_t phase_tasks[static_cast<int>(Phase::count)];
+
+    /**
+     * Duration of the step being run.
+    */
+    real duration;
+
+    /**
+     * Number of steps run so far.
+    */
+    size_t frame;
+
+    // Copy of the particles being exported, owned by the output in flight.
+    std::vector<particle_type> output_buffer;
+    TaskGroup output_group;
+
+    BasicStateBuffer<Dim> state;
+    bool state_publishing;
+
+    ScratchArena scratch;
+
+    /**
+     * Bytes of particle arrays charged to the memory account.
+    */
+    std::size_t accounted_bytes;
+
+    /**
+     * Charges or releases the change in the capacity of the particle arrays since the last call.
+    */
+    void account();
+
+    void apply_commands();
+    void integrate();
+    void publish();
+
+public:
+    /**
+     * @param pool - worker pool the steps run on.
+     * @param command_capacity - most commands that can wait for the next step, allocated up front;
+     * raise it for many producers queueing between steps.
+    */
+    explicit BasicParticleWorld(WorkerPool& pool = WorkerPool::shared(), std::size_t command_capacity = 1024);
+
+    /**
+     * Waits for the output in flight.
+    */
+    ~BasicParticleWorld();
+
+    BasicParticleWorld(const BasicParticleWorld&) = delete;
+    BasicParticleWorld& operator=(const BasicParticleWorld&) = delete;
+
+    /**
+     * Runs one step of the simulation.
+     * Returns once the particles are updated; the output of the step may still be running.
+     * Throws BudgetExceeded before changing anything if the particle arrays, grown since the last
+     * step, no longer fit the memory budget.
+     * @param duration Positive length of the step (s).
+    */
+    void step(real duration);
+
+    /**
+     * Waits for the output of the last step to finish.
+     * Rethrows any exception thrown by the output callback.
+    */
+    void finish();
+
+    std::vector<particle_type>& get_particles();
+    const std::vector<particle_type>& get_particles() const;
+
+    /**
+     * Queues an edit to apply at the start of the next step. Lock-free, may be called from any
+     * thread, even while a step is running. Commands from one thread are applied in the order
+     * they were queued; commands naming a particle that does not exist are ignored.
+     * @return false if the queue is full.
+    */
+    bool queue_command(command_type command);
+
+    /**
+     * Adds a force generator, run in order of registration during the forces phase.
+    */
+    void add_force_generator(ForceGenerator generator);
+
+    /**
+     * Replaces the integration of the particles, an empty stage restores the default.
+    */
+    void set_integrator(Stage stage);
+
+    void set_broadphase(Stage stage);
+    void set_narrowphase(Stage stage);
+    void set_resolver(Stage stage);
+    void set_output(Output output);
+
+    /**
+     * Turns publishing positions and velocities to the state buffer at the end of each step on or off.
+     * Off by default, as it copies the state every step.
+    */
+    void set_state_publishing(bool enabled);
+
+    /**
+     * Gets the buffer steps publish their state to. Any thread may acquire views from it; the
+     * version of a view is the number of the step it was published by, starting at 0.
+    */
+    BasicStateBuffer<Dim>& get_state();
+
+    /**
+     * Gets the arena for temporaries of the stages. Everything allocated from it is released at the
+     * start of the next step.
+    */
+    ScratchArena& get_scratch();
+
+    /**
+     * Gets the step graph, to add tasks around the phases.
+     * Tasks added to the graph run once per step.
+    */
+    TaskGraph& get_graph();
+
+    /**
+     * Gets the id of the graph task running a phase.
+    */
+    size_t get_phase_task(Phase phase) const;
+
+    /**
+     * Number of steps run so far.
+    */
+    size_t get_frame() const;
+};
+
+using ParticleWorld = BasicParticleWorld<3>;
+using ParticleWorld2D = BasicParticleWorld<2>;
+
+// Implemented in world.cpp for these dimensions only.
+extern template class BasicParticleWorld<2>;
+extern template class BasicParticleWorld<3>;
+
+} // namespace fizx
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/adaptive.hpp>
+
+namespace
+{
+using fizx::real;
+
+// Dormand-Prince 5(4) tableau. The last row of A is also the 5th order solution.
+constexpr real A[7][6] = {
+    {0, 0, 0, 0, 0, 0},
+    {1.0 / 5, 0, 0, 0, 0, 0},
+    {3.0 / 40, 9.0 / 40, 0, 0, 0, 0},
+    {44.0 / 45, -56.0 / 15, 32.0 / 9, 0, 0, 0},
+    {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729, 0, 0},
+    {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656, 0},
+    {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84}
+};
+
+// Difference between the 5th and the embedded 4th order weights.
+constexpr real E[7] = {
+    71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40
+};
+
+} // namespace
+
+template <fizx::size_t Dim>
+fizx::BasicAdaptiveIntegrator<Dim>::BasicAdaptiveIntegrator(real absolute_tolerance, real relative_tolerance)
+: absolute_tolerance(0), relative_tolerance(0), next_step(0)
+{
+    set_tolerance(absolute_tolerance, relative_tolerance);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicAdaptiveIntegrator<Dim>::evaluate(int stage)
+{
+    const std::vector<vec_type>& p = stage == 0 ? positions : trial_positions;
+    const std::vector<vec_type>& v = stage == 0 ? velocities : trial_velocities;
+    std::vector<vec_type>& k_velocity = stage_velocities[stage];
+    std::vector<vec_type>& k_acceleration = stage_accelerations[stage];
+
+    const std::size_t count = p.size();
+    if (field) field(p, v, k_acceleration);
+    else std::fill(k_acceleration.begin(), k_acceleration.end(), vec_type());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (inverse_masses[i] > 0)
+        {
+            k_velocity[i] = v[i];
+            k_acceleration[i] += constant[i];
+        }
+        else
+        {
+            k_velocity[i] = vec_type();
+            k_acceleration[i] = vec_type();
+        }
+    }
+    ++stats.evaluations;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicAdaptiveIntegrator<Dim>::try_step(real step)
+{
+    static_assert(sizeof(vec_type) == Dim * sizeof(real), "vec_type must be Dim packed reals");
+    const std::size_t n = positions.size() * Dim;
+    const real* p = reinterpret_cast<const real*>(positions.data());
+    const real* v = reinterpret_cast<const real*>(velocities.data());
+    real* tp = reinterpret_cast<real*>(trial_positions.data());
+    real* tv = reinterpret_cast<real*>(trial_velocities.data());
+
+    // Stage 0 is already evaluated, either freshly or as the last stage of the previous step.
+    for (int s = 1; s < STAGES; ++s)
+    {
+        std::copy(p, p + n, tp);
+        std::copy(v, v + n, tv);
+        for (int j = 0; j < s; ++j)
+        {
+            const real weight = step * A[s][j];
+            if (weight == 0) continue;
+            const real* kp = reinterpret_cast<const real*>(stage_velocities[j].data());
+            const real* kv = reinterpret_cast<const real*>(stage_accelerations[j].data());
+            for (std::size_t c = 0; c < n; ++c)
+            {
+                tp[c] += weight * kp[c];
+                tv[c] += weight * kv[c];
+            }
+        }
+        evaluate(s);
+    }
+
+    // Root mean square of the error estimate, scaled by the tolerance of each component.
+    real sum = 0;
+    for (std::size_t c = 0; c < n; ++c)
+    {
+        real error_position = 0;
+        real error_velocity = 0;
+        for (int j = 0; j < STAGES; ++j)
+        {
+            error_position += E[j] * reinterpret_cast<const real*>(stage_velocities[j].data())[c];
+            error_velocity += E[j] * reinterpret_cast<const real*>(stage_accelerations[j].data())[c];
+        }
+        const real scale_position = absolute_tolerance + relative_tolerance * std::max(std::abs(p[c]), std::abs(tp[c]));
+        const real scale_velocity = absolute_tolerance + relative_tolerance * std::max(std::abs(v[c]), std::abs(tv[c]));
+        error_position *= step / scale_position;
+        error_velocity *= step / scale_velocity;
+        sum += error_position * error_position + error_velocity * error_velocity;
+    }
+    return n == 0 ? 0 : std::sqrt(sum / (2 * n));
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicAdaptiveIntegrator<Dim>::advance(std::vector<particle_type>& particles, real duration)
+{
+    if (duration <= 0) throw std::domain_error("Duration must be positive");
+
+    // Storage only grows, so a steady particle count never allocates here.
+    const std::size_t count = particles.size();
+    positions.resize(count);
+    velocities.resize(count);
+    constant.resize(count);
+    inverse_masses.resize(count);
+    trial_positions.resize(count);
+    trial_velocities.resize(count);
+    for (int s = 0; s < STAGES; ++s)
+    {
+        stage_velocities[s].resize(count);
+        stage_accelerations[s].resize(count);
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const particle_type& particle = particles[i];
+        positions[i] = particle.get_position();
+        velocities[i] = particle.get_velocity();
+        inverse_masses[i] = particle.get_inverse_mass();
+        constant[i] = particle.get_acceleration() + particle.get_net_force() * inverse_masses[i];
+    }
+    evaluate(0);
+
+    if (next_step <= 0)
+    {
+        // Start from a step that changes the state by about a hundredth of its size.
+        real state = 0;
+        real rate = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            state += positions[i] * positions[i] + velocities[i] * velocities[i];
+            rate += stage_velocities[0][i] * stage_velocities[0][i] + stage_accelerations[0][i] * stage_accelerations[0][i];
+        }
+        next_step = (state > 0 && rate > 0) ? 0.01 * std::sqrt(state / rate) : duration;
+    }
+
+    size_t accepted = 0;
+    real time = 0;
+    while (time < duration)
+    {
+        const real remaining = duration - time;
+        const bool last = next_step >= remaining;
+        const real step = last ? remaining : next_step;
+        if (step <= duration * 1e-12) throw std::runtime_error("Adaptive step size underflow");
+
+        const real error = try_step(step);
+        const real factor = error == 0 ? 5 : std::min<real>(5, std::max<real>(0.2, 0.9 * std::pow(error, -0.2)));
+        if (error > 1)
+        {
+            ++stats.rejected;
+            next_step = step * std::min<real>(factor, 1);
+            continue;
+        }
+
+        ++accepted;
+        ++stats.accepted;
+        stats.smallest_step = stats.smallest_step == 0 ? step : std::min(stats.smallest_step, step);
+        stats.largest_step = std::max(stats.largest_step, step);
+        positions.swap(trial_positions);
+        velocities.swap(trial_velocities);
+        // The last stage is evaluated at the new state, so it starts the next step.
+        stage_velocities[0].swap(stage_velocities[STAGES - 1]);
+        stage_accelerations[0].swap(stage_accelerations[STAGES - 1]);
+        time = last ? duration : time + step;
+        // A step cut short to land on the duration says little about the size to try next.
+        if (!last || factor < 1) next_step = step * factor;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        particle_type& particle = particles[i];
+        if (inverse_masses[i] > 0)
+        {
+            particle.set_position(positions[i]);
+            particle.set_velocity(velocities[i]);
+        }
+        particle.clear_forces();
+    }
+    return accepted;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicAdaptiveIntegrator<Dim>::set_tolerance(real absolute_tolerance, real relative_tolerance)
+{
+    if (absolute_tolerance < 0 || relative_tolerance < 0 || absolute_tolerance + relative_tolerance <= 0)
+        throw std::domain_error("Tolerances must be non negative and not both zero");
+    this->absolute_tolerance = absolute_tolerance;
+    this->relative_tolerance = relative_tolerance;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicAdaptiveIntegrator<Dim>::set_field(Field field)
+{
+    this->field = std::move(field);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicAdaptiveIntegrator<Dim>::set_next_step(real step)
+{
+    if (step < 0) throw std::domain_error("Step cannot be negative");
+    next_step = step;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicAdaptiveIntegrator<Dim>::get_next_step() const
+{
+    return next_step;
+}
+
+template <fizx::size_t Dim>
+const fizx::AdaptiveStats& fizx::BasicAdaptiveIntegrator<Dim>::get_stats() const
+{
+    return stats;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicAdaptiveIntegrator<Dim>::reset_stats()
+{
+    stats = AdaptiveStats();
+}
+
+template class fizx::BasicAdaptiveIntegrator<2>;
+template class fizx::BasicAdaptiveIntegrator<3>;
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <FIZX/batch.hpp>
+#include <FIZX/dispatch.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicWorldBatch<Dim>::BasicWorldBatch(std::size_t world_count, std::size_t particle_count)
+: worlds(world_count), particles(particle_count), drag_duration(0), drag_stale(true)
+{
+    static_assert(sizeof(particle_type) == ROWS * sizeof(real), "Particle must be packed reals");
+    if (world_count == 0) throw std::invalid_argument("A batch needs at least one world");
+
+    stride = (worlds + LANE_ALIGNMENT - 1) / LANE_ALIGNMENT * LANE_ALIGNMENT;
+    state.assign(particles * ROWS * stride, 0);
+    // Default particles everywhere, padding lanes get an infinite mass.
+    const particle_type default_particle;
+    const real* fields = reinterpret_cast<const real*>(&default_particle);
+    for (std::size_t i = 0; i < particles; ++i)
+    {
+        for (std::size_t r = 0; r < ROWS; ++r)
+        {
+            std::fill_n(state.data() + (i * ROWS + r) * stride, worlds, fields[r]);
+        }
+    }
+    initial = state;
+    drag.assign(particles * stride, 1);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::check(std::size_t world, std::size_t index) const
+{
+    if (world >= worlds || index >= particles) throw std::runtime_error("Index Out of Bounds");
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::step(real duration)
+{
+    if (duration <= 0) throw std::domain_error("Duration must be positive");
+
+    for (ForceGenerator& generator : force_generators)
+    {
+        generator(*this, duration);
+    }
+
+    if (drag_stale || duration != drag_duration)
+    {
+        for (std::size_t i = 0; i < particles; ++i)
+        {
+            const real* damping = state.data() + (i * ROWS + static_cast<std::size_t>(Field::damping)) * stride;
+            real* factor = drag.data() + i * stride;
+            for (std::size_t w = 0; w < stride; ++w)
+            {
+                factor[w] = damping[w] == 1 ? 1 : std::pow(damping[w], duration);
+            }
+        }
+        drag_duration = duration;
+        drag_stale = false;
+    }
+
+    // Worlds are independent, so threads split the lanes and each runs down every particle.
+    const Kernels& active = kernels();
+    const size_t groups = static_cast<size_t>(stride / LANE_ALIGNMENT);
+    parallel_for(groups, [&](size_t begin, size_t end)
+    {
+        const std::size_t first = begin * LANE_ALIGNMENT;
+        active.integrate_lanes(state.data() + first, drag.data() + first, particles,
+            (end - begin) * LANE_ALIGNMENT, stride, Dim, duration);
+    }, 64);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::load(std::size_t world, const std::vector<particle_type>& particles)
+{
+    if (particles.size() != this->particles) throw std::invalid_argument("Particle count does not match the batch");
+    for (std::size_t i = 0; i < this->particles; ++i)
+    {
+        set_particle(world, i, particles[i]);
+        for (std::size_t r = 0; r < ROWS; ++r)
+        {
+            std::size_t at = (i * ROWS + r) * stride + world;
+            initial[at] = state[at];
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::store(std::size_t world, std::vector<particle_type>& particles) const
+{
+    particles.resize(this->particles);
+    for (std::size_t i = 0; i < this->particles; ++i)
+    {
+        particles[i] = get_particle(world, i);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::reset(std::size_t world)
+{
+    check(world, 0);
+    for (std::size_t at = world; at < state.size(); at += stride)
+    {
+        state[at] = initial[at];
+    }
+    drag_stale = true;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::set_particle(std::size_t world, std::size_t index, const particle_type& particle)
+{
+    check(world, index);
+    const real* fields = reinterpret_cast<const real*>(&particle);
+    real* block = state.data() + index * ROWS * stride + world;
+    for (std::size_t r = 0; r < ROWS; ++r)
+    {
+        block[r * stride] = fields[r];
+    }
+    drag_stale = true;
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicWorldBatch<Dim>::particle_type fizx::BasicWorldBatch<Dim>::get_particle(std::size_t world, std::size_t index) const
+{
+    check(world, index);
+    particle_type particle;
+    real* fields = reinterpret_cast<real*>(&particle);
+    const real* block = state.data() + index * ROWS * stride + world;
+    for (std::size_t r = 0; r < ROWS; ++r)
+    {
+        fields[r] = block[r * stride];
+    }
+    return particle;
+}
+
+template <fizx::size_t Dim>
+fizx::real* fizx::BasicWorldBatch<Dim>::row(Field field, std::size_t index, std::size_t component)
+{
+    const std::size_t components = field == Field::damping || field == Field::inverse_mass ? 1 : Dim;
+    if (index >= particles || component >= components) throw std::runtime_error("Index Out of Bounds");
+    // The damping may be written through the row.
+    if (field == Field::damping) drag_stale = true;
+    return state.data() + (index * ROWS + static_cast<std::size_t>(field) + component) * stride;
+}
+
+template <fizx::size_t Dim>
+const fizx::real* fizx::BasicWorldBatch<Dim>::row(Field field, std::size_t index, std::size_t component) const
+{
+    const std::size_t components = field == Field::damping || field == Field::inverse_mass ? 1 : Dim;
+    if (index >= particles || component >= components) throw std::runtime_error("Index Out of Bounds");
+    return state.data() + (index * ROWS + static_cast<std::size_t>(field) + component) * stride;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicWorldBatch<Dim>::add_force_generator(ForceGenerator generator)
+{
+    force_generators.push_back(std::move(generator));
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicWorldBatch<Dim>::world_count() const
+{
+    return worlds;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicWorldBatch<Dim>::particle_count() const
+{
+    return particles;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicWorldBatch<Dim>::get_stride() const
+{
+    return stride;
+}
+
+template class fizx::BasicWorldBatch<2>;
+template class fizx::BasicWorldBatch<3>;
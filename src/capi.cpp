@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <FIZX/fizx.h>
+#include <FIZX/world.hpp>
+
+struct fizx_world
+{
+    int dimension;
+    std::unique_ptr<fizx::ParticleWorld2D> world2;
+    std::unique_ptr<fizx::ParticleWorld> world3;
+};
+
+namespace
+{
+static_assert(std::is_same<fizx::real, fizx_real>::value, "fizx_real must match fizx::real");
+
+thread_local std::string last_error;
+
+/**
+ * Runs body, turning any exception into a status and the thread's last error.
+*/
+template <typename Body>
+fizx_status guard(Body body)
+{
+    try
+    {
+        body();
+        last_error.clear();
+        return FIZX_OK;
+    }
+    catch (const std::bad_alloc&)
+    {
+        last_error = "Out of memory";
+        return FIZX_ERROR_OUT_OF_MEMORY;
+    }
+    catch (const std::out_of_range& e)
+    {
+        last_error = e.what();
+        return FIZX_ERROR_OUT_OF_RANGE;
+    }
+    catch (const std::invalid_argument& e)
+    {
+        last_error = e.what();
+        return FIZX_ERROR_INVALID_ARGUMENT;
+    }
+    catch (const std::domain_error& e)
+    {
+        last_error = e.what();
+        return FIZX_ERROR_INVALID_ARGUMENT;
+    }
+    catch (const std::exception& e)
+    {
+        last_error = e.what();
+        return FIZX_ERROR_INTERNAL;
+    }
+    catch (...)
+    {
+        last_error = "Unknown error";
+        return FIZX_ERROR_INTERNAL;
+    }
+}
+
+/**
+ * Calls body with the world of the handle's dimension.
+*/
+template <typename Body>
+void visit(fizx_world* world, Body body)
+{
+    if (!world) throw std::invalid_argument("Null world");
+    if (world->dimension == 2) body(*world->world2);
+    else body(*world->world3);
+}
+
+template <typename Body>
+void visit(const fizx_world* world, Body body)
+{
+    if (!world) throw std::invalid_argument("Null world");
+    if (world->dimension == 2) body(static_cast<const fizx::ParticleWorld2D&>(*world->world2));
+    else body(static_cast<const fizx::ParticleWorld&>(*world->world3));
+}
+
+/**
+ * Offset of a field in the BasicParticle layout, in reals.
+*/
+std::size_t offset(int dimension, fizx_field field)
+{
+    const std::size_t d = static_cast<std::size_t>(dimension);
+    switch (field)
+    {
+    case FIZX_FIELD_POSITION: return 0;
+    case FIZX_FIELD_VELOCITY: return d;
+    case FIZX_FIELD_ACCELERATION: return 2 * d;
+    case FIZX_FIELD_DAMPING: return 3 * d;
+    case FIZX_FIELD_INVERSE_MASS: return 3 * d + 1;
+    case FIZX_FIELD_NET_FORCE: return 3 * d + 2;
+    }
+    throw std::invalid_argument("Unknown field");
+}
+
+std::size_t components(int dimension, fizx_field field)
+{
+    offset(dimension, field);
+    return field == FIZX_FIELD_DAMPING || field == FIZX_FIELD_INVERSE_MASS ? 1 : static_cast<std::size_t>(dimension);
+}
+
+/**
+ * Gets the particles as packed reals, checking the range [first, first + count).
+*/
+template <typename Particle>
+auto fields(std::vector<Particle>& particles, std::size_t first, std::size_t count)
+{
+    static_assert(sizeof(Particle) == 4 * sizeof(typename Particle::vec_type) + 2 * sizeof(fizx::real),
+        "Particle must be packed reals");
+    if (first > particles.size() || count > particles.size() - first) throw std::out_of_range("Index Out of Bounds");
+    return reinterpret_cast<fizx::real*>(particles.data());
+}
+
+template <typename Particle>
+auto fields(const std::vector<Particle>& particles, std::size_t first, std::size_t count)
+{
+    if (first > particles.size() || count > particles.size() - first) throw std::out_of_range("Index Out of Bounds");
+    return reinterpret_cast<const fizx::real*>(particles.data());
+}
+
+} // namespace
+
+uint32_t fizx_api_version(void)
+{
+    return FIZX_API_VERSION;
+}
+
+const char* fizx_last_error(void)
+{
+    return last_error.c_str();
+}
+
+fizx_status fizx_world_create(int dimension, fizx_world** world)
+{
+    return guard([&]()
+    {
+        if (!world) throw std::invalid_argument("Null world");
+        if (dimension != 2 && dimension != 3) throw std::invalid_argument("Dimension must be 2 or 3");
+        std::unique_ptr<fizx_world> created(new fizx_world{dimension, nullptr, nullptr});
+        if (dimension == 2) created->world2.reset(new fizx::ParticleWorld2D());
+        else created->world3.reset(new fizx::ParticleWorld());
+        *world = created.release();
+    });
+}
+
+void fizx_world_destroy(fizx_world* world)
+{
+    guard([&]() { delete world; });
+}
+
+int fizx_world_dimension(const fizx_world* world)
+{
+    return world ? world->dimension : 0;
+}
+
+size_t fizx_world_size(const fizx_world* world)
+{
+    size_t size = 0;
+    guard([&]() { visit(world, [&](const auto& w) { size = w.get_particles().size(); }); });
+    return size;
+}
+
+fizx_status fizx_world_resize(fizx_world* world, size_t count)
+{
+    return guard([&]() { visit(world, [&](auto& w) { w.get_particles().resize(count); }); });
+}
+
+fizx_status fizx_world_step(fizx_world* world, fizx_real duration)
+{
+    return guard([&]()
+    {
+        // The world only asserts this.
+        if (!(duration > 0)) throw std::domain_error("Duration must be positive");
+        visit(world, [&](auto& w) { w.step(duration); });
+    });
+}
+
+uint64_t fizx_world_frame(const fizx_world* world)
+{
+    uint64_t frame = 0;
+    guard([&]() { visit(world, [&](const auto& w) { frame = static_cast<uint64_t>(w.get_frame()); }); });
+    return frame;
+}
+
+size_t fizx_field_components(const fizx_world* world, fizx_field field)
+{
+    size_t count = 0;
+    guard([&]() { count = components(fizx_world_dimension(world), field); });
+    return count;
+}
+
+fizx_status fizx_world_read(const fizx_world* world, fizx_field field, size_t first, size_t count, fizx_real* out)
+{
+    return guard([&]()
+    {
+        visit(world, [&](const auto& w)
+        {
+            const fizx::real* data = fields(w.get_particles(), first, count);
+            if (!out && count > 0) throw std::invalid_argument("Null buffer");
+            const std::size_t stride = 4 * world->dimension + 2;
+            const std::size_t at = offset(world->dimension, field);
+            const std::size_t n = components(world->dimension, field);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::copy_n(data + (first + i) * stride + at, n, out + i * n);
+            }
+        });
+    });
+}
+
+fizx_status fizx_world_write(fizx_world* world, fizx_field field, size_t first, size_t count, const fizx_real* in)
+{
+    return guard([&]()
+    {
+        visit(world, [&](auto& w)
+        {
+            fizx::real* data = fields(w.get_particles(), first, count);
+            if (!in && count > 0) throw std::invalid_argument("Null buffer");
+            const std::size_t stride = 4 * world->dimension + 2;
+            const std::size_t at = offset(world->dimension, field);
+            const std::size_t n = components(world->dimension, field);
+            if (field == FIZX_FIELD_INVERSE_MASS || field == FIZX_FIELD_DAMPING)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (!(in[i] >= 0)) throw std::invalid_argument("Inverse mass and damping cannot be negative");
+                }
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::copy_n(in + i * n, n, data + (first + i) * stride + at);
+            }
+        });
+    });
+}
+
+fizx_real* fizx_world_data(fizx_world* world, size_t* stride)
+{
+    fizx_real* data = nullptr;
+    guard([&]()
+    {
+        visit(world, [&](auto& w) { data = fields(w.get_particles(), 0, 0); });
+        if (stride) *stride = 4 * world->dimension + 2;
+    });
+    return data;
+}
+
+size_t fizx_field_offset(const fizx_world* world, fizx_field field)
+{
+    size_t at = 0;
+    guard([&]() { at = offset(fizx_world_dimension(world), field); });
+    return at;
+}
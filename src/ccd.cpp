@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/ccd.hpp>
+
+template <fizx::size_t Dim>
+fizx::real fizx::time_of_impact(const Vector<real, Dim>& start, const Vector<real, Dim>& displacement,
+    const Vector<real, Dim>& other, real radius_sum)
+{
+    // Solve |d + displacement * s|^2 = radius_sum^2 for the first s in [0, 1].
+    const Vector<real, Dim> d = start - other;
+    const real b = d * displacement;
+    if (b >= 0) return -1; // Not approaching.
+    const real c = d * d - radius_sum * radius_sum;
+    if (c <= 0) return 0;
+    const real a = displacement * displacement;
+    const real discriminant = b * b - a * c;
+    if (discriminant < 0) return -1;
+    const real s = (-b - std::sqrt(discriminant)) / a;
+    return s <= 1 ? s : -1;
+}
+
+template <fizx::size_t Dim>
+fizx::BasicSweptIntegrator<Dim>::BasicSweptIntegrator(real radius, size_t max_substeps, real restitution)
+: radius(0), max_substeps(0), restitution(0), impact_count(0)
+{
+    set_radius(radius);
+    set_max_substeps(max_substeps);
+    set_restitution(restitution);
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicSweptIntegrator<Dim>::first_impact(const std::vector<particle_type>& particles, size_t index,
+    const vec_type& start, const vec_type& displacement, size_t& hit) const
+{
+    const real diameter = 2 * radius;
+    real first = 2;
+    auto test = [&](size_t j)
+    {
+        real s = time_of_impact<Dim>(start, displacement, particles[j].get_position(), diameter);
+        if (s >= 0 && s < first)
+        {
+            first = s;
+            hit = j;
+        }
+    };
+
+    // Only the slow particles whose x lies within reach of the sweep.
+    const real end_x = start[0] + displacement[0];
+    const real low = std::min(start[0], end_x) - diameter;
+    const real high = std::max(start[0], end_x) + diameter;
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), low,
+        [](const std::pair<real, size_t>& entry, real x) { return entry.first < x; });
+    for (; it != sorted.end() && it->first <= high; ++it)
+    {
+        test(it->second);
+    }
+    for (size_t j : fast)
+    {
+        if (j != index) test(j);
+    }
+    return first <= 1 ? first : -1;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSweptIntegrator<Dim>::integrate(std::vector<particle_type>& particles, real duration)
+{
+    const size_t count = static_cast<size_t>(particles.size());
+    impact_count = 0;
+
+    // Pick the particles to sweep before moving anything, from the speed they will move at.
+    fast.clear();
+    starts.clear();
+    swept.assign(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const particle_type& p = particles[i];
+        if (!p.has_finite_mass()) continue;
+        vec_type velocity = p.get_velocity();
+        bool flagged = i < static_cast<size_t>(flags.size()) && flags[i];
+        if (flagged || velocity * velocity * duration * duration > radius * radius)
+        {
+            fast.push_back(i);
+            starts.push_back(p.get_position());
+            swept[i] = 1;
+        }
+    }
+
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        particle_type::integrate_batch(particles.data() + begin, end - begin, duration);
+    }, 256);
+    if (fast.empty()) return;
+
+    sorted.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!swept[i]) sorted.emplace_back(particles[i].get_position()[0], i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t k = 0; k < static_cast<size_t>(fast.size()); ++k)
+    {
+        const size_t i = fast[k];
+        particle_type& p = particles[i];
+        vec_type start = starts[k];
+        vec_type end = p.get_position();
+        vec_type velocity = p.get_velocity();
+        real remaining = duration;
+
+        for (size_t substep = 0; ; ++substep)
+        {
+            size_t hit = 0;
+            const vec_type displacement = end - start;
+            const real s = first_impact(particles, i, start, displacement, hit);
+            if (s < 0) break;
+
+            const vec_type contact = start + displacement * s;
+            if (substep == max_substeps)
+            {
+                // Out of sub-steps, stop at the impact rather than pass through.
+                end = contact;
+                break;
+            }
+
+            // Bounce off the particle hit, exchanging momentum along the line of centres.
+            particle_type& other = particles[hit];
+            vec_type normal = contact - other.get_position();
+            normal.normalize();
+            vec_type other_velocity = other.get_velocity();
+            const real approach = (velocity - other_velocity) * normal;
+            if (approach < 0)
+            {
+                const real impulse = -(1 + restitution) * approach / (p.get_inverse_mass() + other.get_inverse_mass());
+                velocity += normal * (impulse * p.get_inverse_mass());
+                if (other.has_finite_mass())
+                {
+                    other_velocity -= normal * (impulse * other.get_inverse_mass());
+                    other.set_velocity(other_velocity);
+                }
+            }
+            ++impact_count;
+
+            remaining *= 1 - s;
+            start = contact;
+            end = contact + velocity * remaining;
+        }
+
+        p.set_position(end);
+        p.set_velocity(velocity);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSweptIntegrator<Dim>::set_fast(size_t index, bool fast)
+{
+    if (index < 0) throw std::runtime_error("Index Out of Bounds");
+    if (index >= static_cast<size_t>(flags.size())) flags.resize(index + 1, 0);
+    flags[index] = fast;
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicSweptIntegrator<Dim>::is_fast(size_t index) const
+{
+    return index >= 0 && index < static_cast<size_t>(flags.size()) && flags[index];
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSweptIntegrator<Dim>::set_radius(real radius)
+{
+    if (radius <= 0) throw std::domain_error("Radius must be positive");
+    this->radius = radius;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSweptIntegrator<Dim>::set_max_substeps(size_t max_substeps)
+{
+    if (max_substeps < 1) throw std::domain_error("Sub-steps must be at least one");
+    this->max_substeps = max_substeps;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSweptIntegrator<Dim>::set_restitution(real restitution)
+{
+    if (restitution < 0 || restitution > 1) throw std::domain_error("Restitution must be in [0, 1]");
+    this->restitution = restitution;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicSweptIntegrator<Dim>::get_swept_count() const
+{
+    return static_cast<size_t>(fast.size());
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicSweptIntegrator<Dim>::get_impact_count() const
+{
+    return impact_count;
+}
+
+template fizx::real fizx::time_of_impact<2>(const Vector<real, 2>&, const Vector<real, 2>&, const Vector<real, 2>&, real);
+template fizx::real fizx::time_of_impact<3>(const Vector<real, 3>&, const Vector<real, 3>&, const Vector<real, 3>&, real);
+template class fizx::BasicSweptIntegrator<2>;
+template class fizx::BasicSweptIntegrator<3>;
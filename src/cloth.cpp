@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/cloth.hpp>
+
+namespace
+{
+
+/**
+ * Position of entry (r, c) of a symmetric block stored as its upper triangle, row by row.
+*/
+template <fizx::size_t Dim>
+constexpr fizx::size_t packed(fizx::size_t r, fizx::size_t c)
+{
+    return r <= c ? r * Dim - r * (r - 1) / 2 + c - r : packed<Dim>(c, r);
+}
+
+} // namespace
+
+template <fizx::size_t Dim>
+fizx::BasicCloth<Dim>::BasicCloth(real damping)
+: damping(0), tolerance(1e-6), max_iterations(200), iterations(0), residual(0)
+{
+    static_assert(sizeof(particle_type) == (4 * Dim + 2) * sizeof(real), "Particle must be packed reals");
+    set_damping(damping);
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicCloth<Dim>::add_spring(size_t first, size_t second, real stiffness, real rest_length)
+{
+    if (!offsets.empty()) throw std::logic_error("Springs are fixed once the cloth has been stepped");
+    if (first < 0 || second < 0 || first == second) throw std::invalid_argument("A spring joins two particles");
+    if (stiffness < 0 || rest_length < 0) throw std::domain_error("Stiffness and rest length cannot be negative");
+    springs.push_back({first, second, rest_length, stiffness});
+    return static_cast<size_t>(springs.size()) - 1;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicCloth<Dim>::add_spring(const std::vector<particle_type>& particles, size_t first,
+    size_t second, real stiffness)
+{
+    if (first >= static_cast<size_t>(particles.size()) || second >= static_cast<size_t>(particles.size()))
+        throw std::runtime_error("Index Out of Bounds");
+    return add_spring(first, second, stiffness,
+        (particles[first].get_position() - particles[second].get_position()).magnitude());
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::build(size_t particle_count)
+{
+    // Count the springs of every particle, then fill them in.
+    offsets.assign(particle_count + 1, 0);
+    for (const Spring& spring : springs)
+    {
+        if (spring.first >= particle_count || spring.second >= particle_count)
+        {
+            offsets.clear();
+            throw std::runtime_error("Index Out of Bounds");
+        }
+        ++offsets[spring.first + 1];
+        ++offsets[spring.second + 1];
+    }
+    for (size_t i = 0; i < particle_count; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    incident.resize(offsets[particle_count]);
+    neighbours.resize(offsets[particle_count]);
+    index_list fill(offsets.begin(), offsets.end() - 1);
+    for (size_t s = 0; s < static_cast<size_t>(springs.size()); ++s)
+    {
+        neighbours[fill[springs[s].first]] = springs[s].second;
+        incident[fill[springs[s].first]++] = s;
+        neighbours[fill[springs[s].second]] = springs[s].first;
+        incident[fill[springs[s].second]++] = s;
+    }
+
+    solution.assign(particle_count * Dim, 0);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::multiply(const real_list& vector, real_list& result) const
+{
+    const size_t count = static_cast<size_t>(offsets.size()) - 1;
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            real* out = result.data() + i * Dim;
+            if (masses[i] == 0)
+            {
+                for (size_t d = 0; d < Dim; ++d) out[d] = 0;
+                continue;
+            }
+            const real* own = vector.data() + i * Dim;
+            real sum[Dim];
+            for (size_t d = 0; d < Dim; ++d) sum[d] = masses[i] * own[d];
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+            {
+                const real* theirs = vector.data() + neighbours[k] * Dim;
+                const real* block = blocks.data() + static_cast<std::size_t>(incident[k]) * BLOCK;
+                real relative[Dim];
+                for (size_t d = 0; d < Dim; ++d) relative[d] = own[d] - theirs[d];
+                std::size_t e = 0;
+                for (size_t r = 0; r < Dim; ++r)
+                {
+                    sum[r] += block[e++] * relative[r];
+                    for (size_t c = r + 1; c < Dim; ++c, ++e)
+                    {
+                        sum[r] += block[e] * relative[c];
+                        sum[c] += block[e] * relative[r];
+                    }
+                }
+            }
+            for (size_t d = 0; d < Dim; ++d) out[d] = sum[d];
+        }
+    }, 512);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::solve()
+{
+    const std::size_t n = solution.size();
+    auto dot = [n](const real_list& a, const real_list& b)
+    {
+        real sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+        return sum;
+    };
+
+    const real rhs_squared = dot(rhs, rhs);
+    iterations = 0;
+    if (rhs_squared == 0)
+    {
+        std::fill(solution.begin(), solution.end(), 0);
+        residual = 0;
+        return;
+    }
+    const real limit = tolerance * tolerance * rhs_squared;
+
+    // r = b - A x from the last solution, pinned entries stay zero.
+    multiply(solution, product);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        residuals[i] = rhs[i] - product[i];
+        preconditioned[i] = preconditioner[i] * residuals[i];
+        direction[i] = preconditioned[i];
+    }
+    real rz = dot(residuals, preconditioned);
+    real rr = dot(residuals, residuals);
+
+    while (rr > limit && iterations < max_iterations)
+    {
+        multiply(direction, product);
+        const real curvature = dot(direction, product);
+        if (!(curvature > 0)) break;
+        const real alpha = rz / curvature;
+        real next = 0;
+        rr = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            solution[i] += alpha * direction[i];
+            residuals[i] -= alpha * product[i];
+            preconditioned[i] = preconditioner[i] * residuals[i];
+            next += residuals[i] * preconditioned[i];
+            rr += residuals[i] * residuals[i];
+        }
+        const real beta = next / rz;
+        rz = next;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            direction[i] = preconditioned[i] + beta * direction[i];
+        }
+        ++iterations;
+    }
+    residual = std::sqrt(rr / rhs_squared);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::step(std::vector<particle_type>& particles, real duration)
+{
+    if (duration <= 0) throw std::domain_error("Duration must be positive");
+
+    const size_t count = static_cast<size_t>(particles.size());
+    if (static_cast<size_t>(offsets.size()) != count + 1) build(count);
+    const std::size_t n = static_cast<std::size_t>(count) * Dim;
+    const size_t spring_total = static_cast<size_t>(springs.size());
+    const real h = duration;
+
+    // Gather the state from the packed particle fields.
+    constexpr std::size_t STRIDE = 4 * Dim + 2;
+    real* fields = reinterpret_cast<real*>(particles.data());
+    positions.resize(n);
+    velocities.resize(n);
+    masses.resize(count);
+    rhs.resize(n);
+    preconditioner.resize(n);
+    residuals.resize(n);
+    preconditioned.resize(n);
+    direction.resize(n);
+    product.resize(n);
+    blocks.resize(static_cast<std::size_t>(spring_total) * BLOCK);
+    spring_forces.resize(static_cast<std::size_t>(spring_total) * Dim);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const real* p = fields + i * STRIDE;
+        const real inverse_mass = p[3 * Dim + 1];
+        masses[i] = inverse_mass > 0 ? 1 / inverse_mass : 0;
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            positions[i * Dim + d] = p[d];
+            velocities[i * Dim + d] = p[Dim + d];
+        }
+    }
+
+    // Linearise every spring: its block h * D + h^2 * K, and its force on the first end less
+    // h * K times the relative velocity.
+    parallel_for(spring_total, [&](size_t begin, size_t end)
+    {
+        for (size_t s = begin; s < end; ++s)
+        {
+            const Spring& spring = springs[s];
+            real delta[Dim], speed[Dim], length_squared = 0;
+            for (size_t d = 0; d < Dim; ++d)
+            {
+                delta[d] = positions[spring.first * Dim + d] - positions[spring.second * Dim + d];
+                speed[d] = velocities[spring.first * Dim + d] - velocities[spring.second * Dim + d];
+                length_squared += delta[d] * delta[d];
+            }
+            const real length = std::sqrt(length_squared);
+            real axis[Dim] = {};
+            real closing = 0;
+            if (length > 0)
+            {
+                for (size_t d = 0; d < Dim; ++d)
+                {
+                    axis[d] = delta[d] / length;
+                    closing += axis[d] * speed[d];
+                }
+            }
+
+            // Stiffness along the spring, and across it while stretched; a compressed spring would
+            // make K indefinite across it, so that part is dropped.
+            const real k = spring.stiffness;
+            const real across = length > spring.rest_length ? k * (1 - spring.rest_length / length) : 0;
+            real* block = blocks.data() + static_cast<std::size_t>(s) * BLOCK;
+            real stiff[Dim * Dim];
+            for (size_t r = 0; r < Dim; ++r)
+            {
+                for (size_t c = 0; c < Dim; ++c)
+                {
+                    const real outer = axis[r] * axis[c];
+                    stiff[r * Dim + c] = k * outer + across * ((r == c ? 1 : 0) - outer);
+                    if (c >= r) block[packed<Dim>(r, c)] = h * h * stiff[r * Dim + c] + h * damping * outer;
+                }
+            }
+
+            real* force = spring_forces.data() + static_cast<std::size_t>(s) * Dim;
+            const real pull = -k * (length - spring.rest_length) - damping * closing;
+            for (size_t r = 0; r < Dim; ++r)
+            {
+                real correction = 0;
+                for (size_t c = 0; c < Dim; ++c) correction += stiff[r * Dim + c] * speed[c];
+                force[r] = pull * axis[r] - h * correction;
+            }
+        }
+    }, 1024);
+
+    // Right hand side h * f and the diagonal preconditioner, gathered per particle.
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            real* b = rhs.data() + i * Dim;
+            real* diagonal = preconditioner.data() + i * Dim;
+            if (masses[i] == 0)
+            {
+                for (size_t d = 0; d < Dim; ++d) b[d] = diagonal[d] = solution[i * Dim + d] = 0;
+                continue;
+            }
+            const real* p = fields + i * STRIDE;
+            real sum[Dim], weight[Dim];
+            for (size_t d = 0; d < Dim; ++d)
+            {
+                sum[d] = p[3 * Dim + 2 + d] + masses[i] * p[2 * Dim + d];
+                weight[d] = masses[i];
+            }
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+            {
+                const size_t s = incident[k];
+                const real sign = springs[s].first == i ? 1 : -1;
+                const real* force = spring_forces.data() + static_cast<std::size_t>(s) * Dim;
+                const real* block = blocks.data() + static_cast<std::size_t>(s) * BLOCK;
+                for (size_t d = 0; d < Dim; ++d)
+                {
+                    sum[d] += sign * force[d];
+                    weight[d] += block[packed<Dim>(d, d)];
+                }
+            }
+            for (size_t d = 0; d < Dim; ++d)
+            {
+                b[d] = h * sum[d];
+                diagonal[d] = 1 / weight[d];
+            }
+        }
+    }, 512);
+
+    solve();
+
+    // Backward Euler: the new velocity, then the position moved by it.
+    for (size_t i = 0; i < count; ++i)
+    {
+        real* p = fields + i * STRIDE;
+        if (masses[i] == 0) continue;
+        const real drag = p[3 * Dim] == 1 ? 1 : std::pow(p[3 * Dim], h);
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            p[Dim + d] = (p[Dim + d] + solution[i * Dim + d]) * drag;
+            p[d] += h * p[Dim + d];
+            p[3 * Dim + 2 + d] = 0;
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::set_damping(real damping)
+{
+    if (damping < 0) throw std::domain_error("Damping cannot be negative");
+    this->damping = damping;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::set_tolerance(real tolerance)
+{
+    if (tolerance <= 0) throw std::domain_error("Tolerance must be positive");
+    this->tolerance = tolerance;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCloth<Dim>::set_max_iterations(size_t iterations)
+{
+    if (iterations < 0) throw std::domain_error("Iterations cannot be negative");
+    max_iterations = iterations;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicCloth<Dim>::get_damping() const
+{
+    return damping;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicCloth<Dim>::get_tolerance() const
+{
+    return tolerance;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicCloth<Dim>::get_max_iterations() const
+{
+    return max_iterations;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicCloth<Dim>::get_iterations() const
+{
+    return iterations;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicCloth<Dim>::get_residual() const
+{
+    return residual;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicCloth<Dim>::Spring& fizx::BasicCloth<Dim>::get_spring(size_t index) const
+{
+    if (index < 0 || index >= static_cast<size_t>(springs.size())) throw std::runtime_error("Index Out of Bounds");
+    return springs[index];
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicCloth<Dim>::spring_count() const
+{
+    return static_cast<size_t>(springs.size());
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicCloth<Dim>::index_list& fizx::BasicCloth<Dim>::get_offsets() const
+{
+    return offsets;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicCloth<Dim>::index_list& fizx::BasicCloth<Dim>::get_incident() const
+{
+    return incident;
+}
+
+template class fizx::BasicCloth<2>;
+template class fizx::BasicCloth<3>;
@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/collider.hpp>
+
+namespace
+{
+using fizx::real;
+using fizx::vec3f;
+
+vec3f component_min(const vec3f& a, const vec3f& b)
+{
+    return vec3f(std::min(a.x(), b.x()), std::min(a.y(), b.y()), std::min(a.z(), b.z()));
+}
+
+vec3f component_max(const vec3f& a, const vec3f& b)
+{
+    return vec3f(std::max(a.x(), b.x()), std::max(a.y(), b.y()), std::max(a.z(), b.z()));
+}
+
+/**
+ * Squared distance from a point to a box, 0 inside.
+*/
+real square_distance_to_box(const vec3f& point, const vec3f& lower, const vec3f& upper)
+{
+    real sum = 0;
+    for (int d = 0; d < 3; ++d)
+    {
+        const real below = lower[d] - point[d];
+        const real above = point[d] - upper[d];
+        const real outside = std::max<real>(0, std::max(below, above));
+        sum += outside * outside;
+    }
+    return sum;
+}
+
+/**
+ * Closest point of triangle abc to p, by the Voronoi regions of its vertices and edges.
+*/
+vec3f closest_on_triangle(const vec3f& p, const vec3f& a, const vec3f& b, const vec3f& c)
+{
+    const vec3f ab = b - a, ac = c - a, ap = p - a;
+    const real d1 = ab * ap, d2 = ac * ap;
+    if (d1 <= 0 && d2 <= 0) return a;
+
+    const vec3f bp = p - b;
+    const real d3 = ab * bp, d4 = ac * bp;
+    if (d3 >= 0 && d4 <= d3) return b;
+
+    const real vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+    const vec3f cp = p - c;
+    const real d5 = ab * cp, d6 = ac * cp;
+    if (d6 >= 0 && d5 <= d6) return c;
+
+    const real vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+    const real va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const real denominator = 1 / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+/**
+ * Unit normal of a triangle, pointing up (positive y) for heightfield cells.
+*/
+vec3f upward_normal(const vec3f& a, const vec3f& b, const vec3f& c)
+{
+    vec3f normal = (b - a).cross(c - a);
+    if (normal.y() < 0) normal *= -1;
+    normal.normalize();
+    return normal;
+}
+
+} // namespace
+
+fizx::StaticColliders::StaticColliders(real radius, real restitution)
+: radius(0), restitution(0)
+{
+    set_radius(radius);
+    set_restitution(restitution);
+}
+
+std::size_t fizx::StaticColliders::add_plane(const vec3f& normal, real offset)
+{
+    const real length = normal.magnitude();
+    if (!(length > 0)) throw std::domain_error("Plane normal cannot be zero");
+    Collider plane{};
+    plane.kind = Kind::plane;
+    plane.a = normal * (1 / length);
+    plane.offset = offset / length;
+    colliders.push_back(plane);
+    return colliders.size() - 1;
+}
+
+std::size_t fizx::StaticColliders::add_box(const vec3f& lower, const vec3f& upper)
+{
+    if (lower.x() > upper.x() || lower.y() > upper.y() || lower.z() > upper.z())
+        throw std::domain_error("Box lower corner must be below its upper corner");
+    Collider box{};
+    box.kind = Kind::box;
+    box.a = lower;
+    box.b = upper;
+    colliders.push_back(box);
+    return colliders.size() - 1;
+}
+
+std::size_t fizx::StaticColliders::add_heightfield(const vec3f& origin, real cell_x, real cell_z, std::size_t columns,
+    std::size_t rows, const std::vector<real>& heights)
+{
+    if (!(cell_x > 0) || !(cell_z > 0)) throw std::domain_error("Heightfield cells must have a positive size");
+    if (columns < 2 || rows < 2) throw std::invalid_argument("A heightfield needs at least 2 x 2 samples");
+    if (heights.size() != columns * rows) throw std::invalid_argument("Heightfield needs columns * rows heights");
+
+    Collider field{};
+    field.kind = Kind::heightfield;
+    field.a = origin;
+    field.b = vec3f(cell_x, 0, cell_z);
+    field.first = static_cast<std::uint32_t>(this->heights.size());
+    field.cells = static_cast<std::uint32_t>(cell_normals.size());
+    field.columns = static_cast<std::uint32_t>(columns);
+    field.rows = static_cast<std::uint32_t>(rows);
+    this->heights.insert(this->heights.end(), heights.begin(), heights.end());
+
+    // Two triangles per cell, split along the diagonal from sample (i, j) to (i + 1, j + 1).
+    for (std::size_t j = 0; j + 1 < rows; ++j)
+    {
+        for (std::size_t i = 0; i + 1 < columns; ++i)
+        {
+            const vec3f p00(0, heights[j * columns + i], 0);
+            const vec3f p10(cell_x, heights[j * columns + i + 1], 0);
+            const vec3f p01(0, heights[(j + 1) * columns + i], cell_z);
+            const vec3f p11(cell_x, heights[(j + 1) * columns + i + 1], cell_z);
+            cell_normals.push_back(upward_normal(p00, p10, p11));
+            cell_normals.push_back(upward_normal(p00, p11, p01));
+        }
+    }
+    colliders.push_back(field);
+    return colliders.size() - 1;
+}
+
+std::size_t fizx::StaticColliders::add_mesh(const std::vector<vec3f>& vertices, const std::vector<std::uint32_t>& indices)
+{
+    if (indices.empty() || indices.size() % 3 != 0) throw std::invalid_argument("A mesh needs three indices per triangle");
+
+    tracked_vector<Triangle, Subsystem::scratch> source(indices.size() / 3);
+    tracked_vector<vec3f, Subsystem::scratch> centres(source.size());
+    for (std::size_t t = 0; t < source.size(); ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            if (indices[3 * t + k] >= vertices.size()) throw std::runtime_error("Index Out of Bounds");
+        }
+        Triangle& triangle = source[t];
+        triangle.a = vertices[indices[3 * t]];
+        triangle.b = vertices[indices[3 * t + 1]];
+        triangle.c = vertices[indices[3 * t + 2]];
+        triangle.normal = (triangle.b - triangle.a).cross(triangle.c - triangle.a).unit();
+        centres[t] = (triangle.a + triangle.b + triangle.c) * (1.0 / 3);
+    }
+
+    tracked_vector<std::uint32_t, Subsystem::scratch> order(source.size());
+    for (std::size_t t = 0; t < order.size(); ++t) order[t] = static_cast<std::uint32_t>(t);
+
+    Collider mesh{};
+    mesh.kind = Kind::mesh;
+    const std::uint32_t base = static_cast<std::uint32_t>(triangles.size());
+    mesh.first = build(source, centres, order, 0, static_cast<std::uint32_t>(order.size()), base);
+    for (std::uint32_t t : order) triangles.push_back(source[t]);
+    colliders.push_back(mesh);
+    return colliders.size() - 1;
+}
+
+std::uint32_t fizx::StaticColliders::build(const tracked_vector<Triangle, Subsystem::scratch>& source,
+    const tracked_vector<vec3f, Subsystem::scratch>& centres, tracked_vector<std::uint32_t, Subsystem::scratch>& order,
+    std::uint32_t begin, std::uint32_t end, std::uint32_t base)
+{
+    Node node;
+    node.lower = node.upper = source[order[begin]].a;
+    vec3f centre_lower = centres[order[begin]], centre_upper = centre_lower;
+    for (std::uint32_t k = begin; k < end; ++k)
+    {
+        const Triangle& triangle = source[order[k]];
+        node.lower = component_min(node.lower, component_min(triangle.a, component_min(triangle.b, triangle.c)));
+        node.upper = component_max(node.upper, component_max(triangle.a, component_max(triangle.b, triangle.c)));
+        centre_lower = component_min(centre_lower, centres[order[k]]);
+        centre_upper = component_max(centre_upper, centres[order[k]]);
+    }
+
+    const std::uint32_t index = static_cast<std::uint32_t>(nodes.size());
+    if (end - begin <= LEAF_SIZE)
+    {
+        node.first = base + begin;
+        node.count = end - begin;
+        nodes.push_back(node);
+        return index;
+    }
+
+    // Median split of the centres along the widest axis.
+    const vec3f extent = centre_upper - centre_lower;
+    const int axis = extent.x() >= extent.y() && extent.x() >= extent.z() ? 0 : (extent.y() >= extent.z() ? 1 : 2);
+    const std::uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+        [&](std::uint32_t a, std::uint32_t b) { return centres[a][axis] < centres[b][axis]; });
+
+    node.count = 0;
+    nodes.push_back(node);
+    build(source, centres, order, begin, middle, base);
+    nodes[index].first = build(source, centres, order, middle, end, base);
+    return index;
+}
+
+bool fizx::StaticColliders::touch_heightfield(const Collider& field, const vec3f& centre, StaticContact& contact) const
+{
+    const real x = (centre.x() - field.a.x()) / field.b.x();
+    const real z = (centre.z() - field.a.z()) / field.b.z();
+    if (!(x >= 0 && z >= 0 && x <= field.columns - 1 && z <= field.rows - 1)) return false;
+
+    const std::uint32_t i = std::min(static_cast<std::uint32_t>(x), field.columns - 2);
+    const std::uint32_t j = std::min(static_cast<std::uint32_t>(z), field.rows - 2);
+    const real fx = x - i, fz = z - j;
+    const real* row = heights.data() + field.first + j * field.columns + i;
+    const real h00 = row[0], h10 = row[1], h01 = row[field.columns], h11 = row[field.columns + 1];
+    const bool lower = fx >= fz;
+    const real height = lower ? h00 + fx * (h10 - h00) + fz * (h11 - h10) : h00 + fx * (h11 - h01) + fz * (h01 - h00);
+    const vec3f& normal = cell_normals[field.cells + 2 * (j * (field.columns - 1) + i) + (lower ? 0 : 1)];
+
+    // Distance to the plane of the triangle under the centre; below the surface is inside.
+    const real distance = (centre.y() - field.a.y() - height) * normal.y();
+    if (distance >= radius) return false;
+    contact.point = centre - normal * distance;
+    contact.normal = normal;
+    contact.depth = radius - distance;
+    return true;
+}
+
+bool fizx::StaticColliders::touch_mesh(const Collider& mesh, const vec3f& centre, StaticContact& contact) const
+{
+    real best = radius * radius;
+    const Triangle* closest = nullptr;
+    vec3f point;
+
+    std::uint32_t stack[64];
+    int top = 0;
+    stack[top++] = mesh.first;
+    while (top > 0)
+    {
+        const Node& node = nodes[stack[--top]];
+        if (square_distance_to_box(centre, node.lower, node.upper) >= best) continue;
+        if (node.count == 0)
+        {
+            const std::uint32_t index = static_cast<std::uint32_t>(&node - nodes.data());
+            stack[top++] = node.first;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (std::uint32_t t = node.first; t < node.first + node.count; ++t)
+        {
+            const Triangle& triangle = triangles[t];
+            const vec3f candidate = closest_on_triangle(centre, triangle.a, triangle.b, triangle.c);
+            const real distance = centre.square_distance(candidate);
+            if (distance < best)
+            {
+                best = distance;
+                closest = &triangle;
+                point = candidate;
+            }
+        }
+    }
+    if (!closest) return false;
+
+    const real distance = std::sqrt(best);
+    contact.point = point;
+    if (distance > 0)
+    {
+        contact.normal = (centre - point) * (1 / distance);
+    }
+    else
+    {
+        contact.normal = closest->normal;
+    }
+    contact.depth = radius - distance;
+    return true;
+}
+
+void fizx::StaticColliders::collide(const vec3f& centre, std::uint32_t particle, contact_list& contacts) const
+{
+    for (std::size_t c = 0; c < colliders.size(); ++c)
+    {
+        const Collider& collider = colliders[c];
+        StaticContact contact;
+        contact.particle = particle;
+        contact.collider = static_cast<std::uint32_t>(c);
+        bool touching = false;
+        switch (collider.kind)
+        {
+        case Kind::plane:
+        {
+            const real distance = collider.a * centre - collider.offset;
+            if (distance < radius)
+            {
+                contact.point = centre - collider.a * distance;
+                contact.normal = collider.a;
+                contact.depth = radius - distance;
+                touching = true;
+            }
+            break;
+        }
+        case Kind::box:
+        {
+            const vec3f clamped = component_max(collider.a, component_min(centre, collider.b));
+            const vec3f outside = centre - clamped;
+            const real square = outside * outside;
+            if (square > 0)
+            {
+                if (square < radius * radius)
+                {
+                    const real distance = std::sqrt(square);
+                    contact.point = clamped;
+                    contact.normal = outside * (1 / distance);
+                    contact.depth = radius - distance;
+                    touching = true;
+                }
+                break;
+            }
+            // Centre inside, leave through the nearest face.
+            real nearest = collider.b.x() - centre.x();
+            contact.normal = vec3f(1, 0, 0);
+            for (int d = 0; d < 3; ++d)
+            {
+                const real below = centre[d] - collider.a[d];
+                const real above = collider.b[d] - centre[d];
+                vec3f axis;
+                axis[d] = 1;
+                if (below < nearest) { nearest = below; contact.normal = axis * -1; }
+                if (above < nearest) { nearest = above; contact.normal = axis; }
+            }
+            contact.point = centre + contact.normal * nearest;
+            contact.depth = radius + nearest;
+            touching = true;
+            break;
+        }
+        case Kind::heightfield:
+            touching = touch_heightfield(collider, centre, contact);
+            break;
+        case Kind::mesh:
+            touching = touch_mesh(collider, centre, contact);
+            break;
+        }
+        if (touching) contacts.push_back(contact);
+    }
+}
+
+void fizx::StaticColliders::query(const std::vector<Particle>& particles, std::vector<StaticContact>& contacts) const
+{
+    // Fixed blocks, each with its own list, joined in order so the result never depends on threads.
+    // A block is already a thousand particles, so each one is worth a task.
+    constexpr std::size_t block = 1024;
+    const std::size_t blocks = (particles.size() + block - 1) / block;
+    std::vector<contact_list> found(blocks);
+    parallel_for(static_cast<size_t>(blocks), [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const std::size_t last = std::min(particles.size(), (b + 1) * block);
+            for (std::size_t i = b * block; i < last; ++i)
+            {
+                collide(particles[i].get_position(), static_cast<std::uint32_t>(i), found[b]);
+            }
+        }
+    }, 1);
+    contacts.clear();
+    for (const contact_list& list : found) contacts.insert(contacts.end(), list.begin(), list.end());
+}
+
+void fizx::StaticColliders::resolve(std::vector<Particle>& particles, real)
+{
+    parallel_for(static_cast<size_t>(particles.size()), [&](size_t begin, size_t end)
+    {
+        contact_list contacts;
+        for (size_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+            if (particle.get_inverse_mass() <= 0) continue;
+            contacts.clear();
+            collide(particle.get_position(), static_cast<std::uint32_t>(i), contacts);
+            if (contacts.empty()) continue;
+
+            // Every depth is measured from the same centre, so summing the pushes would move the
+            // particle out of overlapping colliders once per collider. Push out of the deepest,
+            // then look again from there.
+            vec3f position = particle.get_position();
+            vec3f velocity = particle.get_velocity();
+            for (int pass = 0; pass < RESOLVE_PASSES && !contacts.empty(); ++pass)
+            {
+                const StaticContact* deepest = &contacts[0];
+                for (const StaticContact& contact : contacts)
+                {
+                    if (contact.depth > deepest->depth) deepest = &contact;
+                }
+                position += deepest->normal * deepest->depth;
+                const real approach = velocity * deepest->normal;
+                if (approach < 0) velocity += deepest->normal * (-(1 + restitution) * approach);
+                contacts.clear();
+                collide(position, static_cast<std::uint32_t>(i), contacts);
+            }
+            particle.set_position(position);
+            particle.set_velocity(velocity);
+        }
+    }, 256);
+}
+
+void fizx::StaticColliders::set_radius(real radius)
+{
+    if (radius < 0) throw std::domain_error("Radius cannot be negative");
+    this->radius = radius;
+}
+
+void fizx::StaticColliders::set_restitution(real restitution)
+{
+    if (restitution < 0 || restitution > 1) throw std::domain_error("Restitution must be in [0, 1]");
+    this->restitution = restitution;
+}
+
+std::size_t fizx::StaticColliders::collider_count() const
+{
+    return colliders.size();
+}
+
+const fizx::StaticColliders::node_list& fizx::StaticColliders::get_nodes() const
+{
+    return nodes;
+}
+
+std::size_t fizx::StaticColliders::triangle_count() const
+{
+    return triangles.size();
+}
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/contact.hpp>
+
+namespace
+{
+
+fizx::ContactCache::Contact empty_contact()
+{
+    return {fizx::ContactCache::EMPTY, fizx::ContactCache::EMPTY, 0, 0};
+}
+
+} // namespace
+
+fizx::ContactCache::ContactCache(std::size_t capacity)
+: count(0), stamp(0)
+{
+    std::size_t size = 16;
+    while (size < 2 * capacity) size <<= 1;
+    slots.assign(size, empty_contact());
+    spare.assign(size, empty_contact());
+}
+
+std::size_t fizx::ContactCache::probe(std::uint32_t a, std::uint32_t b) const
+{
+    const std::size_t mask = slots.size() - 1;
+    std::uint64_t key = (static_cast<std::uint64_t>(a) << 32) | b;
+    std::size_t slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (slots[slot].a != EMPTY && (slots[slot].a != a || slots[slot].b != b))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void fizx::ContactCache::rehash(std::size_t capacity)
+{
+    spare.assign(capacity, empty_contact());
+    spare.swap(slots);
+    for (const Contact& contact : spare)
+    {
+        if (contact.a == EMPTY) continue;
+        slots[probe(contact.a, contact.b)] = contact;
+    }
+}
+
+void fizx::ContactCache::reserve(std::size_t additional)
+{
+    // Kept at most half full, so probe sequences stay short.
+    std::size_t size = slots.size();
+    while (2 * (count + additional) > size) size <<= 1;
+    if (size != slots.size()) rehash(size);
+}
+
+std::size_t fizx::ContactCache::touch(std::uint32_t a, std::uint32_t b)
+{
+    if (a > b) std::swap(a, b);
+    if (a == b) throw std::invalid_argument("A particle cannot touch itself");
+
+    std::size_t slot = probe(a, b);
+    if (slots[slot].a == EMPTY)
+    {
+        if (2 * (count + 1) > slots.size())
+        {
+            rehash(2 * slots.size());
+            slot = probe(a, b);
+        }
+        slots[slot] = {a, b, 0, stamp};
+        ++count;
+    }
+    slots[slot].stamp = stamp;
+    return slot;
+}
+
+const fizx::ContactCache::Contact* fizx::ContactCache::find(std::uint32_t a, std::uint32_t b) const
+{
+    if (a > b) std::swap(a, b);
+    std::size_t slot = probe(a, b);
+    return slots[slot].a == EMPTY ? nullptr : &slots[slot];
+}
+
+fizx::ContactCache::Contact& fizx::ContactCache::operator[](std::size_t slot)
+{
+    if (slot >= slots.size()) throw std::runtime_error("Index Out of Bounds");
+    return slots[slot];
+}
+
+const fizx::ContactCache::Contact& fizx::ContactCache::operator[](std::size_t slot) const
+{
+    if (slot >= slots.size()) throw std::runtime_error("Index Out of Bounds");
+    return slots[slot];
+}
+
+std::size_t fizx::ContactCache::evict()
+{
+    // Moving the live contacts to a clean table avoids tombstones and keeps probes short.
+    spare.assign(slots.size(), empty_contact());
+    spare.swap(slots);
+    std::size_t removed = count;
+    count = 0;
+    for (const Contact& contact : spare)
+    {
+        if (contact.a == EMPTY || contact.stamp != stamp) continue;
+        slots[probe(contact.a, contact.b)] = contact;
+        ++count;
+    }
+    ++stamp;
+    return removed - count;
+}
+
+void fizx::ContactCache::clear()
+{
+    std::fill(slots.begin(), slots.end(), empty_contact());
+    count = 0;
+}
+
+std::size_t fizx::ContactCache::size() const
+{
+    return count;
+}
+
+std::size_t fizx::ContactCache::capacity() const
+{
+    return slots.size() / 2;
+}
+
+template <fizx::size_t Dim>
+fizx::BasicContactSolver<Dim>::BasicContactSolver(real radius, size_t iterations)
+: radius(radius), iterations(iterations), warm_starting(true), bias_factor(0.2), slop(0.01 * radius),
+  neighbours(2 * radius, 0.5 * radius)
+{
+    if (radius <= 0) throw std::domain_error("Radius must be positive");
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicContactSolver<Dim>::solve(std::vector<particle_type>& particles, real duration)
+{
+    const size_t count = static_cast<size_t>(particles.size());
+    neighbours.update(particles);
+    const auto& offsets = neighbours.get_offsets();
+    const auto& indices = neighbours.get_indices();
+
+    // Touch every contact first, so the slots stay put while the rows refer to them.
+    cache.reserve(indices.size() / 2);
+    rows.clear();
+    velocities.resize(count);
+    inverse_masses.resize(count);
+    const real diameter = 2 * radius;
+    for (size_t i = 0; i < count; ++i)
+    {
+        velocities[i] = particles[i].get_velocity();
+        inverse_masses[i] = particles[i].get_inverse_mass();
+        const vec_type position = particles[i].get_position();
+        for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+        {
+            const size_t j = indices[k];
+            if (j <= i) continue;
+            vec_type d = particles[j].get_position() - position;
+            real distance_squared = d * d;
+            if (distance_squared >= diameter * diameter) continue;
+            const real effective = particles[i].get_inverse_mass() + particles[j].get_inverse_mass();
+            if (effective <= 0 || distance_squared <= 0) continue;
+
+            real distance = std::sqrt(distance_squared);
+            Row row;
+            row.a = i;
+            row.b = j;
+            row.slot = cache.touch(i, j);
+            row.normal = d * (1 / distance);
+            row.bias = bias_factor / duration * std::max<real>(diameter - distance - slop, 0);
+            row.effective_mass = 1 / effective;
+            row.impulse = warm_starting ? cache[row.slot].impulse : 0;
+            rows.push_back(row);
+        }
+    }
+
+    // Apply last step's impulses, then refine them.
+    for (const Row& row : rows)
+    {
+        if (row.impulse == 0) continue;
+        velocities[row.a] -= row.normal * (row.impulse * inverse_masses[row.a]);
+        velocities[row.b] += row.normal * (row.impulse * inverse_masses[row.b]);
+    }
+    for (size_t pass = 0; pass < iterations; ++pass)
+    {
+        for (Row& row : rows)
+        {
+            real approach = (velocities[row.b] - velocities[row.a]) * row.normal;
+            real delta = (row.bias - approach) * row.effective_mass;
+            real accumulated = std::max<real>(row.impulse + delta, 0);
+            delta = accumulated - row.impulse;
+            row.impulse = accumulated;
+            velocities[row.a] -= row.normal * (delta * inverse_masses[row.a]);
+            velocities[row.b] += row.normal * (delta * inverse_masses[row.b]);
+        }
+    }
+
+    for (const Row& row : rows)
+    {
+        cache[row.slot].impulse = row.impulse;
+    }
+    cache.evict();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (inverse_masses[i] > 0) particles[i].set_velocity(velocities[i]);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicContactSolver<Dim>::set_iterations(size_t iterations)
+{
+    this->iterations = iterations;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicContactSolver<Dim>::set_warm_starting(bool enabled)
+{
+    warm_starting = enabled;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicContactSolver<Dim>::set_bias(real bias_factor, real slop)
+{
+    if (bias_factor < 0 || bias_factor > 1) throw std::domain_error("Bias factor must be in [0, 1]");
+    if (slop < 0) throw std::domain_error("Slop cannot be negative");
+    this->bias_factor = bias_factor;
+    this->slop = slop;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicContactSolver<Dim>::get_iterations() const
+{
+    return iterations;
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicContactSolver<Dim>::get_warm_starting() const
+{
+    return warm_starting;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicContactSolver<Dim>::contact_count() const
+{
+    return static_cast<size_t>(rows.size());
+}
+
+template <fizx::size_t Dim>
+const fizx::ContactCache& fizx::BasicContactSolver<Dim>::get_cache() const
+{
+    return cache;
+}
+
+template class fizx::BasicContactSolver<2>;
+template class fizx::BasicContactSolver<3>;
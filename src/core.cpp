@@ -1,9 +1,122 @@
 #include <FIZX/core.hpp>
 
+fizx::WorkerPool::WorkerPool(size_t threads)
+: stopping(false)
+{
+    if (threads <= 0)
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
 
+fizx::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
 
+void fizx::WorkerPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            task = std::move(queue.front().work);
+            queue.pop_front();
+        }
+        task();
+    }
+}
 
+void fizx::WorkerPool::submit(std::function<void()> task, const void* owner)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(Job{owner, std::move(task)});
+    }
+    ready.notify_one();
+}
 
+bool fizx::WorkerPool::run_one(const void* owner)
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto job = queue.begin();
+        if (owner)
+            job = std::find_if(queue.begin(), queue.end(), [owner](const Job& j) { return j.owner == owner; });
+        if (job == queue.end()) return false;
+        task = std::move(job->work);
+        queue.erase(job);
+    }
+    task();
+    return true;
+}
 
+fizx::size_t fizx::WorkerPool::size() const
+{
+    return static_cast<size_t>(workers.size());
+}
 
+fizx::WorkerPool& fizx::WorkerPool::shared()
+{
+    static WorkerPool pool;
+    return pool;
+}
 
+fizx::TaskGroup::TaskGroup()
+: pending(0)
+{}
+
+void fizx::TaskGroup::run(WorkerPool& pool, std::function<void()> work)
+{
+    pending.fetch_add(1);
+    pool.submit([this, work = std::move(work)]()
+    {
+        try
+        {
+            work();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+        pending.fetch_sub(1);
+    }, this);
+}
+
+void fizx::TaskGroup::wait(WorkerPool& pool)
+{
+    while (pending.load() > 0)
+    {
+        // Help with this group's own tasks rather than block, so nested waits cannot starve
+        // the pool and the waiting thread is not held up by unrelated work.
+        if (!pool.run_one(this)) std::this_thread::yield();
+    }
+
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(thrown, error);
+    }
+    if (thrown) std::rethrow_exception(thrown);
+}
+
+bool fizx::TaskGroup::done() const
+{
+    return pending.load() == 0;
+}
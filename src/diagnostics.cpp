@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <FIZX/diagnostics.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicTotals<Dim>::BasicTotals()
+{
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        lower[d] = std::numeric_limits<real>::infinity();
+        upper[d] = -std::numeric_limits<real>::infinity();
+    }
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicTotals<Dim>::vec_type fizx::BasicTotals<Dim>::centre_of_mass() const
+{
+    if (!(mass > 0)) return vec_type();
+    return moment * (1 / mass);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicTotals<Dim>::merge(const BasicTotals& other)
+{
+    count += other.count;
+    infinite_mass_count += other.infinite_mass_count;
+    kinetic_energy += other.kinetic_energy;
+    momentum += other.momentum;
+    mass += other.mass;
+    moment += other.moment;
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        lower[d] = std::min(lower[d], other.lower[d]);
+        upper[d] = std::max(upper[d], other.upper[d]);
+    }
+    finite = finite && other.finite;
+}
+
+namespace
+{
+
+/**
+ * Totals of count particles stored as packed reals, summed in order.
+*/
+template <fizx::size_t Dim>
+fizx::BasicTotals<Dim> sum_block(const fizx::real* fields, std::size_t count)
+{
+    using fizx::real;
+    constexpr std::size_t STRIDE = 4 * Dim + 2;
+    real energy = 0, mass = 0, momentum[Dim] = {}, moment[Dim] = {}, lower[Dim], upper[Dim];
+    std::fill(lower, lower + Dim, std::numeric_limits<real>::infinity());
+    std::fill(upper, upper + Dim, -std::numeric_limits<real>::infinity());
+    std::size_t infinite = 0;
+    // Stays 0 unless some value is infinite or NaN, without a branch per value.
+    real check = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const real* position = fields + i * STRIDE;
+        const real* velocity = position + Dim;
+        const real inverse_mass = position[3 * Dim + 1];
+        for (std::size_t d = 0; d < Dim; ++d)
+        {
+            lower[d] = position[d] < lower[d] ? position[d] : lower[d];
+            upper[d] = position[d] > upper[d] ? position[d] : upper[d];
+            check += position[d] * 0 + velocity[d] * 0;
+        }
+        if (inverse_mass == 0)
+        {
+            ++infinite;
+            continue;
+        }
+        const real m = 1 / inverse_mass;
+        real speed_squared = 0;
+        for (std::size_t d = 0; d < Dim; ++d)
+        {
+            speed_squared += velocity[d] * velocity[d];
+            momentum[d] += m * velocity[d];
+            moment[d] += m * position[d];
+        }
+        energy += 0.5 * m * speed_squared;
+        mass += m;
+    }
+
+    fizx::BasicTotals<Dim> totals;
+    totals.count = count;
+    totals.infinite_mass_count = infinite;
+    totals.kinetic_energy = energy;
+    totals.mass = mass;
+    for (std::size_t d = 0; d < Dim; ++d)
+    {
+        totals.momentum[d] = momentum[d];
+        totals.moment[d] = moment[d];
+        totals.lower[d] = lower[d];
+        totals.upper[d] = upper[d];
+    }
+    totals.finite = check == 0;
+    return totals;
+}
+
+} // namespace
+
+template <fizx::size_t Dim>
+fizx::BasicDiagnostics<Dim>::BasicDiagnostics(std::size_t block_size)
+: block_size(1), parallel(true)
+{
+    static_assert(sizeof(particle_type) == (4 * Dim + 2) * sizeof(real), "Particle must be packed reals");
+    set_block_size(block_size);
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicDiagnostics<Dim>::totals_type fizx::BasicDiagnostics<Dim>::measure(
+    const std::vector<particle_type>& particles)
+{
+    const std::size_t count = particles.size();
+    const std::size_t block_count = (count + block_size - 1) / block_size;
+    const real* fields = reinterpret_cast<const real*>(particles.data());
+    blocks.resize(block_count);
+    auto sum_blocks = [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const std::size_t first = b * block_size;
+            blocks[b] = sum_block<Dim>(fields + first * (4 * Dim + 2), std::min(block_size, count - first));
+        }
+    };
+    if (parallel)
+    {
+        parallel_for(static_cast<size_t>(block_count), sum_blocks, 1);
+    }
+    else
+    {
+        sum_blocks(0, static_cast<size_t>(block_count));
+    }
+
+    // Merge neighbouring blocks pairwise, level by level: the same tree for any thread count.
+    for (std::size_t width = 1; width < block_count; width *= 2)
+    {
+        for (std::size_t b = 0; b + width < block_count; b += 2 * width)
+        {
+            blocks[b].merge(blocks[b + width]);
+        }
+    }
+    const totals_type totals = block_count > 0 ? blocks[0] : totals_type();
+    std::lock_guard<std::mutex> lock(last_mutex);
+    last = totals;
+    return totals;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDiagnostics<Dim>::operator()(const std::vector<particle_type>& particles, size_t)
+{
+    measure(particles);
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicDiagnostics<Dim>::totals_type fizx::BasicDiagnostics<Dim>::get_last() const
+{
+    std::lock_guard<std::mutex> lock(last_mutex);
+    return last;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDiagnostics<Dim>::set_block_size(std::size_t particles)
+{
+    if (particles == 0) throw std::invalid_argument("Blocks need at least one particle");
+    block_size = particles;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDiagnostics<Dim>::set_parallel(bool enabled)
+{
+    parallel = enabled;
+}
+
+template struct fizx::BasicTotals<2>;
+template struct fizx::BasicTotals<3>;
+template class fizx::BasicDiagnostics<2>;
+template class fizx::BasicDiagnostics<3>;
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <FIZX/dispatch.hpp>
+
+// Kernels are compiled once per path from the same scalar source, using per function target
+// attributes; the vector code comes from the compiler auto-vectorising each copy.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define FIZX_X86_DISPATCH
+    #define FIZX_TARGET(isa) __attribute__((target(isa)))
+    #define FIZX_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+    #define FIZX_ALWAYS_INLINE inline
+#endif
+
+namespace
+{
+using fizx::real;
+
+template <int Dim>
+FIZX_ALWAYS_INLINE void integrate_particles_impl(real* particles, std::size_t count, real duration)
+{
+    constexpr int stride = 4 * Dim + 2;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        real* position = particles + i * stride;
+        real* velocity = position + Dim;
+        const real* acceleration = velocity + Dim;
+        const real damping = acceleration[Dim];
+        const real inverse_mass = acceleration[Dim + 1];
+        real* net_force = position + 3 * Dim + 2;
+
+        // We don't integrate things with infinite mass.
+        if (inverse_mass <= 0) continue;
+
+        const real drag = damping == 1 ? 1 : std::pow(damping, duration);
+        for (int d = 0; d < Dim; ++d)
+        {
+            position[d] += velocity[d] * duration;
+            velocity[d] += (acceleration[d] + net_force[d] * inverse_mass) * duration;
+            velocity[d] *= drag;
+            net_force[d] = 0;
+        }
+    }
+}
+
+// One component of one particle across lanes. Branch free, in blocks of 8 lanes so the compiler
+// vectorizes even at -O2. Multiplying by the 0 or 1 mask is exact, so infinite masses keep their values.
+FIZX_ALWAYS_INLINE void integrate_lane_rows(real* __restrict position, real* __restrict velocity,
+    const real* __restrict acceleration, real* __restrict net_force, const real* __restrict inverse_mass,
+    const real* __restrict factor, std::size_t lanes, real duration)
+{
+    for (std::size_t group = 0; group < lanes; group += 8)
+    {
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            const std::size_t w = group + k;
+            const real moving = inverse_mass[w] > 0;
+            position[w] += moving * (velocity[w] * duration);
+            velocity[w] = (velocity[w] + moving * ((acceleration[w] + net_force[w] * inverse_mass[w]) * duration))
+                * (moving * factor[w] + (1 - moving));
+            net_force[w] *= 1 - moving;
+        }
+    }
+}
+
+template <int Dim>
+FIZX_ALWAYS_INLINE void integrate_lanes_impl(real* blocks, const real* drag, std::size_t count, std::size_t lanes,
+    std::size_t stride, real duration)
+{
+    constexpr int rows = 4 * Dim + 2;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        real* block = blocks + i * rows * stride;
+        for (int d = 0; d < Dim; ++d)
+        {
+            integrate_lane_rows(block + d * stride, block + (Dim + d) * stride, block + (2 * Dim + d) * stride,
+                block + (3 * Dim + 2 + d) * stride, block + (3 * Dim + 1) * stride, drag + i * stride, lanes, duration);
+        }
+    }
+}
+
+FIZX_ALWAYS_INLINE void multiply_mat3_impl(const real* a, const real* b, real* out, std::size_t count)
+{
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const real* x = a + 9 * k;
+        const real* y = b + 9 * k;
+        real* z = out + 9 * k;
+        for (int m = 0; m < 3; ++m)
+        {
+            for (int l = 0; l < 3; ++l)
+            {
+                z[3 * m + l] = x[3 * m] * y[l] + x[3 * m + 1] * y[3 + l] + x[3 * m + 2] * y[6 + l];
+            }
+        }
+    }
+}
+
+FIZX_ALWAYS_INLINE void transform_vec3_impl(const real* matrix, const real* in, real* out, std::size_t count)
+{
+    const real m00 = matrix[0], m01 = matrix[1], m02 = matrix[2];
+    const real m10 = matrix[3], m11 = matrix[4], m12 = matrix[5];
+    const real m20 = matrix[6], m21 = matrix[7], m22 = matrix[8];
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const real x = in[3 * k], y = in[3 * k + 1], z = in[3 * k + 2];
+        out[3 * k] = m00 * x + m01 * y + m02 * z;
+        out[3 * k + 1] = m10 * x + m11 * y + m12 * z;
+        out[3 * k + 2] = m20 * x + m21 * y + m22 * z;
+    }
+}
+
+// Scales vectors in blocks of 8, with fixed trip counts so the compiler vectorizes each pass at -O2.
+// std::sqrt may set errno, which keeps the exact pass scalar. The approximate pass needs no select
+// for zero vectors: the first guess for 0 is finite, so they are scaled and stay zero.
+template <int Dim, bool Approximate>
+FIZX_ALWAYS_INLINE void normalize_block(real* __restrict v)
+{
+    real scale[8];
+    for (std::size_t k = 0; k < 8; ++k)
+    {
+        const real* u = v + Dim * k;
+        real square = u[0] * u[0] + u[1] * u[1];
+        if constexpr (Dim > 2) square += u[2] * u[2];
+        if constexpr (Dim > 3) square += u[3] * u[3];
+        if constexpr (Approximate) scale[k] = fizx::inverse_sqrt_approx(square);
+        else scale[k] = square > 0 ? 1 / std::sqrt(square) : 1;
+    }
+    for (std::size_t k = 0; k < 8; ++k)
+    {
+        for (int d = 0; d < Dim; ++d) v[Dim * k + d] *= scale[k];
+    }
+}
+
+template <int Dim, bool Approximate>
+FIZX_ALWAYS_INLINE void normalize_vectors_impl(real* vectors, std::size_t count)
+{
+    std::size_t k = 0;
+    for (; k + 8 <= count; k += 8) normalize_block<Dim, Approximate>(vectors + Dim * k);
+    if (k == count) return;
+    // Tail through a zero padded copy, so the block never touches past the end.
+    real tail[8 * Dim] = {};
+    std::copy(vectors + Dim * k, vectors + Dim * count, tail);
+    normalize_block<Dim, Approximate>(tail);
+    std::copy(tail, tail + Dim * (count - k), vectors + Dim * k);
+}
+
+template <int Dim>
+FIZX_ALWAYS_INLINE void normalize_vectors_dim(real* vectors, std::size_t count, bool approximate)
+{
+    if (approximate) normalize_vectors_impl<Dim, true>(vectors, count);
+    else normalize_vectors_impl<Dim, false>(vectors, count);
+}
+
+// Stamps out one kernel table for a path.
+#define FIZX_DEFINE_KERNELS(suffix, ATTRIBUTE)                                                      \
+    ATTRIBUTE void integrate_particles_##suffix(real* p, std::size_t count, fizx::size_t dim, real duration) \
+    {                                                                                               \
+        if (dim == 3) integrate_particles_impl<3>(p, count, duration);                              \
+        else if (dim == 2) integrate_particles_impl<2>(p, count, duration);                         \
+        else throw std::invalid_argument("Unsupported particle dimension");                         \
+    }                                                                                               \
+    ATTRIBUTE void integrate_lanes_##suffix(real* b, const real* drag, std::size_t count, std::size_t lanes, \
+        std::size_t stride, fizx::size_t dim, real duration)                                        \
+    {                                                                                               \
+        if (dim == 3) integrate_lanes_impl<3>(b, drag, count, lanes, stride, duration);             \
+        else if (dim == 2) integrate_lanes_impl<2>(b, drag, count, lanes, stride, duration);        \
+        else throw std::invalid_argument("Unsupported particle dimension");                         \
+    }                                                                                               \
+    ATTRIBUTE void normalize_vectors_##suffix(real* v, std::size_t count, fizx::size_t dim, bool approximate) \
+    {                                                                                               \
+        if (dim == 3) normalize_vectors_dim<3>(v, count, approximate);                              \
+        else if (dim == 4) normalize_vectors_dim<4>(v, count, approximate);                         \
+        else if (dim == 2) normalize_vectors_dim<2>(v, count, approximate);                         \
+        else throw std::invalid_argument("Unsupported vector dimension");                           \
+    }                                                                                               \
+    ATTRIBUTE void multiply_mat3_##suffix(const real* a, const real* b, real* out, std::size_t count) \
+    {                                                                                               \
+        multiply_mat3_impl(a, b, out, count);                                                       \
+    }                                                                                               \
+    ATTRIBUTE void transform_vec3_##suffix(const real* m, const real* in, real* out, std::size_t count) \
+    {                                                                                               \
+        transform_vec3_impl(m, in, out, count);                                                     \
+    }                                                                                               \
+    const fizx::Kernels kernels_##suffix = {                                                        \
+        integrate_particles_##suffix, integrate_lanes_##suffix, normalize_vectors_##suffix,         \
+        multiply_mat3_##suffix, transform_vec3_##suffix                                             \
+    };
+
+FIZX_DEFINE_KERNELS(scalar, )
+#ifdef FIZX_X86_DISPATCH
+FIZX_DEFINE_KERNELS(sse42, FIZX_TARGET("sse4.2"))
+FIZX_DEFINE_KERNELS(avx2, FIZX_TARGET("avx2,fma"))
+FIZX_DEFINE_KERNELS(avx512, FIZX_TARGET("avx512f,avx512dq,avx2,fma"))
+#endif
+
+std::atomic<int>& active_path()
+{
+    static std::atomic<int> path([]()
+    {
+        fizx::CpuPath detected = fizx::detect_cpu_path();
+        const char* forced = std::getenv("FIZX_CPU_PATH");
+        if (!forced || !*forced) return static_cast<int>(detected);
+        // A misspelt name must not leave every kernels() call throwing: use the detected path.
+        try
+        {
+            return static_cast<int>(std::min(fizx::parse_cpu_path(forced), detected));
+        }
+        catch (const std::invalid_argument&)
+        {
+            return static_cast<int>(detected);
+        }
+    }());
+    return path;
+}
+
+} // namespace
+
+fizx::CpuPath fizx::detect_cpu_path()
+{
+#ifdef FIZX_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return CpuPath::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return CpuPath::avx2;
+    if (__builtin_cpu_supports("sse4.2")) return CpuPath::sse42;
+#endif
+    return CpuPath::scalar;
+}
+
+fizx::CpuPath fizx::get_cpu_path()
+{
+    return static_cast<CpuPath>(active_path().load());
+}
+
+fizx::CpuPath fizx::set_cpu_path(CpuPath path)
+{
+    CpuPath selected = std::min(path, detect_cpu_path());
+    active_path().store(static_cast<int>(selected));
+    return selected;
+}
+
+fizx::CpuPath fizx::parse_cpu_path(const char* name)
+{
+    for (CpuPath path : {CpuPath::scalar, CpuPath::sse42, CpuPath::avx2, CpuPath::avx512})
+    {
+        if (std::strcmp(name, cpu_path_name(path)) == 0) return path;
+    }
+    throw std::invalid_argument(std::string("Unknown CPU path: ") + name);
+}
+
+const char* fizx::cpu_path_name(CpuPath path)
+{
+    switch (path)
+    {
+    case CpuPath::scalar: return "scalar";
+    case CpuPath::sse42: return "sse4.2";
+    case CpuPath::avx2: return "avx2";
+    case CpuPath::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+const fizx::Kernels& fizx::get_kernels(CpuPath path)
+{
+#ifdef FIZX_X86_DISPATCH
+    switch (path)
+    {
+    case CpuPath::sse42: return kernels_sse42;
+    case CpuPath::avx2: return kernels_avx2;
+    case CpuPath::avx512: return kernels_avx512;
+    default: break;
+    }
+#endif
+    return kernels_scalar;
+}
+
+const fizx::Kernels& fizx::kernels()
+{
+    return get_kernels(get_cpu_path());
+}
+
+void fizx::multiply(const mat3f* a, const mat3f* b, mat3f* out, std::size_t count)
+{
+    static_assert(sizeof(mat3f) == 9 * sizeof(real), "mat3f must be 9 packed reals");
+    kernels().multiply_mat3(reinterpret_cast<const real*>(a), reinterpret_cast<const real*>(b),
+        reinterpret_cast<real*>(out), count);
+}
+
+void fizx::transform(const mat3f& matrix, const vec3f* in, vec3f* out, std::size_t count)
+{
+    static_assert(sizeof(vec3f) == 3 * sizeof(real), "vec3f must be 3 packed reals");
+    kernels().transform_vec3(reinterpret_cast<const real*>(&matrix), reinterpret_cast<const real*>(in),
+        reinterpret_cast<real*>(out), count);
+}
+
+void fizx::normalize(vec3f* vectors, std::size_t count)
+{
+    static_assert(sizeof(vec3f) == 3 * sizeof(real), "vec3f must be 3 packed reals");
+    kernels().normalize_vectors(reinterpret_cast<real*>(vectors), count, 3, false);
+}
+
+void fizx::normalize(vec4f* vectors, std::size_t count)
+{
+    static_assert(sizeof(vec4f) == 4 * sizeof(real), "vec4f must be 4 packed reals");
+    kernels().normalize_vectors(reinterpret_cast<real*>(vectors), count, 4, false);
+}
+
+void fizx::fast_normalize(vec3f* vectors, std::size_t count)
+{
+    kernels().normalize_vectors(reinterpret_cast<real*>(vectors), count, 3, true);
+}
+
+void fizx::fast_normalize(vec4f* vectors, std::size_t count)
+{
+    kernels().normalize_vectors(reinterpret_cast<real*>(vectors), count, 4, true);
+}
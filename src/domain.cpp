@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <FIZX/domain.hpp>
+#include <FIZX/memory.hpp>
+
+namespace
+{
+
+enum Command
+{
+    STEP,
+    QUIT
+};
+
+/**
+ * Particles a domain owns, and those it published to or is handing over to its neighbours.
+*/
+struct Counts
+{
+    std::uint32_t owned;
+    std::uint32_t ghosts[2];
+    std::uint32_t outbox[2];
+};
+
+constexpr std::size_t ALIGNMENT = 64;
+
+std::size_t align_up(std::size_t bytes)
+{
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+std::runtime_error system_error(const char* what)
+{
+    return std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+std::atomic<unsigned> region_counter{0};
+
+/**
+ * Counts of every domain, just after the header of the region.
+*/
+template <class Shared>
+Counts* domain_counts(void* region)
+{
+    return reinterpret_cast<Counts*>(static_cast<unsigned char*>(region) + align_up(sizeof(Shared)));
+}
+
+} // namespace
+
+template <fizx::size_t Dim>
+struct fizx::BasicDomainDecomposition<Dim>::Shared
+{
+    /**
+     * Workers and the owning process meet here before and after every command.
+    */
+    pthread_barrier_t control;
+
+    /**
+     * Workers meet here between the phases of a step.
+    */
+    pthread_barrier_t phases;
+
+    // The command in flight, written before releasing the workers.
+    int command;
+    real duration;
+    size_t steps;
+
+    std::atomic<int> failed;
+    std::uint32_t total;
+};
+
+template <fizx::size_t Dim>
+struct fizx::BasicDomainDecomposition<Dim>::Slot
+{
+    particle_type particle;
+
+    /**
+     * Index of the particle when loaded.
+    */
+    std::uint32_t id;
+};
+
+template <fizx::size_t Dim>
+fizx::BasicDomainDecomposition<Dim>::BasicDomainDecomposition(size_t domains, real lower, real upper, real ghost_width,
+    std::size_t capacity)
+: domains(domains), lower(lower), width(0), ghost_width(ghost_width), capacity(capacity), region(nullptr),
+  region_size(0), shared(nullptr)
+{
+    if (domains < 1) throw std::invalid_argument("Need at least one domain");
+    if (!(upper > lower)) throw std::invalid_argument("Domain range must not be empty");
+    if (capacity == 0 || capacity > 0xFFFFFFFFu) throw std::invalid_argument("Domain capacity out of range");
+    width = (upper - lower) / domains;
+    if (!(ghost_width >= 0) || ghost_width > width) throw std::invalid_argument("Ghost width must be in [0, domain width]");
+
+    // Header and counts, then per domain its owned particles, two ghost buffers and two outboxes.
+    region_size = align_up(sizeof(Shared)) + align_up(domains * sizeof(Counts))
+        + domains * 5 * align_up(capacity * sizeof(Slot));
+    MemoryAccount::shared().charge(Subsystem::particles, region_size);
+
+    // The name is unlinked once mapped: the region lives as long as the mappings, forks included.
+    const std::string name = "/fizx-domains-" + std::to_string(getpid()) + "-" + std::to_string(region_counter++);
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        MemoryAccount::shared().release(Subsystem::particles, region_size);
+        throw system_error("shm_open");
+    }
+    if (ftruncate(fd, region_size) != 0 ||
+        (region = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+    {
+        std::runtime_error error = system_error("Mapping the domain region");
+        close(fd);
+        shm_unlink(name.c_str());
+        MemoryAccount::shared().release(Subsystem::particles, region_size);
+        throw error;
+    }
+    close(fd);
+    shm_unlink(name.c_str());
+
+    shared = new (region) Shared();
+    shared->failed = 0;
+    shared->total = 0;
+    Counts* counts = domain_counts<Shared>(region);
+    std::fill(counts, counts + domains, Counts{0, {0, 0}, {0, 0}});
+    for (size_t d = 0; d < domains; ++d)
+    {
+        std::uninitialized_default_construct_n(owned(d), 5 * (align_up(capacity * sizeof(Slot)) / sizeof(Slot)));
+    }
+}
+
+template <fizx::size_t Dim>
+fizx::BasicDomainDecomposition<Dim>::~BasicDomainDecomposition()
+{
+    stop();
+    munmap(region, region_size);
+    MemoryAccount::shared().release(Subsystem::particles, region_size);
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicDomainDecomposition<Dim>::Slot* fizx::BasicDomainDecomposition<Dim>::owned(size_t domain) const
+{
+    unsigned char* slots = static_cast<unsigned char*>(region) + align_up(sizeof(Shared)) + align_up(domains * sizeof(Counts));
+    return reinterpret_cast<Slot*>(slots + domain * 5 * align_up(capacity * sizeof(Slot)));
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicDomainDecomposition<Dim>::Slot* fizx::BasicDomainDecomposition<Dim>::ghosts(size_t domain, int side) const
+{
+    return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(owned(domain)) + (1 + side) * align_up(capacity * sizeof(Slot)));
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicDomainDecomposition<Dim>::Slot* fizx::BasicDomainDecomposition<Dim>::outbox(size_t domain, int side) const
+{
+    return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(owned(domain)) + (3 + side) * align_up(capacity * sizeof(Slot)));
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::step_domain(size_t domain, real duration, std::vector<particle_type>& local)
+{
+    Counts* all = domain_counts<Shared>(region);
+    Counts& counts = all[domain];
+    Slot* own = owned(domain);
+    const bool has[2] = {domain > 0, domain + 1 < domains};
+
+    // Publish the particles near each boundary. Neighbours read them only after the next barrier,
+    // and finished reading the last ones before the previous barrier.
+    for (int side = 0; side < 2; ++side)
+    {
+        counts.ghosts[side] = 0;
+        if (!has[side]) continue;
+        const real boundary = lower + (domain + side) * width;
+        Slot* out = ghosts(domain, side);
+        for (std::uint32_t i = 0; i < counts.owned; ++i)
+        {
+            const real x = own[i].particle.get_position()[0];
+            if (side == 0 ? x < boundary + ghost_width : x >= boundary - ghost_width) out[counts.ghosts[side]++] = own[i];
+        }
+    }
+    pthread_barrier_wait(&shared->phases);
+
+    // Step the owned particles with the ghosts of the neighbours around them.
+    local.clear();
+    for (std::uint32_t i = 0; i < counts.owned; ++i)
+    {
+        local.push_back(own[i].particle);
+    }
+    for (int side = 0; side < 2; ++side)
+    {
+        if (!has[side]) continue;
+        const size_t neighbour = side == 0 ? domain - 1 : domain + 1;
+        const Slot* in = ghosts(neighbour, 1 - side);
+        for (std::uint32_t i = 0; i < all[neighbour].ghosts[1 - side]; ++i)
+        {
+            local.push_back(in[i].particle);
+        }
+    }
+    try
+    {
+        for (ForceGenerator& generator : force_generators)
+        {
+            generator(local, duration);
+        }
+    }
+    catch (...)
+    {
+        shared->failed = 1;
+    }
+    particle_type::integrate_batch(local.data(), counts.owned, duration);
+
+    // Keep what stayed, hand the rest over towards the domain it is in now.
+    std::uint32_t kept = 0;
+    counts.outbox[0] = counts.outbox[1] = 0;
+    for (std::uint32_t i = 0; i < counts.owned; ++i)
+    {
+        const Slot slot = {local[i], own[i].id};
+        const size_t target = domain_of(slot.particle.get_position()[0]);
+        if (target == domain)
+        {
+            own[kept++] = slot;
+            continue;
+        }
+        const int side = target < domain ? 0 : 1;
+        outbox(domain, side)[counts.outbox[side]++] = slot;
+    }
+    counts.owned = kept;
+    pthread_barrier_wait(&shared->phases);
+
+    // Take over what the neighbours handed to this domain.
+    for (int side = 0; side < 2; ++side)
+    {
+        if (!has[side]) continue;
+        const size_t neighbour = side == 0 ? domain - 1 : domain + 1;
+        const Slot* in = outbox(neighbour, 1 - side);
+        for (std::uint32_t i = 0; i < all[neighbour].outbox[1 - side]; ++i)
+        {
+            if (counts.owned == capacity)
+            {
+                shared->failed = 1;
+                break;
+            }
+            own[counts.owned++] = in[i];
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::work(size_t domain)
+{
+    std::vector<particle_type> local;
+    local.reserve(3 * capacity);
+    while (true)
+    {
+        pthread_barrier_wait(&shared->control);
+        if (shared->command == QUIT) return;
+        for (size_t s = 0; s < shared->steps; ++s)
+        {
+            step_domain(domain, shared->duration, local);
+        }
+        pthread_barrier_wait(&shared->control);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::command(int command)
+{
+    shared->command = command;
+    pthread_barrier_wait(&shared->control);
+    if (command != QUIT) pthread_barrier_wait(&shared->control);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::add_force_generator(ForceGenerator generator)
+{
+    if (running()) throw std::runtime_error("Force generators must be added before start");
+    force_generators.push_back(std::move(generator));
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::load(const std::vector<particle_type>& particles)
+{
+    if (particles.size() > 0xFFFFFFFFu) throw std::length_error("Too many particles");
+    std::vector<std::size_t> sizes(domains, 0);
+    for (const particle_type& p : particles)
+    {
+        if (++sizes[domain_of(p.get_position()[0])] > capacity) throw std::length_error("Domain capacity exceeded");
+    }
+    Counts* all = domain_counts<Shared>(region);
+    std::fill(all, all + domains, Counts{0, {0, 0}, {0, 0}});
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+        const size_t d = domain_of(particles[i].get_position()[0]);
+        owned(d)[all[d].owned++] = Slot{particles[i], static_cast<std::uint32_t>(i)};
+    }
+    shared->total = static_cast<std::uint32_t>(particles.size());
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::gather(std::vector<particle_type>& particles) const
+{
+    particles.resize(shared->total);
+    const Counts* all = domain_counts<Shared>(region);
+    for (size_t d = 0; d < domains; ++d)
+    {
+        const Slot* own = owned(d);
+        for (std::uint32_t i = 0; i < all[d].owned; ++i)
+        {
+            particles[own[i].id] = own[i].particle;
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::start()
+{
+    if (running()) return;
+
+    pthread_barrierattr_t attributes;
+    pthread_barrierattr_init(&attributes);
+    pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&shared->control, &attributes, domains + 1);
+    pthread_barrier_init(&shared->phases, &attributes, domains);
+    pthread_barrierattr_destroy(&attributes);
+
+    for (size_t d = 0; d < domains; ++d)
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            // Leave without running the destructors of the state copied from the parent.
+            int status = 0;
+            try
+            {
+                work(d);
+            }
+            catch (...)
+            {
+                status = 1;
+            }
+            _exit(status);
+        }
+        if (pid < 0)
+        {
+            std::runtime_error error = system_error("fork");
+            for (int worker : workers)
+            {
+                kill(worker, SIGKILL);
+                waitpid(worker, nullptr, 0);
+            }
+            workers.clear();
+            throw error;
+        }
+        workers.push_back(pid);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::step(real duration, size_t steps)
+{
+    if (!running()) throw std::runtime_error("Domain workers are not running");
+    if (steps < 0) throw std::domain_error("Steps cannot be negative");
+    if (steps == 0) return;
+    shared->duration = duration;
+    shared->steps = steps;
+    command(STEP);
+    if (shared->failed.exchange(0)) throw std::runtime_error("Domain step failed");
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicDomainDecomposition<Dim>::stop()
+{
+    if (!running()) return;
+    command(QUIT);
+    for (int worker : workers)
+    {
+        waitpid(worker, nullptr, 0);
+    }
+    workers.clear();
+    pthread_barrier_destroy(&shared->control);
+    pthread_barrier_destroy(&shared->phases);
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicDomainDecomposition<Dim>::domain_of(real x) const
+{
+    const real d = std::floor((x - lower) / width);
+    if (!(d > 0)) return 0;
+    return d >= domains ? domains - 1 : static_cast<size_t>(d);
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicDomainDecomposition<Dim>::domain_size(size_t domain) const
+{
+    if (domain < 0 || domain >= domains) throw std::runtime_error("Index Out of Bounds");
+    const Counts* all = domain_counts<Shared>(region);
+    return all[domain].owned;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicDomainDecomposition<Dim>::domain_count() const
+{
+    return domains;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicDomainDecomposition<Dim>::size() const
+{
+    return static_cast<size_t>(shared->total);
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicDomainDecomposition<Dim>::running() const
+{
+    return !workers.empty();
+}
+
+template class fizx::BasicDomainDecomposition<2>;
+template class fizx::BasicDomainDecomposition<3>;
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <stdexcept>
+#include <FIZX/emitter.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicEmitter<Dim>::BasicEmitter(std::size_t capacity, std::uint64_t seed)
+: mass_min(1), mass_max(1), lifetime_min(1), lifetime_max(1), damping(1), random_state(seed)
+{
+    particles.reserve(capacity);
+    lifetimes.reserve(capacity);
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicEmitter<Dim>::uniform(real min, real max)
+{
+    // splitmix64, then the top 53 bits as a fraction in [0, 1).
+    std::uint64_t z = (random_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return min + (max - min) * static_cast<real>((z >> 11) * 0x1.0p-53);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_position(const vec_type& centre, const vec_type& spread)
+{
+    position_centre = centre;
+    position_spread = spread;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_velocity(const vec_type& centre, const vec_type& spread)
+{
+    velocity_centre = centre;
+    velocity_spread = spread;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_mass(real min, real max)
+{
+    if (min <= 0 || max < min) throw std::domain_error("Mass range must be positive");
+    mass_min = min;
+    mass_max = max;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_lifetime(real min, real max)
+{
+    if (min <= 0 || max < min) throw std::domain_error("Lifetime range must be positive");
+    lifetime_min = min;
+    lifetime_max = max;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_acceleration(const vec_type& acceleration)
+{
+    this->acceleration = acceleration;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::set_damping(real damping)
+{
+    this->damping = damping;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicEmitter<Dim>::emit(std::size_t count)
+{
+    const std::size_t begin = particles.size();
+    const std::size_t end = std::min(begin + count, particles.capacity());
+
+    // Stays within the reserved storage, so this never allocates.
+    particles.resize(end);
+    lifetimes.resize(end);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        particle_type& p = particles[i];
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            p.position[d] = uniform(position_centre[d] - position_spread[d], position_centre[d] + position_spread[d]);
+            p.velocity[d] = uniform(velocity_centre[d] - velocity_spread[d], velocity_centre[d] + velocity_spread[d]);
+        }
+        p.acceleration = acceleration;
+        p.damping = damping;
+        p.inverse_mass = 1 / uniform(mass_min, mass_max);
+        p.net_force = vec_type();
+        lifetimes[i] = uniform(lifetime_min, lifetime_max);
+    }
+    return end - begin;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicEmitter<Dim>::update(real duration)
+{
+    parallel_for(static_cast<size_t>(particles.size()), [this, duration](size_t begin, size_t end)
+    {
+        particle_type::integrate_batch(particles.data() + begin, end - begin, duration);
+    }, 256);
+    return age(duration);
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicEmitter<Dim>::age(real duration)
+{
+    // Survivors slide down over the expired, in one pass.
+    std::size_t kept = 0;
+    const std::size_t count = particles.size();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        real left = lifetimes[i] - duration;
+        if (left <= 0) continue;
+        if (kept != i) particles[kept] = particles[i];
+        lifetimes[kept] = left;
+        ++kept;
+    }
+    particles.resize(kept);
+    lifetimes.resize(kept);
+    return count - kept;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicEmitter<Dim>::clear()
+{
+    particles.clear();
+    lifetimes.clear();
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicEmitter<Dim>::size() const
+{
+    return particles.size();
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicEmitter<Dim>::capacity() const
+{
+    return particles.capacity();
+}
+
+template <fizx::size_t Dim>
+fizx::BasicParticle<Dim>* fizx::BasicEmitter<Dim>::data()
+{
+    return particles.data();
+}
+
+template <fizx::size_t Dim>
+const fizx::BasicParticle<Dim>* fizx::BasicEmitter<Dim>::data() const
+{
+    return particles.data();
+}
+
+template <fizx::size_t Dim>
+fizx::BasicParticle<Dim>& fizx::BasicEmitter<Dim>::operator[](std::size_t index)
+{
+    if (index >= particles.size()) throw std::runtime_error("Index Out of Bounds");
+    return particles[index];
+}
+
+template <fizx::size_t Dim>
+const fizx::BasicParticle<Dim>& fizx::BasicEmitter<Dim>::operator[](std::size_t index) const
+{
+    if (index >= particles.size()) throw std::runtime_error("Index Out of Bounds");
+    return particles[index];
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicEmitter<Dim>::get_lifetime(std::size_t index) const
+{
+    if (index >= lifetimes.size()) throw std::runtime_error("Index Out of Bounds");
+    return lifetimes[index];
+}
+
+template class fizx::BasicEmitter<2>;
+template class fizx::BasicEmitter<3>;
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <stdexcept>
+#include <FIZX/export.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicCsvExporter<Dim>::BasicCsvExporter(std::ostream& out, std::initializer_list<Column> columns, char separator)
+: out(out), columns(columns), separator(separator), parallel(false), chunk_size(4096), bytes_written(0), task_count(0)
+{
+    static_assert(sizeof(particle_type) == (4 * Dim + 2) * sizeof(real), "Particle must be packed reals");
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::format(const particle_type* particles, std::size_t first, std::size_t count,
+    size_t frame, buffer_type& buffer) const
+{
+    // Room for the worst case, written through a pointer and trimmed after: no per value growth checks.
+    const std::size_t row_chars = (2 + columns.size() * Dim) * (REAL_CHARS + 1) + 1;
+    buffer.resize(count * row_chars);
+    char* at = buffer.data();
+    const real* fields = reinterpret_cast<const real*>(particles);
+    for (std::size_t i = first; i < first + count; ++i)
+    {
+        at = std::to_chars(at, at + REAL_CHARS, frame).ptr;
+        *at++ = separator;
+        at = std::to_chars(at, at + REAL_CHARS, i).ptr;
+        const real* particle = fields + i * (4 * Dim + 2);
+        for (Column column : columns)
+        {
+            std::size_t offset = 0, components = Dim;
+            switch (column)
+            {
+            case Column::position: offset = 0; break;
+            case Column::velocity: offset = Dim; break;
+            case Column::acceleration: offset = 2 * Dim; break;
+            case Column::inverse_mass: offset = 3 * Dim + 1; components = 1; break;
+            case Column::net_force: offset = 3 * Dim + 2; break;
+            }
+            for (std::size_t d = 0; d < components; ++d)
+            {
+                *at++ = separator;
+                at = format_real(at, particle[offset + d]);
+            }
+        }
+        *at++ = '\n';
+    }
+    buffer.resize(at - buffer.data());
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::write_header()
+{
+    static const char* const axes = "xyzw";
+    std::string header = "frame";
+    header += separator;
+    header += "index";
+    for (Column column : columns)
+    {
+        const char* name = "";
+        switch (column)
+        {
+        case Column::position: name = "position"; break;
+        case Column::velocity: name = "velocity"; break;
+        case Column::acceleration: name = "acceleration"; break;
+        case Column::net_force: name = "net_force"; break;
+        case Column::inverse_mass: name = "inverse_mass"; break;
+        }
+        if (column == Column::inverse_mass)
+        {
+            header += separator;
+            header += name;
+            continue;
+        }
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            header += separator;
+            header += name;
+            header += '_';
+            header += axes[d];
+        }
+    }
+    header += '\n';
+    out.write(header.data(), header.size());
+    bytes_written += header.size();
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::write(const std::vector<particle_type>& particles, size_t frame)
+{
+    const std::size_t count = particles.size();
+    const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+    if (buffers.size() < (parallel ? chunks : 1)) buffers.resize(parallel ? chunks : 1);
+
+    if (!parallel)
+    {
+        task_count = 1;
+        // One buffer the size of a chunk, written out as soon as it is full.
+        for (std::size_t c = 0; c < chunks; ++c)
+        {
+            const std::size_t first = c * chunk_size;
+            format(particles.data(), first, std::min(chunk_size, count - first), frame, buffers[0]);
+            out.write(buffers[0].data(), buffers[0].size());
+            bytes_written += buffers[0].size();
+        }
+        return;
+    }
+
+    // A chunk is already thousands of rows, so every chunk is worth a task of its own.
+    std::atomic<std::size_t> tasks(0);
+    parallel_for(static_cast<size_t>(chunks), [&](size_t begin, size_t end)
+    {
+        tasks.fetch_add(1, std::memory_order_relaxed);
+        for (size_t c = begin; c < end; ++c)
+        {
+            const std::size_t first = c * chunk_size;
+            format(particles.data(), first, std::min(chunk_size, count - first), frame, buffers[c]);
+        }
+    }, 1);
+    task_count = tasks.load(std::memory_order_relaxed);
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+        out.write(buffers[c].data(), buffers[c].size());
+        bytes_written += buffers[c].size();
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::operator()(const std::vector<particle_type>& particles, size_t frame)
+{
+    write(particles, frame);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::set_parallel(bool enabled)
+{
+    parallel = enabled;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicCsvExporter<Dim>::set_chunk_size(std::size_t particles)
+{
+    if (particles == 0) throw std::invalid_argument("Chunks need at least one particle");
+    chunk_size = particles;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicCsvExporter<Dim>::get_bytes_written() const
+{
+    return bytes_written;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicCsvExporter<Dim>::get_task_count() const
+{
+    return task_count;
+}
+
+template class fizx::BasicCsvExporter<2>;
+template class fizx::BasicCsvExporter<3>;
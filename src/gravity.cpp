@@ -0,0 +1,305 @@
+#include <assert.h>
+#include <algorithm>
+#include <FIZX/gravity.hpp>
+
+namespace
+{
+// Bits of a Morton key given to each axis.
+constexpr int MORTON_BITS = 21;
+
+/**
+ * Spreads the lower 21 bits of a value so that there are two zero bits between each of them.
+*/
+std::uint64_t spread_bits(std::uint64_t v)
+{
+    v &= 0x1f'ffff;
+    v = (v | v << 32) & 0x1f'0000'0000'ffff;
+    v = (v | v << 16) & 0x1f'0000'ff00'00ff;
+    v = (v | v << 8) & 0x100f'00f0'0f00'f00f;
+    v = (v | v << 4) & 0x10c3'0c30'c30c'30c3;
+    v = (v | v << 2) & 0x1249'2492'4924'9249;
+    return v;
+}
+
+/**
+ * Gets which child of a node at the given level a key falls into.
+*/
+int octant(std::uint64_t key, int level)
+{
+    return static_cast<int>((key >> (3 * (MORTON_BITS - 1 - level))) & 7);
+}
+
+} // namespace
+
+fizx::Octree::Octree(size_t leaf_capacity)
+: leaf_capacity(std::max<size_t>(1, leaf_capacity))
+{}
+
+void fizx::Octree::build(const std::vector<vec3f>& positions, const std::vector<real>& masses)
+{
+    assert(positions.size() == masses.size());
+    build(positions.data(), masses.data(), static_cast<size_t>(positions.size()));
+}
+
+void fizx::Octree::build(const vec3f* positions, const real* masses, size_t body_count)
+{
+    nodes.clear();
+    keys.clear();
+    for (size_t i = 0; i < body_count; ++i)
+    {
+        if (masses[i] > 0.0f) keys.push_back({0, i});
+    }
+    size_t count = static_cast<size_t>(keys.size());
+    body_positions.resize(count);
+    body_masses.resize(count);
+    if (count == 0) return;
+
+    // Bounding cube of the bodies.
+    vec3f lower = positions[keys[0].second];
+    vec3f upper = lower;
+    for (const auto& entry : keys)
+    {
+        const vec3f& p = positions[entry.second];
+        for (size_t d = 0; d < 3; ++d)
+        {
+            lower[d] = std::min(lower[d], p[d]);
+            upper[d] = std::max(upper[d], p[d]);
+        }
+    }
+    real size = std::max({upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2]});
+    if (size <= 0.0f) size = 1.0f;
+
+    // Quantize onto a 2^21 grid per axis and interleave into Morton keys.
+    const real cells = static_cast<real>(1 << MORTON_BITS);
+    const real scale = cells / size;
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t k = begin; k < end; ++k)
+        {
+            const vec3f& p = positions[keys[k].second];
+            std::uint64_t key = 0;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                real cell = std::min((p[d] - lower[d]) * scale, cells - 1.0f);
+                key |= spread_bits(static_cast<std::uint64_t>(cell)) << (2 - d);
+            }
+            keys[k].first = key;
+        }
+    });
+
+    // Bucket by root octant, so every subtree owns a contiguous and independent range.
+    size_t offsets[9] = {0};
+    for (const auto& entry : keys)
+    {
+        ++offsets[octant(entry.first, 0) + 1];
+    }
+    for (int o = 0; o < 8; ++o)
+    {
+        offsets[o + 1] += offsets[o];
+    }
+    {
+        key_list bucketed(count);
+        size_t fill[8];
+        std::copy(offsets, offsets + 8, fill);
+        for (const auto& entry : keys)
+        {
+            bucketed[fill[octant(entry.first, 0)]++] = entry;
+        }
+        keys.swap(bucketed);
+    }
+
+    // Sort and build each root octant on its own thread.
+    node_list subtrees[8];
+    bool root_is_leaf = count <= leaf_capacity;
+    parallel_for(8, [&](size_t first, size_t last)
+    {
+        for (int o = first; o < last; ++o)
+        {
+            size_t begin = offsets[o];
+            size_t end = offsets[o + 1];
+            std::sort(keys.begin() + begin, keys.begin() + end);
+            for (size_t k = begin; k < end; ++k)
+            {
+                body_positions[k] = positions[keys[k].second];
+                body_masses[k] = masses[keys[k].second];
+            }
+            if (!root_is_leaf && begin < end)
+                build_subtree(subtrees[o], begin, end, 1, size * 0.5f);
+        }
+    }, 1);
+
+    // Splice the subtrees behind the root, shifting their indices into the shared pool.
+    OctreeNode root{vec3f(), 0, size, 0, 0, count};
+    for (size_t k = 0; k < count; ++k)
+    {
+        root.mass += body_masses[k];
+        root.centre_of_mass.add_scaled_vector(body_positions[k], body_masses[k]);
+    }
+    root.centre_of_mass *= 1.0f / root.mass;
+    nodes.push_back(root);
+    for (int o = 0; o < 8; ++o)
+    {
+        size_t offset = static_cast<size_t>(nodes.size());
+        for (OctreeNode node : subtrees[o])
+        {
+            node.next += offset;
+            nodes.push_back(node);
+        }
+    }
+    nodes[0].next = static_cast<size_t>(nodes.size());
+}
+
+void fizx::Octree::build_subtree(node_list& pool, size_t begin, size_t end, int level, real size)
+{
+    size_t index = static_cast<size_t>(pool.size());
+    pool.push_back(OctreeNode{vec3f(), 0, size, 0, begin, end});
+
+    vec3f weighted;
+    real mass = 0;
+    if (end - begin <= leaf_capacity || level == MORTON_BITS)
+    {
+        for (size_t k = begin; k < end; ++k)
+        {
+            mass += body_masses[k];
+            weighted.add_scaled_vector(body_positions[k], body_masses[k]);
+        }
+    }
+    else
+    {
+        // Keys in the range share every bit above this level, so children are contiguous runs.
+        size_t child_begin = begin;
+        while (child_begin < end)
+        {
+            int child = octant(keys[child_begin].first, level);
+            auto child_end = std::partition_point(keys.begin() + child_begin, keys.begin() + end,
+                [&](const std::pair<std::uint64_t, size_t>& entry) { return octant(entry.first, level) == child; });
+            size_t first_child = static_cast<size_t>(pool.size());
+            build_subtree(pool, child_begin, static_cast<size_t>(child_end - keys.begin()), level + 1, size * 0.5f);
+            mass += pool[first_child].mass;
+            weighted.add_scaled_vector(pool[first_child].centre_of_mass, pool[first_child].mass);
+            child_begin = static_cast<size_t>(child_end - keys.begin());
+        }
+    }
+
+    // The pool may have grown, so only touch the node through its index.
+    pool[index].mass = mass;
+    pool[index].centre_of_mass = weighted * (1.0f / mass);
+    pool[index].next = static_cast<size_t>(pool.size());
+}
+
+fizx::vec3f fizx::Octree::field(const vec3f& point, real theta, real softening, size_t skip) const
+{
+    vec3f acc;
+    const real softening_squared = softening * softening;
+    const real theta_squared = theta * theta;
+    const size_t end = static_cast<size_t>(nodes.size());
+
+    size_t i = 0;
+    while (i < end)
+    {
+        const OctreeNode& node = nodes[i];
+        bool contains_skip = node.body_begin <= skip && skip < node.body_end;
+
+        if (node.next == i + 1)
+        {
+            // Leaf, sum its bodies directly.
+            for (size_t k = node.body_begin; k < node.body_end; ++k)
+            {
+                if (k == skip) continue;
+                vec3f d = body_positions[k] - point;
+                real distance_squared = d * d + softening_squared;
+                if (distance_squared <= 0.0f) continue;
+                acc.add_scaled_vector(d, body_masses[k] / (distance_squared * std::sqrt(distance_squared)));
+            }
+            i = node.next;
+            continue;
+        }
+
+        vec3f d = node.centre_of_mass - point;
+        real distance_squared = d * d + softening_squared;
+        if (!contains_skip && distance_squared > 0.0f && node.size * node.size < theta_squared * distance_squared)
+        {
+            // Far enough away to be treated as a single mass.
+            acc.add_scaled_vector(d, node.mass / (distance_squared * std::sqrt(distance_squared)));
+            i = node.next;
+        }
+        else
+        {
+            // Open the node, its first child is the next node.
+            ++i;
+        }
+    }
+    return acc;
+}
+
+const fizx::Octree::node_list& fizx::Octree::get_nodes() const
+{
+    return nodes;
+}
+
+fizx::size_t fizx::Octree::size() const
+{
+    return static_cast<size_t>(keys.size());
+}
+
+fizx::size_t fizx::Octree::body_index(size_t order) const
+{
+    return keys[order].second;
+}
+
+fizx::NBodyGravity::NBodyGravity(real gravitational_constant, real theta, real softening)
+: gravitational_constant(gravitational_constant), theta(0), softening(0)
+{
+    set_theta(theta);
+    set_softening(softening);
+}
+
+void fizx::NBodyGravity::set_theta(real value)
+{
+    if (value < 0.0f) throw std::domain_error("Opening angle cannot be negative");
+    theta = value;
+}
+
+fizx::real fizx::NBodyGravity::get_theta() const
+{
+    return theta;
+}
+
+void fizx::NBodyGravity::set_softening(real value)
+{
+    if (value < 0.0f) throw std::domain_error("Softening cannot be negative");
+    softening = value;
+}
+
+void fizx::NBodyGravity::apply(std::vector<Particle>& particles)
+{
+    size_t count = static_cast<size_t>(particles.size());
+    positions.resize(count);
+    masses.resize(count);
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            positions[i] = particles[i].get_position();
+            masses[i] = particles[i].has_finite_mass() ? particles[i].get_mass() : 0.0f;
+        }
+    });
+
+    tree.build(positions.data(), masses.data(), count);
+
+    // Walk bodies in Morton order so neighbouring threads traverse similar parts of the tree.
+    parallel_for(tree.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t k = begin; k < end; ++k)
+        {
+            size_t i = tree.body_index(k);
+            vec3f g = tree.field(positions[i], theta, softening, k);
+            particles[i].add_force(g * (gravitational_constant * masses[i]));
+        }
+    }, 256);
+}
+
+const fizx::Octree& fizx::NBodyGravity::get_tree() const
+{
+    return tree;
+}
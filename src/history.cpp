@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cstring>
+#include <FIZX/history.hpp>
+
+namespace
+{
+
+std::uint64_t to_bits(fizx::real value)
+{
+    static_assert(sizeof(fizx::real) <= sizeof(std::uint64_t), "real must fit in 64 bits");
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(value));
+    return bits;
+}
+
+fizx::real from_bits(std::uint64_t bits)
+{
+    fizx::real value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Writes a 64 bit word without its leading and trailing zero bytes.
+ * A header byte holds the number of leading (high nibble) and trailing (low nibble) zero bytes.
+*/
+void write_stripped(fizx::tracked_vector<std::uint8_t, fizx::Subsystem::history>& out, std::uint64_t word)
+{
+    if (word == 0)
+    {
+        out.push_back(0x80);
+        return;
+    }
+    int lead = 0, trail = 0;
+    while (((word >> (56 - 8 * lead)) & 0xff) == 0) ++lead;
+    while (((word >> (8 * trail)) & 0xff) == 0) ++trail;
+    out.push_back(static_cast<std::uint8_t>(lead << 4 | trail));
+    for (int b = trail; b < 8 - lead; ++b)
+    {
+        out.push_back(static_cast<std::uint8_t>(word >> (8 * b)));
+    }
+}
+
+std::uint64_t read_stripped(const std::uint8_t*& in)
+{
+    int lead = *in >> 4;
+    int trail = *in & 0xf;
+    ++in;
+    std::uint64_t word = 0;
+    for (int b = trail; b < 8 - lead; ++b)
+    {
+        word |= static_cast<std::uint64_t>(*in++) << (8 * b);
+    }
+    return word;
+}
+
+/**
+ * Writes a signed integer as a zigzag varint, 7 bits per byte.
+*/
+void write_varint(fizx::tracked_vector<std::uint8_t, fizx::Subsystem::history>& out, std::int64_t value)
+{
+    std::uint64_t zigzag = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        out.push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(zigzag));
+}
+
+std::int64_t read_varint(const std::uint8_t*& in)
+{
+    std::uint64_t zigzag = 0;
+    int shift = 0;
+    while (*in & 0x80)
+    {
+        zigzag |= static_cast<std::uint64_t>(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    zigzag |= static_cast<std::uint64_t>(*in++) << shift;
+    return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+}
+
+} // namespace
+
+template <fizx::size_t Dim>
+fizx::BasicHistory<Dim>::BasicHistory(size_t keyframe_interval, std::size_t budget, real quantum)
+: keyframe_interval(std::max<size_t>(1, keyframe_interval)), budget(budget), quantum(std::max<real>(0, quantum))
+{}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::gather(const std::vector<particle_type>& particles, real_list& values) const
+{
+    // Column layout: every position, then every velocity.
+    size_t count = static_cast<size_t>(particles.size());
+    values.resize(2 * Dim * count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        vec_type position = particles[i].get_position();
+        vec_type velocity = particles[i].get_velocity();
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            values[Dim * i + d] = position[d];
+            values[Dim * (count + i) + d] = velocity[d];
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::scatter(const real_list& values, std::vector<particle_type>& particles) const
+{
+    size_t count = static_cast<size_t>(particles.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        vec_type position, velocity;
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            position[d] = values[Dim * i + d];
+            velocity[d] = values[Dim * (count + i) + d];
+        }
+        particles[i].set_position(position);
+        particles[i].set_velocity(velocity);
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::record(size_t step, const std::vector<particle_type>& particles)
+{
+    if (!segments.empty() && step <= newest_step())
+        throw std::logic_error("Steps must be recorded in increasing order");
+
+    size_t count = static_cast<size_t>(particles.size());
+    gather(particles, current);
+
+    bool keyframe = segments.empty()
+        || segments.back().count != count
+        || static_cast<size_t>(segments.back().steps.size()) >= keyframe_interval;
+    if (keyframe)
+    {
+        segments.push_back(Segment{step, count, {}, {}, {}});
+        previous.assign(current.size(), 0);
+    }
+
+    Segment& segment = segments.back();
+    segment.steps.push_back(step);
+    segment.offsets.push_back(static_cast<size_t>(segment.data.size()));
+
+    if (keyframe || quantum <= 0)
+    {
+        // Keyframes are stored as a XOR against zero, so both paths share the encoding.
+        for (size_t v = 0; v < static_cast<size_t>(current.size()); ++v)
+        {
+            write_stripped(segment.data, to_bits(current[v]) ^ to_bits(previous[v]));
+            previous[v] = current[v];
+        }
+    }
+    else
+    {
+        // Deltas are taken against the decoded previous step, so the error never accumulates.
+        for (size_t v = 0; v < static_cast<size_t>(current.size()); ++v)
+        {
+            std::int64_t steps = std::llround((current[v] - previous[v]) / quantum);
+            write_varint(segment.data, steps);
+            previous[v] += static_cast<real>(steps) * quantum;
+        }
+    }
+
+    enforce_budget();
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::decode(const Segment& segment, size_t frame, real_list& values) const
+{
+    values.assign(2 * Dim * segment.count, 0);
+    for (size_t f = 0; f <= frame; ++f)
+    {
+        const std::uint8_t* in = segment.data.data() + segment.offsets[f];
+        if (f == 0 || quantum <= 0)
+        {
+            for (real& value : values)
+            {
+                value = from_bits(to_bits(value) ^ read_stripped(in));
+            }
+        }
+        else
+        {
+            for (real& value : values)
+            {
+                value += static_cast<real>(read_varint(in)) * quantum;
+            }
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicHistory<Dim>::Segment& fizx::BasicHistory<Dim>::find(size_t step, size_t& frame) const
+{
+    for (auto segment = segments.rbegin(); segment != segments.rend(); ++segment)
+    {
+        if (segment->first_step > step) continue;
+        auto found = std::lower_bound(segment->steps.begin(), segment->steps.end(), step);
+        if (found == segment->steps.end() || *found != step) break;
+        frame = static_cast<size_t>(found - segment->steps.begin());
+        return *segment;
+    }
+    throw std::out_of_range("Step is not in the history");
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::load(size_t step, std::vector<particle_type>& particles) const
+{
+    size_t frame = 0;
+    const Segment& segment = find(step, frame);
+    if (static_cast<size_t>(particles.size()) != segment.count)
+        throw std::invalid_argument("Particle count does not match the recorded step");
+
+    real_list values;
+    decode(segment, frame, values);
+    scatter(values, particles);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::rewind(size_t step, std::vector<particle_type>& particles)
+{
+    size_t frame = 0;
+    const Segment& found = find(step, frame);
+    if (static_cast<size_t>(particles.size()) != found.count)
+        throw std::invalid_argument("Particle count does not match the recorded step");
+
+    while (&segments.back() != &found)
+    {
+        segments.pop_back();
+    }
+    Segment& segment = segments.back();
+    if (frame + 1 < static_cast<size_t>(segment.steps.size()))
+    {
+        segment.data.resize(segment.offsets[frame + 1]);
+        segment.steps.resize(frame + 1);
+        segment.offsets.resize(frame + 1);
+    }
+
+    // The restored step is the reference for whatever gets recorded next.
+    decode(segment, frame, previous);
+    scatter(previous, particles);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::enforce_budget()
+{
+    while (segments.size() > 1 && bytes() > budget)
+    {
+        segments.pop_front();
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicHistory<Dim>::clear()
+{
+    segments.clear();
+    previous.clear();
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicHistory<Dim>::contains(size_t step) const
+{
+    for (const Segment& segment : segments)
+    {
+        if (std::binary_search(segment.steps.begin(), segment.steps.end(), step)) return true;
+    }
+    return false;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicHistory<Dim>::oldest_step() const
+{
+    if (segments.empty()) throw std::out_of_range("History is empty");
+    return segments.front().first_step;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicHistory<Dim>::newest_step() const
+{
+    if (segments.empty()) throw std::out_of_range("History is empty");
+    return segments.back().steps.back();
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicHistory<Dim>::size() const
+{
+    size_t total = 0;
+    for (const Segment& segment : segments)
+    {
+        total += static_cast<size_t>(segment.steps.size());
+    }
+    return total;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicHistory<Dim>::bytes() const
+{
+    std::size_t total = 0;
+    for (const Segment& segment : segments)
+    {
+        total += segment.data.size() + 2 * sizeof(size_t) * segment.steps.size();
+    }
+    return total;
+}
+
+template class fizx::BasicHistory<2>;
+template class fizx::BasicHistory<3>;
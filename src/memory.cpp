@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cstdint>
+#include <FIZX/memory.hpp>
+
+namespace
+{
+
+class DefaultAllocator : public fizx::Allocator
+{
+public:
+    void* allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void deallocate(void* pointer, std::size_t, std::size_t alignment) override
+    {
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+};
+
+DefaultAllocator default_allocator;
+
+/**
+ * Alignment of arena blocks, a cache line.
+*/
+constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+} // namespace
+
+fizx::BudgetExceeded::BudgetExceeded(Subsystem subsystem, std::size_t bytes)
+: subsystem(subsystem), bytes(bytes)
+{
+}
+
+const char* fizx::BudgetExceeded::what() const noexcept
+{
+    return "Memory budget exceeded";
+}
+
+fizx::MemoryAccount::MemoryAccount()
+: budget(0), allocator(&default_allocator)
+{
+}
+
+void fizx::MemoryAccount::raise_peak(Counter& counter, std::size_t value)
+{
+    std::size_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (value > peak && !counter.peak.compare_exchange_weak(peak, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void* fizx::MemoryAccount::allocate(Subsystem subsystem, std::size_t bytes, std::size_t alignment)
+{
+    charge(subsystem, bytes);
+    try
+    {
+        return get_allocator().allocate(bytes, alignment);
+    }
+    catch (...)
+    {
+        release(subsystem, bytes);
+        throw;
+    }
+}
+
+void fizx::MemoryAccount::deallocate(Subsystem subsystem, void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    if (!pointer) return;
+    get_allocator().deallocate(pointer, bytes, alignment);
+    release(subsystem, bytes);
+}
+
+void fizx::MemoryAccount::charge(Subsystem subsystem, std::size_t bytes)
+{
+    // Claim the bytes first so concurrent allocations cannot all pass the check together.
+    const std::size_t limit = budget.load(std::memory_order_relaxed);
+    const std::size_t now = total.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (limit != 0 && now > limit)
+    {
+        total.current.fetch_sub(bytes, std::memory_order_relaxed);
+        throw BudgetExceeded(subsystem, bytes);
+    }
+    raise_peak(total, now);
+    Counter& counter = counters[static_cast<int>(subsystem)];
+    raise_peak(counter, counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void fizx::MemoryAccount::release(Subsystem subsystem, std::size_t bytes)
+{
+    counters[static_cast<int>(subsystem)].current.fetch_sub(bytes, std::memory_order_relaxed);
+    total.current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::size_t fizx::MemoryAccount::get_current(Subsystem subsystem) const
+{
+    return counters[static_cast<int>(subsystem)].current.load(std::memory_order_relaxed);
+}
+
+std::size_t fizx::MemoryAccount::get_peak(Subsystem subsystem) const
+{
+    return counters[static_cast<int>(subsystem)].peak.load(std::memory_order_relaxed);
+}
+
+std::size_t fizx::MemoryAccount::get_total() const
+{
+    return total.current.load(std::memory_order_relaxed);
+}
+
+std::size_t fizx::MemoryAccount::get_total_peak() const
+{
+    return total.peak.load(std::memory_order_relaxed);
+}
+
+void fizx::MemoryAccount::reset_peaks()
+{
+    for (Counter& counter : counters)
+    {
+        counter.peak.store(counter.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total.peak.store(total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void fizx::MemoryAccount::set_budget(std::size_t bytes)
+{
+    budget.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t fizx::MemoryAccount::get_budget() const
+{
+    return budget.load(std::memory_order_relaxed);
+}
+
+void fizx::MemoryAccount::set_allocator(Allocator* allocator)
+{
+    this->allocator.store(allocator ? allocator : &default_allocator);
+}
+
+fizx::Allocator& fizx::MemoryAccount::get_allocator() const
+{
+    return *allocator.load();
+}
+
+fizx::MemoryAccount& fizx::MemoryAccount::shared()
+{
+    static MemoryAccount account;
+    return account;
+}
+
+fizx::ScratchArena::ScratchArena(std::size_t block_size)
+: block_size(block_size), current(0), offset(0), used(0)
+{
+}
+
+fizx::ScratchArena::~ScratchArena()
+{
+    free_blocks();
+}
+
+void fizx::ScratchArena::add_block(std::size_t bytes)
+{
+    blocks.reserve(blocks.size() + 1);
+    void* data = MemoryAccount::shared().allocate(Subsystem::scratch, bytes, BLOCK_ALIGNMENT);
+    blocks.push_back(Block{static_cast<unsigned char*>(data), bytes});
+}
+
+void fizx::ScratchArena::free_blocks()
+{
+    for (const Block& block : blocks)
+    {
+        MemoryAccount::shared().deallocate(Subsystem::scratch, block.data, block.size, BLOCK_ALIGNMENT);
+    }
+    blocks.clear();
+}
+
+void* fizx::ScratchArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    for (; current < blocks.size(); ++current, offset = 0)
+    {
+        const Block& block = blocks[current];
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data + offset);
+        const std::size_t padding = (alignment - address % alignment) % alignment;
+        if (offset + padding + bytes <= block.size)
+        {
+            void* result = block.data + offset + padding;
+            offset += padding + bytes;
+            used += padding + bytes;
+            return result;
+        }
+    }
+    add_block(std::max(block_size, bytes + alignment));
+    current = blocks.size() - 1;
+    offset = 0;
+    return allocate(bytes, alignment);
+}
+
+void fizx::ScratchArena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        const std::size_t capacity = get_capacity();
+        free_blocks();
+        add_block(capacity);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+std::size_t fizx::ScratchArena::get_used() const
+{
+    return used;
+}
+
+std::size_t fizx::ScratchArena::get_capacity() const
+{
+    std::size_t capacity = 0;
+    for (const Block& block : blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <atomic>
+#include <FIZX/neighbour.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicNeighbourList<Dim>::BasicNeighbourList(real cutoff, real skin)
+: cutoff(0), skin(0), build_count(0)
+{
+    set_cutoff(cutoff);
+    set_skin(skin);
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicNeighbourList<Dim>::update(const std::vector<particle_type>& particles)
+{
+    if (!needs_rebuild(particles)) return false;
+    build(particles);
+    return true;
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicNeighbourList<Dim>::needs_rebuild(const std::vector<particle_type>& particles) const
+{
+    size_t count = static_cast<size_t>(particles.size());
+    if (static_cast<size_t>(offsets.size()) != count + 1) return true;
+
+    const real limit = 0.25f * skin * skin;
+    std::atomic<bool> moved{false};
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end && !moved.load(std::memory_order_relaxed); ++i)
+        {
+            vec_type d = particles[i].get_position() - reference_positions[i];
+            if (d * d > limit)
+            {
+                moved.store(true, std::memory_order_relaxed);
+            }
+        }
+    });
+    return moved.load();
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicNeighbourList<Dim>::build(const std::vector<particle_type>& particles)
+{
+    size_t count = static_cast<size_t>(particles.size());
+    reference_positions.resize(count);
+    offsets.assign(count + 1, 0);
+    indices.clear();
+    ++build_count;
+    if (count == 0) return;
+
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            reference_positions[i] = particles[i].get_position();
+        }
+    });
+
+    // Bin the particles into a uniform grid with cells no smaller than the list radius.
+    const real radius = cutoff + skin;
+    vec_type lower = reference_positions[0];
+    vec_type upper = lower;
+    for (const vec_type& p : reference_positions)
+    {
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            lower[d] = std::min(lower[d], p[d]);
+            upper[d] = std::max(upper[d], p[d]);
+        }
+    }
+    // Cap the cells per axis so sparse scenes do not allocate a huge empty grid.
+    const real max_cells = std::max(1.0, std::pow(static_cast<real>(count), 1.0 / Dim) * 2.0);
+    size_t dims[Dim];
+    real cell_size[Dim];
+    size_t cell_count = 1;
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        real extent = upper[d] - lower[d];
+        dims[d] = static_cast<size_t>(std::max(1.0, std::min(max_cells, std::floor(extent / radius))));
+        cell_size[d] = std::max(radius, extent / dims[d]);
+        cell_count *= dims[d];
+    }
+    auto cell_coord = [&](const vec_type& p, size_t d)
+    {
+        return std::min(dims[d] - 1, static_cast<size_t>((p[d] - lower[d]) / cell_size[d]));
+    };
+    // Cells are numbered with the first axis varying fastest.
+    auto cell_index = [&](const size_t* coords)
+    {
+        size_t cell = 0;
+        for (size_t d = Dim; d-- > 0;)
+        {
+            cell = cell * dims[d] + coords[d];
+        }
+        return cell;
+    };
+
+    cell_offsets.assign(cell_count + 1, 0);
+    particle_cells.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t coords[Dim];
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            coords[d] = cell_coord(reference_positions[i], d);
+        }
+        particle_cells[i] = cell_index(coords);
+        ++cell_offsets[particle_cells[i] + 1];
+    }
+    for (size_t c = 0; c < cell_count; ++c)
+    {
+        cell_offsets[c + 1] += cell_offsets[c];
+    }
+    cell_particles.resize(count);
+    {
+        index_list fill(cell_offsets.begin(), cell_offsets.end() - 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            cell_particles[fill[particle_cells[i]]++] = i;
+        }
+    }
+
+    // Visits every particle within the radius of particle i, searching the 3^Dim cells around it.
+    const real radius_squared = radius * radius;
+    auto for_each_neighbour = [&](size_t i, auto&& visit)
+    {
+        const vec_type& p = reference_positions[i];
+        size_t first[Dim], last[Dim], coords[Dim];
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            size_t c = cell_coord(p, d);
+            first[d] = c > 0 ? c - 1 : 0;
+            last[d] = std::min(dims[d] - 1, c + 1);
+            coords[d] = first[d];
+        }
+        while (true)
+        {
+            size_t cell = cell_index(coords);
+            for (size_t k = cell_offsets[cell]; k < cell_offsets[cell + 1]; ++k)
+            {
+                size_t j = cell_particles[k];
+                if (j == i) continue;
+                vec_type d = reference_positions[j] - p;
+                if (d * d <= radius_squared) visit(j);
+            }
+
+            // Advance to the next cell of the block, like an odometer.
+            size_t d = 0;
+            while (d < Dim && coords[d] == last[d])
+            {
+                coords[d] = first[d];
+                ++d;
+            }
+            if (d == Dim) break;
+            ++coords[d];
+        }
+    };
+
+    // Two passes: count the neighbours, then write them at their prefix sum offsets.
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t n = 0;
+            for_each_neighbour(i, [&](size_t) { ++n; });
+            offsets[i + 1] = n;
+        }
+    }, 256);
+    for (size_t i = 0; i < count; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    indices.resize(offsets[count]);
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t k = offsets[i];
+            for_each_neighbour(i, [&](size_t j) { indices[k++] = j; });
+        }
+    }, 256);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicNeighbourList<Dim>::set_cutoff(real value)
+{
+    if (value <= 0.0f) throw std::domain_error("Cutoff must be positive");
+    cutoff = value;
+    offsets.clear();
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicNeighbourList<Dim>::set_skin(real value)
+{
+    if (value < 0.0f) throw std::domain_error("Skin cannot be negative");
+    skin = value;
+    offsets.clear();
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicNeighbourList<Dim>::get_cutoff() const
+{
+    return cutoff;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicNeighbourList<Dim>::get_skin() const
+{
+    return skin;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicNeighbourList<Dim>::index_list& fizx::BasicNeighbourList<Dim>::get_offsets() const
+{
+    return offsets;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicNeighbourList<Dim>::index_list& fizx::BasicNeighbourList<Dim>::get_indices() const
+{
+    return indices;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicNeighbourList<Dim>::neighbour_count(size_t index) const
+{
+    return offsets[index + 1] - offsets[index];
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicNeighbourList<Dim>::get_build_count() const
+{
+    return build_count;
+}
+
+template class fizx::BasicNeighbourList<2>;
+template class fizx::BasicNeighbourList<3>;
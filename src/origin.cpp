@@ -0,0 +1,170 @@
+#include <cmath>
+#include <stdexcept>
+#include <FIZX/origin.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicFloatingOrigin<Dim>::BasicFloatingOrigin(const anchor_type& anchor, double rebase_distance)
+: anchor(anchor), damping(1), focus(NO_FOCUS), focus_point(anchor), rebase_distance(0), rebase_count(0)
+{
+    set_rebase_distance(rebase_distance);
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicFloatingOrigin<Dim>::add(const anchor_type& position, const offset_type& velocity, float inverse_mass)
+{
+    if (inverse_mass < 0) throw std::domain_error("Inverse mass cannot be negative");
+    offsets.push_back(offset_type(position - anchor));
+    velocities.push_back(velocity);
+    net_forces.push_back(offset_type());
+    inverse_masses.push_back(inverse_mass);
+    return static_cast<size_t>(offsets.size()) - 1;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::integrate(float duration)
+{
+    if (duration <= 0) throw std::domain_error("Duration must be positive");
+
+    const float drag = std::pow(damping, duration);
+    parallel_for(size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (inverse_masses[i] <= 0) continue;
+            offsets[i] += velocities[i] * duration;
+            velocities[i] += (acceleration + net_forces[i] * inverse_masses[i]) * duration;
+            velocities[i] *= drag;
+            net_forces[i] = offset_type();
+        }
+    });
+    rebase_if_needed();
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicFloatingOrigin<Dim>::rebase_if_needed()
+{
+    anchor_type target = focus != NO_FOCUS && focus < size() ? get_position(focus) : focus_point;
+    anchor_type drift = target - anchor;
+    if (drift * drift <= rebase_distance * rebase_distance) return false;
+    rebase(target);
+    return true;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::rebase(const anchor_type& anchor)
+{
+    // Shift in double, so particles near the new anchor get precise offsets.
+    const anchor_type shift = anchor - this->anchor;
+    parallel_for(size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            offsets[i] = offset_type(anchor_type(offsets[i]) - shift);
+        }
+    });
+    this->anchor = anchor;
+    ++rebase_count;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_focus(size_t index)
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    focus = index;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_focus_point(const anchor_type& point)
+{
+    focus = NO_FOCUS;
+    focus_point = point;
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicFloatingOrigin<Dim>::anchor_type fizx::BasicFloatingOrigin<Dim>::get_position(size_t index) const
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    return anchor + anchor_type(offsets[index]);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_position(size_t index, const anchor_type& position)
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    offsets[index] = offset_type(position - anchor);
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicFloatingOrigin<Dim>::offset_type fizx::BasicFloatingOrigin<Dim>::get_offset(size_t index) const
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    return offsets[index];
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicFloatingOrigin<Dim>::offset_type fizx::BasicFloatingOrigin<Dim>::get_velocity(size_t index) const
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    return velocities[index];
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_velocity(size_t index, const offset_type& velocity)
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    velocities[index] = velocity;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::add_force(size_t index, const offset_type& force)
+{
+    if (index < 0 || index >= size()) throw std::runtime_error("Index Out of Bounds");
+    net_forces[index] += force;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_acceleration(const offset_type& acceleration)
+{
+    this->acceleration = acceleration;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_damping(float damping)
+{
+    if (damping < 0 || damping > 1) throw std::domain_error("Damping must be in [0, 1]");
+    this->damping = damping;
+}
+
+template <fizx::size_t Dim>
+float fizx::BasicFloatingOrigin<Dim>::get_damping() const
+{
+    return damping;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicFloatingOrigin<Dim>::anchor_type& fizx::BasicFloatingOrigin<Dim>::get_anchor() const
+{
+    return anchor;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicFloatingOrigin<Dim>::set_rebase_distance(double distance)
+{
+    if (distance <= 0) throw std::domain_error("Rebase distance must be positive");
+    rebase_distance = distance;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicFloatingOrigin<Dim>::get_rebase_count() const
+{
+    return rebase_count;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicFloatingOrigin<Dim>::size() const
+{
+    return static_cast<size_t>(offsets.size());
+}
+
+template class fizx::BasicFloatingOrigin<2>;
+template class fizx::BasicFloatingOrigin<3>;
@@ -1,7 +1,10 @@
 #include <assert.h>
+#include <type_traits>
 #include <FIZX/particle.hpp>
+#include <FIZX/dispatch.hpp>
 
-void fizx::Particle::integrate(real duration)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::integrate(real duration)
 {
     // We don't integreate things with infinite mass.
     if (inverse_mass <= 0.0f) return;
@@ -12,7 +15,8 @@ void fizx::Particle::integrate(real duration)
     position.add_scaled_vector(velocity, duration);
 
     // Work out the acceleration from the force.
-    vec3f resulting_acc = acceleration;
+    vec_type resulting_acc = acceleration;
+    resulting_acc.add_scaled_vector(net_force, inverse_mass);
 
     // Update linear velocity from the acceleration.
     velocity.add_scaled_vector(resulting_acc, duration);
@@ -24,49 +28,97 @@ void fizx::Particle::integrate(real duration)
     clear_forces();
 }
 
-void fizx::Particle::set_mass(real mass)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::integrate_batch(BasicParticle* particles, std::size_t count, real duration)
+{
+    // The kernels see particles as packed reals, in the order the members are declared.
+    static_assert(std::is_standard_layout<BasicParticle>::value, "Particle layout must be standard");
+    static_assert(sizeof(BasicParticle) == (4 * Dim + 2) * sizeof(real), "Particle must be packed reals");
+
+    assert(duration > 0.0);
+    kernels().integrate_particles(reinterpret_cast<real*>(particles), count, Dim, duration);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::set_mass(real mass)
 {
     if (mass == 0) throw std::domain_error("Mass cannot be zero");
     if (mass < 0.0f) inverse_mass = 0.0f;
     else inverse_mass = 1.0f / mass;
 }
 
-void fizx::Particle::set_position(vec3f pos)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::set_position(vec_type pos)
 {
     position = pos;
 }
 
-void fizx::Particle::set_velocity(vec3f vel)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::set_velocity(vec_type vel)
 {
     velocity = vel;
 }
 
-void fizx::Particle::set_acceleration(vec3f acc)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::set_acceleration(vec_type acc)
 {
     acceleration = acc;
 }
 
-void fizx::Particle::add_force(vec3f force)
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::add_force(vec_type force)
 {
     net_force += force;
 }
 
-void fizx::Particle::clear_forces()
+template <fizx::size_t Dim>
+void fizx::BasicParticle<Dim>::clear_forces()
 {
-    net_force = vec3f(0, 0, 0);
+    net_force = vec_type();
 }
 
-fizx::vec3f fizx::Particle::get_position() const
+template <fizx::size_t Dim>
+typename fizx::BasicParticle<Dim>::vec_type fizx::BasicParticle<Dim>::get_position() const
 {
     return position;
 }
 
-fizx::vec3f fizx::Particle::get_velocity() const
+template <fizx::size_t Dim>
+typename fizx::BasicParticle<Dim>::vec_type fizx::BasicParticle<Dim>::get_velocity() const
 {
     return velocity;
 }
 
-fizx::vec3f fizx::Particle::get_acceleration() const
+template <fizx::size_t Dim>
+typename fizx::BasicParticle<Dim>::vec_type fizx::BasicParticle<Dim>::get_acceleration() const
 {
     return acceleration;
-}
\ No newline at end of file
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicParticle<Dim>::vec_type fizx::BasicParticle<Dim>::get_net_force() const
+{
+    return net_force;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicParticle<Dim>::get_mass() const
+{
+    if (inverse_mass == 0.0f) return -1.0f;
+    return 1.0f / inverse_mass;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicParticle<Dim>::get_inverse_mass() const
+{
+    return inverse_mass;
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicParticle<Dim>::has_finite_mass() const
+{
+    return inverse_mass > 0.0f;
+}
+
+template class fizx::BasicParticle<2>;
+template class fizx::BasicParticle<3>;
@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <FIZX/query.hpp>
+
+namespace
+{
+
+/**
+ * Calls func(coords) for every cell from lo to hi inclusive, the first axis varying fastest.
+*/
+template <fizx::size_t Dim, class Function>
+void for_cells(const fizx::size_t* lo, const fizx::size_t* hi, Function func)
+{
+    fizx::size_t coords[Dim];
+    std::copy(lo, lo + Dim, coords);
+    while (true)
+    {
+        func(coords);
+        fizx::size_t d = 0;
+        while (d < Dim && ++coords[d] > hi[d])
+        {
+            coords[d] = lo[d];
+            ++d;
+        }
+        if (d == Dim) return;
+    }
+}
+
+} // namespace
+
+template <fizx::size_t Dim>
+fizx::BasicSceneQuery<Dim>::BasicSceneQuery(real radius, real cell_size)
+: radius(0), cell_size(0), cell(1), cell_offsets(2, 0)
+{
+    set_radius(radius);
+    set_cell_size(cell_size);
+    std::fill(dims, dims + Dim, 1);
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicSceneQuery<Dim>::cell_coord(real x, size_t d) const
+{
+    const real c = std::floor((x - lower[d]) / cell);
+    if (!(c > 0)) return 0;
+    return c >= dims[d] ? dims[d] - 1 : static_cast<size_t>(c);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::build(const std::vector<particle_type>& particles)
+{
+    const size_t count = static_cast<size_t>(particles.size());
+    positions.resize(count);
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            positions[i] = particles[i].get_position();
+        }
+    });
+    std::fill(dims, dims + Dim, 1);
+    cell_offsets.assign(2, 0);
+    cell_particles.clear();
+    if (count == 0) return;
+
+    // Grid over the bounds of the spheres, not only their centres.
+    lower = positions[0];
+    vec_type upper = lower;
+    for (const vec_type& p : positions)
+    {
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            lower[d] = std::min(lower[d], p[d]);
+            upper[d] = std::max(upper[d], p[d]);
+        }
+    }
+    real volume = 1;
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        lower[d] -= radius;
+        upper[d] += radius;
+        volume *= upper[d] - lower[d];
+    }
+
+    // Cells at least a diameter across hold a sphere in at most two cells per axis. Left to itself
+    // the grid aims at one cell per particle, and it is never allowed many more cells than that.
+    cell = std::max(2 * radius, cell_size > 0 ? cell_size : std::pow(volume / count, real(1) / Dim));
+    if (!(cell > 0)) cell = 1;
+    const real max_cells = 4.0 * count + 16;
+    while (true)
+    {
+        real cells = 1;
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            cells *= std::max<real>(1, std::ceil((upper[d] - lower[d]) / cell));
+        }
+        if (cells <= max_cells) break;
+        cell *= 1.25;
+    }
+    std::size_t total = 1;
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        dims[d] = static_cast<size_t>(std::max<real>(1, std::ceil((upper[d] - lower[d]) / cell)));
+        total *= dims[d];
+    }
+
+    // Counting sort of every sphere into the cells its bounds overlap.
+    auto cell_index = [&](const size_t* coords)
+    {
+        size_t index = 0;
+        for (size_t d = Dim; d-- > 0;)
+        {
+            index = index * dims[d] + coords[d];
+        }
+        return index;
+    };
+    auto sphere_cells = [&](size_t i, size_t* lo, size_t* hi)
+    {
+        for (size_t d = 0; d < Dim; ++d)
+        {
+            lo[d] = cell_coord(positions[i][d] - radius, d);
+            hi[d] = cell_coord(positions[i][d] + radius, d);
+        }
+    };
+    cell_offsets.assign(total + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t lo[Dim], hi[Dim];
+        sphere_cells(i, lo, hi);
+        for_cells<Dim>(lo, hi, [&](const size_t* coords) { ++cell_offsets[cell_index(coords) + 1]; });
+    }
+    for (std::size_t c = 0; c < total; ++c)
+    {
+        cell_offsets[c + 1] += cell_offsets[c];
+    }
+    cell_particles.resize(cell_offsets[total]);
+    tracked_vector<size_t, Subsystem::broadphase> fill(cell_offsets.begin(), cell_offsets.end() - 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t lo[Dim], hi[Dim];
+        sphere_cells(i, lo, hi);
+        for_cells<Dim>(lo, hi, [&](const size_t* coords) { cell_particles[fill[cell_index(coords)]++] = i; });
+    }
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicSceneQuery<Dim>::RayHit fizx::BasicSceneQuery<Dim>::cast(vec_type origin, vec_type direction,
+    real max_distance) const
+{
+    RayHit hit = {NO_HIT, max_distance};
+    const real length = direction.magnitude();
+    if (positions.empty() || !(length > 0) || !(max_distance >= 0)) return hit;
+    direction *= 1 / length;
+
+    // Clip the ray to the grid, then walk it from cell to cell.
+    real enter = 0, leave = max_distance;
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        const real low = lower[d], high = lower[d] + dims[d] * cell;
+        if (direction[d] == 0)
+        {
+            if (origin[d] < low || origin[d] > high) return hit;
+            continue;
+        }
+        real t0 = (low - origin[d]) / direction[d], t1 = (high - origin[d]) / direction[d];
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        leave = std::min(leave, t1);
+    }
+    if (enter > leave) return hit;
+
+    size_t coords[Dim];
+    int step[Dim];
+    real next[Dim], delta[Dim];
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        coords[d] = cell_coord(origin[d] + direction[d] * enter, d);
+        if (direction[d] == 0)
+        {
+            step[d] = 0;
+            next[d] = delta[d] = std::numeric_limits<real>::infinity();
+            continue;
+        }
+        step[d] = direction[d] > 0 ? 1 : -1;
+        const real boundary = lower[d] + (coords[d] + (direction[d] > 0 ? 1 : 0)) * cell;
+        next[d] = (boundary - origin[d]) / direction[d];
+        delta[d] = cell / std::fabs(direction[d]);
+    }
+
+    const real square_radius = radius * radius;
+    while (true)
+    {
+        size_t index = 0;
+        for (size_t d = Dim; d-- > 0;)
+        {
+            index = index * dims[d] + coords[d];
+        }
+        for (size_t k = cell_offsets[index]; k < cell_offsets[index + 1]; ++k)
+        {
+            const size_t particle = cell_particles[k];
+            const vec_type offset = origin - positions[particle];
+            const real b = offset * direction;
+            const real c = offset * offset - square_radius;
+            if (c > 0 && b > 0) continue;
+            const real discriminant = b * b - c;
+            if (discriminant < 0) continue;
+            const real t = std::max<real>(0, -b - std::sqrt(discriminant));
+            // Ties go to the lowest index so the result does not depend on the cell order.
+            if (t < hit.distance || (t == hit.distance && (hit.particle == NO_HIT || particle < hit.particle)))
+            {
+                hit.particle = particle;
+                hit.distance = t;
+            }
+        }
+
+        // Any hit in a later cell is at least as far as the exit from this one.
+        size_t axis = 0;
+        for (size_t d = 1; d < Dim; ++d)
+        {
+            if (next[d] < next[axis]) axis = d;
+        }
+        const real exit = next[axis];
+        if ((hit.particle != NO_HIT && hit.distance <= exit) || exit > leave) break;
+        if (step[axis] < 0 ? coords[axis] == 0 : coords[axis] + 1 == dims[axis]) break;
+        coords[axis] += step[axis];
+        next[axis] += delta[axis];
+    }
+    if (hit.particle == NO_HIT) hit.distance = max_distance;
+    return hit;
+}
+
+template <fizx::size_t Dim>
+template <class Visit>
+void fizx::BasicSceneQuery<Dim>::visit_cells(const vec_type& low, const vec_type& high, Visit visit) const
+{
+    if (positions.empty()) return;
+    size_t lo[Dim], hi[Dim];
+    for (size_t d = 0; d < Dim; ++d)
+    {
+        if (!(low[d] <= high[d]) || high[d] < lower[d] || low[d] > lower[d] + dims[d] * cell) return;
+        lo[d] = cell_coord(low[d], d);
+        hi[d] = cell_coord(high[d], d);
+    }
+    for_cells<Dim>(lo, hi, [&](const size_t* coords)
+    {
+        size_t index = 0;
+        for (size_t d = Dim; d-- > 0;)
+        {
+            index = index * dims[d] + coords[d];
+        }
+        for (size_t k = cell_offsets[index]; k < cell_offsets[index + 1]; ++k)
+        {
+            // A sphere in several of the cells is reported from the first one both cover.
+            const size_t particle = cell_particles[k];
+            bool first = true;
+            for (size_t d = 0; d < Dim && first; ++d)
+            {
+                first = coords[d] == std::max(lo[d], cell_coord(positions[particle][d] - radius, d));
+            }
+            if (first) visit(particle);
+        }
+    });
+}
+
+template <fizx::size_t Dim>
+template <class Touches>
+void fizx::BasicSceneQuery<Dim>::gather(std::size_t count, std::vector<size_t>& offsets, std::vector<size_t>& indices,
+    Touches touches) const
+{
+    offsets.assign(count + 1, 0);
+    parallel_for(static_cast<size_t>(count), [&](size_t begin, size_t end)
+    {
+        for (size_t q = begin; q < end; ++q)
+        {
+            size_t found = 0;
+            touches(q, [&](size_t) { ++found; });
+            offsets[q + 1] = found;
+        }
+    }, 64);
+    for (std::size_t q = 0; q < count; ++q)
+    {
+        offsets[q + 1] += offsets[q];
+    }
+    indices.resize(offsets[count]);
+    parallel_for(static_cast<size_t>(count), [&](size_t begin, size_t end)
+    {
+        for (size_t q = begin; q < end; ++q)
+        {
+            size_t at = offsets[q];
+            touches(q, [&](size_t particle) { indices[at++] = particle; });
+            std::sort(indices.begin() + offsets[q], indices.begin() + at);
+        }
+    }, 64);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::raycast(const Ray* rays, std::size_t count, RayHit* hits) const
+{
+    // Sort by direction octant, then origin cell, so that the rays of a chunk walk the same cells.
+    tracked_vector<std::pair<std::uint64_t, size_t>, Subsystem::broadphase> order(count);
+    for (std::size_t r = 0; r < count; ++r)
+    {
+        std::uint64_t octant = 0, index = 0;
+        for (size_t d = Dim; d-- > 0;)
+        {
+            octant = octant << 1 | (rays[r].direction[d] < 0);
+            index = index * dims[d] + cell_coord(rays[r].origin[d], d);
+        }
+        order[r] = {octant << 56 | index, static_cast<size_t>(r)};
+    }
+    std::sort(order.begin(), order.end());
+
+    parallel_for(static_cast<size_t>(count), [&](size_t begin, size_t end)
+    {
+        for (size_t k = begin; k < end; ++k)
+        {
+            const Ray& ray = rays[order[k].second];
+            hits[order[k].second] = cast(ray.origin, ray.direction, ray.max_distance);
+        }
+    }, 64);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::raycast(const std::vector<Ray>& rays, std::vector<RayHit>& hits) const
+{
+    hits.resize(rays.size());
+    raycast(rays.data(), rays.size(), hits.data());
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::overlap(const Sphere* spheres, std::size_t count, std::vector<size_t>& offsets,
+    std::vector<size_t>& indices) const
+{
+    gather(count, offsets, indices, [&](size_t q, auto emit)
+    {
+        const Sphere& sphere = spheres[q];
+        const real reach = sphere.radius + radius;
+        vec_type extent;
+        for (size_t d = 0; d < Dim; ++d) extent[d] = sphere.radius;
+        visit_cells(sphere.centre - extent, sphere.centre + extent, [&](size_t particle)
+        {
+            if (sphere.centre.square_distance(positions[particle]) <= reach * reach) emit(particle);
+        });
+    });
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::overlap(const std::vector<Sphere>& spheres, std::vector<size_t>& offsets,
+    std::vector<size_t>& indices) const
+{
+    overlap(spheres.data(), spheres.size(), offsets, indices);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::overlap(const Box* boxes, std::size_t count, std::vector<size_t>& offsets,
+    std::vector<size_t>& indices) const
+{
+    gather(count, offsets, indices, [&](size_t q, auto emit)
+    {
+        const Box& box = boxes[q];
+        visit_cells(box.lower, box.upper, [&](size_t particle)
+        {
+            const vec_type& p = positions[particle];
+            real square = 0;
+            for (size_t d = 0; d < Dim; ++d)
+            {
+                const real outside = std::max<real>(0, std::max(box.lower[d] - p[d], p[d] - box.upper[d]));
+                square += outside * outside;
+            }
+            if (square <= radius * radius) emit(particle);
+        });
+    });
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::overlap(const std::vector<Box>& boxes, std::vector<size_t>& offsets,
+    std::vector<size_t>& indices) const
+{
+    overlap(boxes.data(), boxes.size(), offsets, indices);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::set_radius(real radius)
+{
+    if (radius < 0) throw std::invalid_argument("Particle radius must not be negative");
+    this->radius = radius;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicSceneQuery<Dim>::set_cell_size(real cell_size)
+{
+    if (cell_size < 0) throw std::invalid_argument("Cell size must not be negative");
+    this->cell_size = cell_size;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicSceneQuery<Dim>::get_radius() const
+{
+    return radius;
+}
+
+template <fizx::size_t Dim>
+fizx::real fizx::BasicSceneQuery<Dim>::get_cell() const
+{
+    return cell;
+}
+
+template <fizx::size_t Dim>
+std::size_t fizx::BasicSceneQuery<Dim>::cell_count() const
+{
+    return cell_offsets.size() - 1;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicSceneQuery<Dim>::size() const
+{
+    return static_cast<size_t>(positions.size());
+}
+
+template class fizx::BasicSceneQuery<2>;
+template class fizx::BasicSceneQuery<3>;
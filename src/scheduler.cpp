@@ -0,0 +1,64 @@
+#include <FIZX/scheduler.hpp>
+
+fizx::size_t fizx::TaskGraph::add_task(std::string name, std::function<void()> work)
+{
+    tasks.push_back(Task{std::move(name), std::move(work), {}, 0});
+    return static_cast<size_t>(tasks.size()) - 1;
+}
+
+void fizx::TaskGraph::add_dependency(size_t before, size_t after)
+{
+    if (before < 0 || before >= size() || after < 0 || after >= size())
+        throw std::runtime_error("Index Out of Bounds");
+    if (before == after)
+        throw std::logic_error("Task " + tasks[before].name + " cannot depend on itself");
+    tasks[before].successors.push_back(after);
+    ++tasks[after].dependencies;
+}
+
+void fizx::TaskGraph::launch(size_t task, WorkerPool& pool, TaskGroup& group, std::atomic<size_t>& finished)
+{
+    group.run(pool, [this, task, &pool, &group, &finished]()
+    {
+        tasks[task].work();
+        finished.fetch_add(1);
+        for (size_t next : tasks[task].successors)
+        {
+            if (remaining[next].fetch_sub(1) == 1)
+                launch(next, pool, group, finished);
+        }
+    });
+}
+
+void fizx::TaskGraph::run(WorkerPool& pool)
+{
+    remaining.reset(new std::atomic<size_t>[tasks.size()]);
+    for (size_t t = 0; t < size(); ++t)
+    {
+        remaining[t].store(tasks[t].dependencies);
+    }
+
+    TaskGroup group;
+    std::atomic<size_t> finished{0};
+    for (size_t t = 0; t < size(); ++t)
+    {
+        if (tasks[t].dependencies == 0)
+            launch(t, pool, group, finished);
+    }
+    group.wait(pool);
+
+    if (finished.load() != size())
+        throw std::logic_error("Task graph has a dependency cycle");
+}
+
+fizx::size_t fizx::TaskGraph::size() const
+{
+    return static_cast<size_t>(tasks.size());
+}
+
+const std::string& fizx::TaskGraph::get_name(size_t task) const
+{
+    if (task < 0 || task >= size())
+        throw std::runtime_error("Index Out of Bounds");
+    return tasks[task].name;
+}
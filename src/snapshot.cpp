@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <stdexcept>
+#include <FIZX/snapshot.hpp>
+
+template <fizx::size_t Dim>
+void fizx::BasicStateView<Dim>::release()
+{
+    if (!buffer) return;
+    buffer->slots[slot].readers.fetch_sub(1, std::memory_order_release);
+    buffer = nullptr;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicStateView<Dim>::vec_list& fizx::BasicStateView<Dim>::positions() const
+{
+    if (!buffer) throw std::logic_error("State view is empty");
+    return buffer->slots[slot].positions;
+}
+
+template <fizx::size_t Dim>
+const typename fizx::BasicStateView<Dim>::vec_list& fizx::BasicStateView<Dim>::velocities() const
+{
+    if (!buffer) throw std::logic_error("State view is empty");
+    return buffer->slots[slot].velocities;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicStateView<Dim>::version() const
+{
+    if (!buffer) throw std::logic_error("State view is empty");
+    return buffer->slots[slot].version;
+}
+
+template <fizx::size_t Dim>
+fizx::BasicStateBuffer<Dim>::BasicStateBuffer(size_t slot_count)
+: slots(new Slot[std::max<size_t>(2, slot_count)]), slot_count(std::max<size_t>(2, slot_count)), latest(-1), skipped(0)
+{
+    for (size_t s = 0; s < this->slot_count; ++s)
+    {
+        slots[s].readers.store(0, std::memory_order_relaxed);
+        slots[s].version = -1;
+    }
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicStateBuffer<Dim>::publish(const std::vector<particle_type>& particles, size_t version)
+{
+    // Claim a slot that is not the latest and that no reader holds.
+    int current = latest.load(std::memory_order_relaxed);
+    int claimed = -1;
+    for (size_t s = 0; s < slot_count && claimed < 0; ++s)
+    {
+        if (static_cast<int>(s) == current) continue;
+        int idle = 0;
+        if (slots[s].readers.compare_exchange_strong(idle, WRITING, std::memory_order_acquire))
+            claimed = s;
+    }
+    if (claimed < 0)
+    {
+        skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = slots[claimed];
+    size_t count = static_cast<size_t>(particles.size());
+    try
+    {
+        slot.positions.resize(count);
+        slot.velocities.resize(count);
+    }
+    catch (...)
+    {
+        // Growing can go over the memory budget. Hand the claim back, or the slot is lost for good;
+        // it is not the latest, so no reader looks at what is left in it.
+        slot.readers.store(0, std::memory_order_release);
+        throw;
+    }
+    slot.version = version;
+    parallel_for(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            slot.positions[i] = particles[i].get_position();
+            slot.velocities[i] = particles[i].get_velocity();
+        }
+    });
+
+    // Publish before unlocking, so a reader that gets in always finds a complete step.
+    latest.store(claimed, std::memory_order_release);
+    slot.readers.store(0, std::memory_order_release);
+    return true;
+}
+
+template <fizx::size_t Dim>
+typename fizx::BasicStateBuffer<Dim>::view_type fizx::BasicStateBuffer<Dim>::acquire()
+{
+    while (true)
+    {
+        int s = latest.load(std::memory_order_acquire);
+        if (s < 0) return view_type();
+
+        // Join the readers of the slot, unless the publisher claimed it since it was read.
+        int readers = slots[s].readers.load(std::memory_order_relaxed);
+        while (readers != WRITING)
+        {
+            if (slots[s].readers.compare_exchange_weak(readers, readers + 1, std::memory_order_acquire))
+                return view_type(this, s);
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicStateBuffer<Dim>::get_skipped() const
+{
+    return skipped.load(std::memory_order_relaxed);
+}
+
+template class fizx::BasicStateView<2>;
+template class fizx::BasicStateView<3>;
+template class fizx::BasicStateBuffer<2>;
+template class fizx::BasicStateBuffer<3>;
@@ -0,0 +1,260 @@
+#include <assert.h>
+#include <FIZX/world.hpp>
+
+template <fizx::size_t Dim>
+fizx::BasicParticleWorld<Dim>::BasicParticleWorld(WorkerPool& pool, std::size_t command_capacity)
+: commands(command_capacity), pool(pool), duration(0), frame(0), state_publishing(false), accounted_bytes(0)
+{
+    phase_tasks[static_cast<int>(Phase::commands)] = graph.add_task("commands", [this]()
+    {
+        apply_commands();
+    });
+    phase_tasks[static_cast<int>(Phase::forces)] = graph.add_task("forces", [this]()
+    {
+        for (ForceGenerator& generator : force_generators)
+        {
+            generator(particles, duration);
+        }
+    });
+    phase_tasks[static_cast<int>(Phase::integration)] = graph.add_task("integration", [this]()
+    {
+        integrate();
+    });
+    phase_tasks[static_cast<int>(Phase::broadphase)] = graph.add_task("broadphase", [this]()
+    {
+        if (broadphase) broadphase(particles, duration);
+    });
+    phase_tasks[static_cast<int>(Phase::narrowphase)] = graph.add_task("narrowphase", [this]()
+    {
+        if (narrowphase) narrowphase(particles, duration);
+    });
+    phase_tasks[static_cast<int>(Phase::resolution)] = graph.add_task("resolution", [this]()
+    {
+        if (resolver) resolver(particles, duration);
+    });
+    phase_tasks[static_cast<int>(Phase::output)] = graph.add_task("output", [this]()
+    {
+        publish();
+    });
+
+    for (int p = 1; p < static_cast<int>(Phase::count); ++p)
+    {
+        graph.add_dependency(phase_tasks[p - 1], phase_tasks[p]);
+    }
+}
+
+template <fizx::size_t Dim>
+fizx::BasicParticleWorld<Dim>::~BasicParticleWorld()
+{
+    try
+    {
+        finish();
+    }
+    catch (...)
+    {
+        // Nothing left to report the output failure to.
+    }
+    MemoryAccount::shared().release(Subsystem::particles, accounted_bytes);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::step(real duration)
+{
+    assert(duration > 0.0);
+
+    account();
+    scratch.reset();
+    this->duration = duration;
+    graph.run(pool);
+    ++frame;
+    try
+    {
+        account();
+    }
+    catch (const BudgetExceeded&)
+    {
+        // The step is done: leave the growth uncharged and let the next step refuse to start.
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::account()
+{
+    const std::size_t bytes = (particles.capacity() + output_buffer.capacity()) * sizeof(particle_type);
+    if (bytes > accounted_bytes)
+    {
+        MemoryAccount::shared().charge(Subsystem::particles, bytes - accounted_bytes);
+    }
+    else
+    {
+        MemoryAccount::shared().release(Subsystem::particles, accounted_bytes - bytes);
+    }
+    accounted_bytes = bytes;
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::finish()
+{
+    output_group.wait(pool);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::apply_commands()
+{
+    // Only take what is queued now, so busy producers cannot keep the step waiting.
+    command_batch.clear();
+    command_type command;
+    while (command_batch.size() < commands.capacity() && commands.pop(command))
+    {
+        command_batch.push_back(std::move(command));
+    }
+
+    for (const command_type& c : command_batch)
+    {
+        if (c.type == command_type::Type::spawn)
+        {
+            particles.push_back(c.particle);
+            continue;
+        }
+        if (c.index < 0 || c.index >= static_cast<size_t>(particles.size())) continue;
+
+        switch (c.type)
+        {
+        case command_type::Type::add_force:
+            particles[c.index].add_force(c.value);
+            break;
+        case command_type::Type::set_position:
+            particles[c.index].set_position(c.value);
+            break;
+        case command_type::Type::set_velocity:
+            particles[c.index].set_velocity(c.value);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::integrate()
+{
+    if (integrator)
+    {
+        integrator(particles, duration);
+        return;
+    }
+    parallel_for(static_cast<size_t>(particles.size()), [this](size_t begin, size_t end)
+    {
+        particle_type::integrate_batch(particles.data() + begin, end - begin, duration);
+    }, 256);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::publish()
+{
+    if (state_publishing) state.publish(particles, frame);
+    if (!output) return;
+
+    // The buffer still belongs to the previous frame until its output is done.
+    output_group.wait(pool);
+    output_buffer = particles;
+    size_t published = frame;
+    output_group.run(pool, [this, published]()
+    {
+        output(output_buffer, published);
+    });
+}
+
+template <fizx::size_t Dim>
+std::vector<fizx::BasicParticle<Dim>>& fizx::BasicParticleWorld<Dim>::get_particles()
+{
+    return particles;
+}
+
+template <fizx::size_t Dim>
+const std::vector<fizx::BasicParticle<Dim>>& fizx::BasicParticleWorld<Dim>::get_particles() const
+{
+    return particles;
+}
+
+template <fizx::size_t Dim>
+bool fizx::BasicParticleWorld<Dim>::queue_command(command_type command)
+{
+    return commands.push(std::move(command));
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::add_force_generator(ForceGenerator generator)
+{
+    force_generators.push_back(std::move(generator));
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_integrator(Stage stage)
+{
+    integrator = std::move(stage);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_broadphase(Stage stage)
+{
+    broadphase = std::move(stage);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_narrowphase(Stage stage)
+{
+    narrowphase = std::move(stage);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_resolver(Stage stage)
+{
+    resolver = std::move(stage);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_output(Output callback)
+{
+    finish();
+    output = std::move(callback);
+}
+
+template <fizx::size_t Dim>
+void fizx::BasicParticleWorld<Dim>::set_state_publishing(bool enabled)
+{
+    state_publishing = enabled;
+}
+
+template <fizx::size_t Dim>
+fizx::BasicStateBuffer<Dim>& fizx::BasicParticleWorld<Dim>::get_state()
+{
+    return state;
+}
+
+template <fizx::size_t Dim>
+fizx::ScratchArena& fizx::BasicParticleWorld<Dim>::get_scratch()
+{
+    return scratch;
+}
+
+template <fizx::size_t Dim>
+fizx::TaskGraph& fizx::BasicParticleWorld<Dim>::get_graph()
+{
+    return graph;
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicParticleWorld<Dim>::get_phase_task(Phase phase) const
+{
+    return phase_tasks[static_cast<int>(phase)];
+}
+
+template <fizx::size_t Dim>
+fizx::size_t fizx::BasicParticleWorld<Dim>::get_frame() const
+{
+    return frame;
+}
+
+template class fizx::BasicParticleWorld<2>;
+template class fizx::BasicParticleWorld<3>;
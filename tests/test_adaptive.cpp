@@ -0,0 +1,86 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <FIZX/adaptive.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Pulls every particle towards the origin, with a gravitational parameter of 1.
+*/
+void central_field(const vector<vec3f>& positions, const vector<vec3f>&, vector<vec3f>& accelerations)
+{
+    for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+    {
+        real r2 = positions[i] * positions[i];
+        accelerations[i] = positions[i] * (-1 / (r2 * sqrt(r2)));
+    }
+}
+
+int main(void)
+{
+    cout << "TEST ADAPTIVE" << endl;
+    bool error = false;
+
+    cout << "Constant acceleration test" << endl;
+    vector<Particle> particles(2);
+    particles[0].set_velocity(vec3f(3, 4, 0));
+    particles[0].set_acceleration(vec3f(0, -9.81, 0));
+    particles[1].set_position(vec3f(1, 1, 1));
+    particles[1].set_mass(-1);
+    particles[1].set_acceleration(vec3f(0, -9.81, 0));
+    AdaptiveIntegrator projectile;
+    projectile.advance(particles, 2);
+    if (T_Fail(compare_real_equal(particles[0].get_position().x(), 6), "Exact drift")) error = true;
+    if (T_Fail(abs(particles[0].get_position().y() - (8 - 0.5 * 9.81 * 4)) < 1e-9, "Exact fall")) error = true;
+    if (T_Fail(projectile.get_stats().rejected == 0, "Nothing rejected")) error = true;
+    if (T_Fail(particles[1].get_position() == vec3f(1, 1, 1), "Infinite mass stays")) error = true;
+
+    cout << "Eccentric orbit test" << endl;
+    // Semi major axis 1 and eccentricity 0.9, starting at periapsis; the period is 2 pi.
+    const real e = 0.9;
+    const real period = 2 * M_PI;
+    ParticleWorld world;
+    Particle planet;
+    planet.set_position(vec3f(1 - e, 0, 0));
+    planet.set_velocity(vec3f(0, sqrt((1 + e) / (1 - e)), 0));
+    world.get_particles().push_back(planet);
+    AdaptiveIntegrator integrator(1e-9, 1e-9);
+    integrator.set_field(central_field);
+    world.set_integrator([&integrator](vector<Particle>& p, real duration)
+    {
+        integrator.advance(p, duration);
+    });
+    const int frames = 50;
+    for (int frame = 0; frame < frames; ++frame) world.step(period / frames);
+
+    const Particle& end = world.get_particles()[0];
+    vec3f offset = end.get_position() - planet.get_position();
+    real energy = 0.5 * (end.get_velocity() * end.get_velocity()) - 1 / sqrt(end.get_position() * end.get_position());
+    const AdaptiveStats& stats = integrator.get_stats();
+    cout << "\tReturned within " << sqrt(offset * offset) << " after " << stats.accepted << " steps ("
+         << stats.rejected << " rejected, " << stats.evaluations << " evaluations), steps from "
+         << stats.smallest_step << " to " << stats.largest_step << endl;
+    if (T_Fail(sqrt(offset * offset) < 1e-5, "Orbit closes")) error = true;
+    if (T_Fail(abs(energy + 0.5) < 1e-7, "Energy kept")) error = true;
+    if (T_Fail(stats.largest_step > 20 * stats.smallest_step, "Short steps at periapsis only")) error = true;
+
+    integrator.reset_stats();
+    if (T_Fail(integrator.get_stats().accepted == 0 && integrator.get_next_step() > 0, "Stats reset, step kept")) error = true;
+
+    if (error)
+    {
+        cout << "TEST ADAPTIVE Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST ADAPTIVE PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,162 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include <FIZX/batch.hpp>
+#include <FIZX/dispatch.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Makes the particles of one world, different for every world.
+*/
+vector<Particle> make_world(int world, int count)
+{
+    vector<Particle> particles(count);
+    for (int i = 0; i < count; ++i)
+    {
+        particles[i].set_position(vec3f(world, i, 0));
+        particles[i].set_velocity(vec3f(0.1 * i, world * 0.01, 1));
+        particles[i].set_acceleration(vec3f(0, -9.81, 0));
+        particles[i].set_mass(1 + world % 3);
+    }
+    particles[0].set_mass(-1);
+    return particles;
+}
+
+/**
+ * Pulls particle i towards the origin with a spring, through the net force.
+*/
+void spring(Particle& particle)
+{
+    particle.add_force(particle.get_position() * -2);
+}
+
+int main(void)
+{
+    cout << "TEST WORLD BATCH" << endl;
+    bool error = false;
+
+    cout << "Lockstep test" << endl;
+    const int worlds = 37;
+    const int count = 20;
+    WorldBatch batch(worlds, count);
+    vector<vector<Particle>> reference(worlds);
+    for (int w = 0; w < worlds; ++w)
+    {
+        reference[w] = make_world(w, count);
+        batch.load(w, reference[w]);
+    }
+    if (T_Fail(batch.get_stride() == 40, "Worlds padded to the lane width")) error = true;
+
+    batch.add_force_generator([](WorldBatch& b, real)
+    {
+        for (int i = 0; i < static_cast<int>(b.particle_count()); ++i)
+        {
+            for (int d = 0; d < 3; ++d)
+            {
+                const real* position = b.row(WorldBatch::Field::position, i, d);
+                real* force = b.row(WorldBatch::Field::net_force, i, d);
+                for (int w = 0; w < static_cast<int>(b.world_count()); ++w) force[w] += -2 * position[w];
+            }
+        }
+    });
+    for (int step = 0; step < 100; ++step)
+    {
+        batch.step(0.01);
+        for (vector<Particle>& world : reference)
+        {
+            for (Particle& p : world)
+            {
+                spring(p);
+                p.integrate(0.01);
+            }
+        }
+    }
+
+    bool matches = true;
+    vector<Particle> readback;
+    for (int w = 0; w < worlds; ++w)
+    {
+        batch.store(w, readback);
+        for (int i = 0; i < count; ++i)
+        {
+            vec3f d = readback[i].get_position() - reference[w][i].get_position();
+            vec3f v = readback[i].get_velocity() - reference[w][i].get_velocity();
+            if (d * d > 1e-20 || v * v > 1e-20) matches = false;
+        }
+    }
+    if (T_Fail(matches, "Every world matches stepping it alone")) error = true;
+    if (T_Fail(batch.get_particle(5, 0).get_position() == vec3f(5, 0, 0), "Infinite mass stays")) error = true;
+
+    cout << "Reset test" << endl;
+    batch.reset(3);
+    if (T_Fail(batch.get_particle(3, 7).get_position() == make_world(3, count)[7].get_position(), "World reset")) error = true;
+    if (T_Fail(batch.get_particle(4, 7).get_position() == reference[4][7].get_position(), "Other worlds untouched")) error = true;
+    batch.row(WorldBatch::Field::damping, 7)[3] = 0.5;
+    batch.step(0.01);
+    if (T_Fail(batch.get_particle(3, 7).get_velocity().z() < 0.995, "Damping row applied")) error = true;
+
+    cout << "Path test" << endl;
+    // Every kernel path steps the lanes like the scalar one.
+    CpuPath detected = detect_cpu_path();
+    vector<Particle> expected;
+    for (CpuPath path : {CpuPath::scalar, CpuPath::sse42, CpuPath::avx2, CpuPath::avx512})
+    {
+        if (path > detected) break;
+        set_cpu_path(path);
+        WorldBatch lanes(worlds, count);
+        for (int w = 0; w < worlds; ++w) lanes.load(w, make_world(w, count));
+        for (int step = 0; step < 10; ++step) lanes.step(0.01);
+        lanes.store(worlds - 1, readback);
+        if (path == CpuPath::scalar) expected = readback;
+        bool close = true;
+        for (int i = 0; i < count; ++i)
+        {
+            vec3f d = readback[i].get_position() - expected[i].get_position();
+            if (d * d > 1e-24) close = false;
+        }
+        if (T_Fail(close, "Path matches scalar")) error = true;
+    }
+    set_cpu_path(detected);
+
+    cout << "Throughput test" << endl;
+    const int many = 10'000;
+    const int small = 16;
+    const int steps = 100;
+    WorldBatch sweep(many, small);
+    vector<vector<Particle>> separate(many);
+    for (int w = 0; w < many; ++w)
+    {
+        separate[w] = make_world(w, small);
+        sweep.load(w, separate[w]);
+    }
+    auto start = chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step)
+    {
+        for (vector<Particle>& world : separate) Particle::integrate_batch(world.data(), world.size(), 0.01);
+    }
+    double one_by_one = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) sweep.step(0.01);
+    double lockstep = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\t" << many << " worlds of " << small << " particles, " << steps << " steps: one by one "
+         << one_by_one << " s, lockstep " << lockstep << " s" << endl;
+    vec3f drift = sweep.get_particle(many - 1, small - 1).get_position() - separate[many - 1][small - 1].get_position();
+    if (T_Fail(drift * drift < 1e-20, "Sweep matches")) error = true;
+
+    if (error)
+    {
+        cout << "TEST WORLD BATCH Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST WORLD BATCH PASSED" << endl;
+    }
+
+    return error;
+}
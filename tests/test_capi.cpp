@@ -0,0 +1,102 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <FIZX/fizx.h>
+#include "test_lib.hpp"
+
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST C API" << endl;
+    bool error = false;
+
+    if (T_Fail(fizx_api_version() == FIZX_API_VERSION, "Header and library agree")) error = true;
+
+    cout << "Creation test" << endl;
+    fizx_world* world = nullptr;
+    if (T_Fail(fizx_world_create(4, &world) == FIZX_ERROR_INVALID_ARGUMENT && !world, "Bad dimension rejected")) error = true;
+    if (T_Fail(string(fizx_last_error()).size() > 0, "Error described")) error = true;
+    if (T_Fail(fizx_world_create(3, &world) == FIZX_OK && world, "World created")) error = true;
+    if (T_Fail(*fizx_last_error() == 0, "Error cleared")) error = true;
+    const int count = 1000;
+    if (T_Fail(fizx_world_resize(world, count) == FIZX_OK && fizx_world_size(world) == count, "Resized")) error = true;
+    if (T_Fail(fizx_field_components(world, FIZX_FIELD_VELOCITY) == 3, "Vector components")) error = true;
+    if (T_Fail(fizx_field_components(world, FIZX_FIELD_INVERSE_MASS) == 1, "Scalar components")) error = true;
+
+    cout << "Column test" << endl;
+    vector<fizx_real> positions(3 * count), velocities(3 * count), gravity(3 * count), inverse_masses(count, 1);
+    for (int i = 0; i < count; ++i)
+    {
+        positions[3 * i] = i;
+        velocities[3 * i + 2] = 2;
+        gravity[3 * i + 1] = -10;
+    }
+    inverse_masses[0] = 0;
+    fizx_world_write(world, FIZX_FIELD_POSITION, 0, count, positions.data());
+    fizx_world_write(world, FIZX_FIELD_VELOCITY, 0, count, velocities.data());
+    fizx_world_write(world, FIZX_FIELD_ACCELERATION, 0, count, gravity.data());
+    fizx_world_write(world, FIZX_FIELD_INVERSE_MASS, 0, count, inverse_masses.data());
+    for (int step = 0; step < 10; ++step) fizx_world_step(world, 0.1);
+    if (T_Fail(fizx_world_frame(world) == 10, "Stepped")) error = true;
+
+    vector<fizx_real> read(3 * count);
+    if (T_Fail(fizx_world_read(world, FIZX_FIELD_POSITION, 0, count, read.data()) == FIZX_OK, "Column read")) error = true;
+    // Semi-implicit Euler: y = -10 * 0.1^2 * (0 + 1 + ... + 9).
+    if (T_Fail(fabs(read[3 * 7] - 7) < 1e-12 && fabs(read[3 * 7 + 1] + 4.5) < 1e-12 && fabs(read[3 * 7 + 2] - 2) < 1e-12,
+        "Particles moved")) error = true;
+    if (T_Fail(read[0] == 0 && read[1] == 0 && read[2] == 0, "Infinite mass stays")) error = true;
+    fizx_real mass[2];
+    fizx_world_read(world, FIZX_FIELD_INVERSE_MASS, 499, 2, mass);
+    if (T_Fail(mass[0] == 1 && mass[1] == 1, "Scalar column read")) error = true;
+
+    cout << "Range test" << endl;
+    if (T_Fail(fizx_world_read(world, FIZX_FIELD_POSITION, count - 1, 2, read.data()) == FIZX_ERROR_OUT_OF_RANGE,
+        "Read past the end")) error = true;
+    if (T_Fail(fizx_world_write(world, FIZX_FIELD_VELOCITY, count, 1, read.data()) == FIZX_ERROR_OUT_OF_RANGE,
+        "Write past the end")) error = true;
+    fizx_real negative = -1;
+    if (T_Fail(fizx_world_write(world, FIZX_FIELD_INVERSE_MASS, 3, 1, &negative) == FIZX_ERROR_INVALID_ARGUMENT,
+        "Negative inverse mass")) error = true;
+    if (T_Fail(fizx_world_step(world, -1) == FIZX_ERROR_INVALID_ARGUMENT, "Negative step")) error = true;
+    if (T_Fail(fizx_world_step(nullptr, 1) == FIZX_ERROR_INVALID_ARGUMENT, "Null world")) error = true;
+
+    cout << "Zero copy test" << endl;
+    size_t stride = 0;
+    fizx_real* data = fizx_world_data(world, &stride);
+    const size_t velocity = fizx_field_offset(world, FIZX_FIELD_VELOCITY);
+    if (T_Fail(data && stride == 14 && velocity == 3, "Layout")) error = true;
+    if (T_Fail(data[5 * stride] == 5 && data[5 * stride + velocity + 2] == 2, "Storage matches the columns")) error = true;
+    data[5 * stride + velocity] = 100;
+    fizx_world_step(world, 0.1);
+    fizx_world_read(world, FIZX_FIELD_POSITION, 5, 1, read.data());
+    if (T_Fail(fabs(read[0] - 15) < 1e-12, "Writes through the storage are seen")) error = true;
+
+    cout << "2D test" << endl;
+    fizx_world* flat = nullptr;
+    fizx_world_create(2, &flat);
+    fizx_world_resize(flat, 2);
+    fizx_real flat_velocities[4] = {1, 2, 3, 4};
+    fizx_world_write(flat, FIZX_FIELD_VELOCITY, 0, 2, flat_velocities);
+    fizx_world_step(flat, 1);
+    fizx_real flat_positions[4];
+    fizx_world_read(flat, FIZX_FIELD_POSITION, 0, 2, flat_positions);
+    if (T_Fail(flat_positions[0] == 1 && flat_positions[3] == 4, "2D world")) error = true;
+    fizx_world_destroy(flat);
+
+    fizx_world_destroy(world);
+    fizx_world_destroy(nullptr);
+
+    if (error)
+    {
+        cout << "TEST C API Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST C API PASSED" << endl;
+    }
+
+    return error;
+}
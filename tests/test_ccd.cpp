@@ -0,0 +1,102 @@
+#include <string>
+#include <iostream>
+#include <vector>
+
+#include <FIZX/ccd.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Fires a particle at a fixed wall one particle thick and returns the particles afterwards.
+*/
+vector<Particle> fire_at_wall(bool swept)
+{
+    const real radius = 0.1;
+    ParticleWorld world;
+    vector<Particle>& particles = world.get_particles();
+    for (int y = -5; y <= 5; ++y)
+    {
+        for (int z = -5; z <= 5; ++z)
+        {
+            Particle brick;
+            brick.set_position(vec3f(0, y * 2 * radius, z * 2 * radius));
+            brick.set_mass(-1);
+            particles.push_back(brick);
+        }
+    }
+    // 100 m/s at 60 Hz covers more than 8 wall thicknesses per step.
+    Particle bullet;
+    bullet.set_position(vec3f(-1, 0.05, 0));
+    bullet.set_velocity(vec3f(100, 0, 0));
+    particles.push_back(bullet);
+
+    SweptIntegrator integrator(radius, 4, 0.5);
+    if (swept)
+    {
+        world.set_integrator([&integrator](vector<Particle>& p, real duration)
+        {
+            integrator.integrate(p, duration);
+        });
+    }
+    for (int step = 0; step < 10; ++step) world.step(1.0 / 60);
+    return particles;
+}
+
+int main(void)
+{
+    cout << "TEST CCD" << endl;
+    bool error = false;
+
+    cout << "Time of impact test" << endl;
+    real s = time_of_impact<3>(vec3f(-10, 0, 0), vec3f(20, 0, 0), vec3f(0, 0, 0), 1);
+    if (T_Fail(compare_real_equal(s, 0.45), "Head on impact")) error = true;
+    s = time_of_impact<3>(vec3f(-10, 2, 0), vec3f(20, 0, 0), vec3f(0, 0, 0), 1);
+    if (T_Fail(s < 0, "Miss")) error = true;
+    s = time_of_impact<3>(vec3f(-10, 0, 0), vec3f(5, 0, 0), vec3f(0, 0, 0), 1);
+    if (T_Fail(s < 0, "Stops short")) error = true;
+    s = time_of_impact<3>(vec3f(0.5, 0, 0), vec3f(1, 0, 0), vec3f(0, 0, 0), 1);
+    if (T_Fail(s < 0, "Overlapping but leaving")) error = true;
+    s = time_of_impact<2>(vec2f(0.5, 0), vec2f(-1, 0), vec2f(0, 0), 1);
+    if (T_Fail(s == 0, "Overlapping and approaching")) error = true;
+
+    cout << "Tunnelling test" << endl;
+    vector<Particle> discrete = fire_at_wall(false);
+    vector<Particle> swept = fire_at_wall(true);
+    if (T_Fail(discrete.back().get_position().x() > 1, "Discrete bullet tunnels")) error = true;
+    if (T_Fail(swept.back().get_position().x() < -0.19, "Swept bullet stopped by the wall")) error = true;
+    if (T_Fail(swept.back().get_velocity().x() < 0, "Swept bullet bounced")) error = true;
+
+    cout << "Selection test" << endl;
+    vector<Particle> particles(3);
+    particles[0].set_velocity(vec3f(1, 0, 0));
+    particles[1].set_position(vec3f(5, 0, 0));
+    particles[1].set_velocity(vec3f(100, 0, 0));
+    particles[2].set_position(vec3f(10, 0, 0));
+    SweptIntegrator integrator(0.5);
+    integrator.set_fast(2, true);
+    integrator.integrate(particles, 0.01);
+    if (T_Fail(integrator.get_swept_count() == 2, "Only fast and flagged particles swept")) error = true;
+    if (T_Fail(integrator.is_fast(2) && !integrator.is_fast(0) && !integrator.is_fast(7), "Flags kept")) error = true;
+    if (T_Fail(compare_real_equal(particles[0].get_position().x(), 0.01), "Slow particle integrated")) error = true;
+    if (T_Fail(compare_real_equal(particles[1].get_position().x(), 6), "Free fast particle moves the whole step")) error = true;
+    bool thrown = false;
+    try { integrator.set_max_substeps(-1); } catch (const domain_error&) { thrown = true; }
+    if (T_Fail(thrown, "Sub-steps checked")) error = true;
+    thrown = false;
+    try { integrator.set_fast(-1, true); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown && !integrator.is_fast(-1), "Negative index checked")) error = true;
+
+    if (error)
+    {
+        cout << "TEST CCD Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST CCD PASSED" << endl;
+    }
+
+    return error;
+}
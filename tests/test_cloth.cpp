@@ -0,0 +1,209 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include <FIZX/cloth.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * A square sheet of side particles in the xy plane, with structural and shear springs.
+*/
+vector<Particle> make_sheet(int side, real spacing, real stiffness, Cloth& cloth)
+{
+    vector<Particle> particles(side * side);
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            particles[y * side + x].set_position(vec3f(x * spacing, y * spacing, 0));
+            particles[y * side + x].set_mass(0.01);
+        }
+    }
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            const int i = y * side + x;
+            if (x + 1 < side) cloth.add_spring(particles, i, i + 1, stiffness);
+            if (y + 1 < side) cloth.add_spring(particles, i, i + side, stiffness);
+            if (x + 1 < side && y + 1 < side) cloth.add_spring(particles, i, i + side + 1, stiffness);
+            if (x > 0 && y + 1 < side) cloth.add_spring(particles, i, i + side - 1, stiffness);
+        }
+    }
+    return particles;
+}
+
+bool finite_and_bounded(const vector<Particle>& particles, real bound)
+{
+    for (const Particle& p : particles)
+    {
+        const real size = p.get_position().magnitude();
+        if (!(size < bound)) return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    cout << "TEST CLOTH" << endl;
+    bool error = false;
+
+    cout << "Topology test" << endl;
+    {
+        Cloth cloth;
+        vector<Particle> particles(4);
+        particles[1].set_position(vec3f(1, 0, 0));
+        cloth.add_spring(particles, 0, 1, 10);
+        cloth.add_spring(2, 1, 10, 1);
+        cloth.add_spring(3, 1, 10, 1);
+        if (T_Fail(cloth.get_spring(0).rest_length == 1 && cloth.spring_count() == 3, "Springs added")) error = true;
+        bool thrown = false;
+        try { cloth.add_spring(2, 2, 10, 1); } catch (const invalid_argument&) { thrown = true; }
+        if (T_Fail(thrown, "No spring to itself")) error = true;
+        thrown = false;
+        try { cloth.add_spring(-1, 2, 10, 1); } catch (const invalid_argument&) { thrown = true; }
+        if (T_Fail(thrown, "No spring to a negative index")) error = true;
+        thrown = false;
+        try { cloth.set_max_iterations(-1); } catch (const domain_error&) { thrown = true; }
+        if (T_Fail(thrown, "Iterations checked")) error = true;
+        thrown = false;
+        try { cloth.get_spring(-1); } catch (const runtime_error&) { thrown = true; }
+        if (T_Fail(thrown, "Spring index checked")) error = true;
+        cloth.step(particles, 0.01);
+        const Cloth::index_list& offsets = cloth.get_offsets();
+        const Cloth::index_list& incident = cloth.get_incident();
+        bool lists = offsets.size() == 5 && offsets[0] == 0 && offsets[1] == 1 && offsets[2] == 4 && offsets[4] == 6;
+        lists = lists && incident[1] == 0 && incident[2] == 1 && incident[3] == 2;
+        if (T_Fail(lists, "Springs of every particle")) error = true;
+        thrown = false;
+        try { cloth.add_spring(0, 2, 10, 1); } catch (const logic_error&) { thrown = true; }
+        if (T_Fail(thrown, "Springs fixed once stepped")) error = true;
+
+        Cloth broken;
+        broken.add_spring(0, 7, 10, 1);
+        thrown = false;
+        try { broken.step(particles, 0.01); } catch (const runtime_error&) { thrown = true; }
+        if (T_Fail(thrown, "Spring to a missing particle")) error = true;
+    }
+
+    cout << "Hanging mass test" << endl;
+    {
+        // A stiff spring would need steps below 2 / sqrt(k / m) = 2 ms explicitly.
+        Cloth cloth(5);
+        vector<Particle> particles(2);
+        particles[0].set_mass(-1);
+        particles[1].set_position(vec3f(0, -1, 0));
+        particles[1].set_acceleration(vec3f(0, -10, 0));
+        cloth.add_spring(particles, 0, 1, 1e4);
+        for (int s = 0; s < 200; ++s) cloth.step(particles, 0.05);
+        const real stretch = -particles[1].get_position().y() - 1;
+        if (T_Fail(fabs(stretch - 1e-3) < 1e-6 && particles[1].get_velocity().magnitude() < 1e-6, "Settles at m g / k")) error = true;
+        if (T_Fail(particles[0].get_position().magnitude() == 0, "Pinned particle stays")) error = true;
+        if (T_Fail(cloth.get_residual() <= cloth.get_tolerance(), "Solved to tolerance")) error = true;
+    }
+
+    cout << "Stability test" << endl;
+    {
+        Cloth cloth(0.01);
+        vector<Particle> particles = make_sheet(20, 0.05, 1e5, cloth);
+        vector<Particle> explicit_particles = particles;
+        for (int x = 0; x < 20; ++x) particles[19 * 20 + x].set_mass(-1);
+        for (int x = 0; x < 20; ++x) explicit_particles[19 * 20 + x].set_mass(-1);
+        for (Particle& p : particles) p.set_acceleration(vec3f(0, 0, -10));
+        for (Particle& p : explicit_particles) p.set_acceleration(vec3f(0, 0, -10));
+        particles[0].set_velocity(vec3f(1, 0, 3));
+        explicit_particles[0].set_velocity(vec3f(1, 0, 3));
+
+        for (int s = 0; s < 120; ++s) cloth.step(particles, 1.0 / 60);
+        if (T_Fail(finite_and_bounded(particles, 2), "Implicit steps stay bounded")) error = true;
+
+        // The same springs, integrated explicitly.
+        for (int s = 0; s < 120; ++s)
+        {
+            for (fizx::size_t k = 0; k < cloth.spring_count(); ++k)
+            {
+                const Cloth::Spring& spring = cloth.get_spring(k);
+                const vec3f d = explicit_particles[spring.first].get_position() - explicit_particles[spring.second].get_position();
+                const real length = d.magnitude();
+                const vec3f force = d * (-spring.stiffness * (length - spring.rest_length) / length);
+                explicit_particles[spring.first].add_force(force);
+                explicit_particles[spring.second].add_force(force * -1);
+            }
+            for (Particle& p : explicit_particles) p.integrate(1.0 / 60);
+        }
+        if (T_Fail(!finite_and_bounded(explicit_particles, 2), "Explicit steps blow up")) error = true;
+    }
+
+    cout << "Momentum test" << endl;
+    {
+        Cloth cloth(0.1);
+        vector<Particle> particles = make_sheet(10, 0.1, 1e3, cloth);
+        particles[0].set_velocity(vec3f(0, 0, 5));
+        particles[55].set_velocity(vec3f(-2, 1, 0));
+        particles[99].add_force(vec3f(0, 0, -60));
+        cloth.set_tolerance(1e-12);
+        cloth.step(particles, 0.1);
+        vec3f momentum;
+        for (const Particle& p : particles) momentum += p.get_velocity() * p.get_mass();
+        // 0.01 * (0, 0, 5) + 0.01 * (-2, 1, 0) + impulse (0, 0, -6).
+        if (T_Fail((momentum - vec3f(-0.02, 0.01, -5.95)).magnitude() < 1e-9, "Springs keep momentum")) error = true;
+        if (T_Fail(particles[99].get_net_force().magnitude() == 0, "Forces cleared")) error = true;
+    }
+
+    cout << "2D test" << endl;
+    {
+        Cloth2D chain;
+        vector<Particle2D> particles(10);
+        for (int i = 0; i < 10; ++i)
+        {
+            particles[i].set_position(vec2f(i * 0.1, 0));
+            particles[i].set_acceleration(vec2f(0, -10));
+        }
+        particles[0].set_mass(-1);
+        for (int i = 0; i + 1 < 10; ++i) chain.add_spring(particles, i, i + 1, 1e4);
+        chain.set_damping(1);
+        for (int s = 0; s < 600; ++s) chain.step(particles, 1.0 / 30);
+        // Hangs straight down, each spring stretched by the weight below it.
+        real length = 0;
+        for (int i = 0; i < 9; ++i) length += (particles[i + 1].get_position() - particles[i].get_position()).magnitude();
+        if (T_Fail(fabs(particles[9].get_position().x()) < 0.02 && fabs(length - (0.9 + 0.045)) < 1e-4, "Chain hangs")) error = true;
+    }
+
+    cout << "Speed test" << endl;
+    {
+        Cloth cloth(0.01);
+        const int side = 100;
+        vector<Particle> particles = make_sheet(side, 0.01, 1e4, cloth);
+        for (int x = 0; x < side; ++x) particles[(side - 1) * side + x].set_mass(-1);
+        for (Particle& p : particles) p.set_acceleration(vec3f(0, 0, -10));
+        cloth.set_tolerance(1e-4);
+        const int steps = 5;
+        fizx::size_t iterations = 0;
+        auto start = chrono::steady_clock::now();
+        for (int s = 0; s < steps; ++s)
+        {
+            cloth.step(particles, 1.0 / 60);
+            iterations += cloth.get_iterations();
+        }
+        double taken = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "\t" << side * side << " particles, " << cloth.spring_count() << " springs: " << taken / steps
+             << " s per step, " << iterations / steps << " iterations" << endl;
+        if (T_Fail(finite_and_bounded(particles, 10) && cloth.get_residual() <= 1e-4, "Large cloth solved")) error = true;
+    }
+
+    if (error)
+    {
+        cout << "TEST CLOTH Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST CLOTH PASSED" << endl;
+    }
+
+    return error;
+}
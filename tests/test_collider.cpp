@@ -0,0 +1,186 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include <FIZX/collider.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+Particle at(const vec3f& position)
+{
+    Particle particle;
+    particle.set_position(position);
+    return particle;
+}
+
+/**
+ * Flat square grid of triangles at height y, from (0, y, 0) to (cells, y, cells).
+*/
+void grid_mesh(int cells, real y, vector<vec3f>& vertices, vector<uint32_t>& indices)
+{
+    for (int j = 0; j <= cells; ++j)
+    {
+        for (int i = 0; i <= cells; ++i) vertices.push_back(vec3f(i, y, j));
+    }
+    for (int j = 0; j < cells; ++j)
+    {
+        for (int i = 0; i < cells; ++i)
+        {
+            uint32_t v = j * (cells + 1) + i;
+            indices.insert(indices.end(), {v, v + 1, v + cells + 2, v, v + cells + 2, v + cells + 1});
+        }
+    }
+}
+
+int main(void)
+{
+    cout << "TEST STATIC COLLIDERS" << endl;
+    bool error = false;
+    vector<StaticContact> contacts;
+
+    cout << "Plane test" << endl;
+    StaticColliders ground(0.5);
+    ground.add_plane(vec3f(0, 2, 0), 0);
+    vector<Particle> particles = {at(vec3f(0, 0.25, 0)), at(vec3f(3, 1, 0)), at(vec3f(0, -4, 1))};
+    ground.query(particles, contacts);
+    if (T_Fail(contacts.size() == 2 && contacts[0].particle == 0 && contacts[1].particle == 2, "Touching particles")) error = true;
+    if (T_Fail(compare_real_equal(contacts[0].depth, 0.25) && contacts[0].normal == vec3f(0, 1, 0), "Plane contact")) error = true;
+    if (T_Fail(compare_real_equal(contacts[1].depth, 4.5) && contacts[1].point == vec3f(0, 0, 1), "Below the plane")) error = true;
+
+    cout << "Resting test" << endl;
+    {
+        ParticleWorld world;
+        world.get_particles().push_back(at(vec3f(0, 5, 0)));
+        world.get_particles()[0].set_acceleration(vec3f(0, -9.81, 0));
+        world.set_resolver([&](vector<Particle>& p, real duration) { ground.resolve(p, duration); });
+        for (int step = 0; step < 500; ++step) world.step(0.01);
+        const Particle& ball = world.get_particles()[0];
+        if (T_Fail(fabs(ball.get_position().y() - 0.5) < 0.01, "Rests on the ground")) error = true;
+        if (T_Fail(fabs(ball.get_velocity().y()) < 0.1, "Comes to rest")) error = true;
+    }
+
+    cout << "Box test" << endl;
+    StaticColliders walls(0.1, 1);
+    walls.add_box(vec3f(0, 0, 0), vec3f(1, 2, 3));
+    particles = {at(vec3f(0.5, 1.9, 1.5)), at(vec3f(1.05, 1, 1)), at(vec3f(1.05, 2.05, 3.05)), at(vec3f(2, 1, 1))};
+    particles[1].set_velocity(vec3f(-2, 1, 0));
+    walls.query(particles, contacts);
+    if (T_Fail(contacts.size() == 3, "Inside, beside and at a corner")) error = true;
+    if (T_Fail(contacts[0].normal == vec3f(0, 1, 0) && compare_real_equal(contacts[0].depth, 0.2), "Out of the nearest face")) error = true;
+    if (T_Fail(contacts[1].normal == vec3f(1, 0, 0) && compare_real_equal(contacts[1].depth, 0.05), "Beside a face")) error = true;
+    if (T_Fail(compare_real_equal(contacts[2].normal * vec3f(1, 1, 1), sqrt(3.0)), "Corner normal")) error = true;
+    walls.resolve(particles, 0.01);
+    if (T_Fail(compare_real_equal(particles[1].get_position().x(), 1.1), "Pushed out")) error = true;
+    if (T_Fail(particles[1].get_velocity() == vec3f(2, 1, 0), "Elastic bounce")) error = true;
+    if (T_Fail(particles[3].get_position() == vec3f(2, 1, 1), "Far particle untouched")) error = true;
+
+    cout << "Overlap test" << endl;
+    {
+        // The floor is a plane and the top of a box at once, and meets a wall at the corner.
+        StaticColliders overlapping(0.5, 0);
+        overlapping.add_plane(vec3f(0, 1, 0), 0);
+        overlapping.add_box(vec3f(-5, -1, -5), vec3f(5, 0, 5));
+        overlapping.add_plane(vec3f(1, 0, 0), -4);
+        vector<Particle> balls = {at(vec3f(0, 0.25, 0)), at(vec3f(-3.75, 0.1, 0))};
+        balls[0].set_velocity(vec3f(1, -2, 0));
+        overlapping.query(balls, contacts);
+        if (T_Fail(contacts.size() == 5, "Contact with every overlapping collider")) error = true;
+        overlapping.resolve(balls, 0.01);
+        if (T_Fail(compare_real_equal(balls[0].get_position().y(), 0.5), "Pushed out once")) error = true;
+        if (T_Fail(balls[0].get_velocity() == vec3f(1, 0, 0), "Stopped once")) error = true;
+        const vec3f corner = balls[1].get_position();
+        if (T_Fail(compare_real_equal(corner.x(), -3.5) && compare_real_equal(corner.y(), 0.5), "Out of the corner")) error = true;
+        overlapping.query(balls, contacts);
+        bool resting = true;
+        for (const StaticContact& contact : contacts) resting = resting && contact.depth < 1e-12;
+        if (T_Fail(resting, "No overlap left")) error = true;
+    }
+
+    cout << "Heightfield test" << endl;
+    // Slope y = 0.5 * x over 5 x 4 samples a metre apart.
+    vector<real> heights;
+    for (int j = 0; j < 4; ++j)
+    {
+        for (int i = 0; i < 5; ++i) heights.push_back(0.5 * i);
+    }
+    StaticColliders terrain(0.2);
+    terrain.add_heightfield(vec3f(0, 1, 0), 1, 1, 5, 4, heights);
+    particles = {at(vec3f(2.3, 2.2, 1.7)), at(vec3f(2.3, 3, 1.7)), at(vec3f(6, 0, 1))};
+    terrain.query(particles, contacts);
+    const vec3f slope_normal = vec3f(-0.5, 1, 0).unit();
+    if (T_Fail(contacts.size() == 1 && contacts[0].particle == 0, "Only the particle on the surface")) error = true;
+    if (T_Fail(fabs(contacts[0].normal * slope_normal - 1) < 1e-12, "Slope normal")) error = true;
+    if (T_Fail(fabs(contacts[0].depth - (0.2 - 0.05 * slope_normal.y())) < 1e-12, "Depth along the normal")) error = true;
+    bool thrown = false;
+    try { terrain.add_heightfield(vec3f(), 1, 1, 5, 5, heights); } catch (const invalid_argument&) { thrown = true; }
+    if (T_Fail(thrown, "Sample count checked")) error = true;
+
+    cout << "Mesh test" << endl;
+    vector<vec3f> vertices;
+    vector<uint32_t> indices;
+    const int cells = 100;
+    grid_mesh(cells, 0, vertices, indices);
+    StaticColliders floor(0.25);
+    floor.add_mesh(vertices, indices);
+    const std::size_t triangles = floor.triangle_count();
+    if (T_Fail(triangles == 2 * cells * cells, "Every triangle kept")) error = true;
+    bool leaves_cover = true;
+    std::size_t in_leaves = 0;
+    for (const StaticColliders::Node& node : floor.get_nodes())
+    {
+        if (node.count > StaticColliders::LEAF_SIZE) leaves_cover = false;
+        in_leaves += node.count;
+    }
+    if (T_Fail(leaves_cover && in_leaves == triangles, "Leaves hold every triangle once")) error = true;
+    if (T_Fail(floor.get_nodes().size() < triangles, "Compact hierarchy")) error = true;
+
+    mt19937 rng(3);
+    uniform_real_distribution<real> across(0.5, cells - 0.5), height(-0.4, 0.4);
+    const int count = 100'000;
+    particles.assign(count, Particle());
+    for (Particle& p : particles) p.set_position(vec3f(across(rng), height(rng), across(rng)));
+    auto start = chrono::steady_clock::now();
+    floor.query(particles, contacts);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\t" << count << " particles against " << triangles << " triangles: " << elapsed << " s" << endl;
+    bool matches = true;
+    std::size_t next = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const real y = particles[i].get_position().y();
+        if (fabs(y) >= 0.25) continue;
+        if (next >= contacts.size() || contacts[next].particle != static_cast<uint32_t>(i)) { matches = false; break; }
+        const StaticContact& contact = contacts[next++];
+        if (fabs(contact.depth - (0.25 - fabs(y))) > 1e-12 || fabs(contact.normal.y() - (y >= 0 ? 1 : -1)) > 1e-12) matches = false;
+    }
+    if (T_Fail(matches && next == contacts.size(), "Every contact found, nothing else")) error = true;
+
+    cout << "Mixed scene test" << endl;
+    StaticColliders scene(0.5);
+    scene.add_plane(vec3f(0, 1, 0), 0);
+    scene.add_box(vec3f(10, 0, 10), vec3f(11, 1, 11));
+    scene.add_mesh(vertices, indices);
+    if (T_Fail(scene.collider_count() == 3, "Three colliders")) error = true;
+    particles = {at(vec3f(10.5, 0.2, 10.5))};
+    scene.query(particles, contacts);
+    if (T_Fail(contacts.size() == 3 && contacts[0].collider == 0 && contacts[1].collider == 1 && contacts[2].collider == 2,
+        "One contact per collider, in order")) error = true;
+
+    if (error)
+    {
+        cout << "TEST STATIC COLLIDERS Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST STATIC COLLIDERS PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,109 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <thread>
+
+#include <FIZX/command.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST COMMAND QUEUE" << endl;
+    bool error = false;
+
+    cout << "Capacity test" << endl;
+    CommandQueue<int> small(3);
+    if (T_Fail(small.capacity() == 4, "Capacity rounded to a power of two")) error = true;
+    for (int i = 0; i < 4; ++i) small.push(i);
+    if (T_Fail(!small.push(4), "Full queue rejects")) error = true;
+    int value = -1;
+    small.pop(value);
+    if (T_Fail(value == 0 && small.push(4), "Popping frees a slot")) error = true;
+
+    cout << "Producer order test" << endl;
+    const int producers = 4;
+    const int per_producer = 50'000;
+    CommandQueue<pair<int, int>> queue(1'024);
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < per_producer; ++i)
+            {
+                while (!queue.push({p, i})) this_thread::yield();
+            }
+        });
+    }
+    vector<int> next(producers, 0);
+    bool ordered = true;
+    int received = 0;
+    pair<int, int> item;
+    while (received < producers * per_producer)
+    {
+        if (!queue.pop(item))
+        {
+            this_thread::yield();
+            continue;
+        }
+        if (item.second != next[item.first]) ordered = false;
+        next[item.first] = item.second + 1;
+        ++received;
+    }
+    for (thread& t : threads) t.join();
+    if (T_Fail(ordered, "Per producer order kept")) error = true;
+    if (T_Fail(!queue.pop(item), "Queue drained")) error = true;
+
+    cout << "World command test" << endl;
+    ParticleWorld world;
+    world.get_particles().resize(producers);
+    threads.clear();
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&world, p]()
+        {
+            // The last velocity a thread queues is the one that must stick.
+            for (int i = 1; i <= 1'000; ++i)
+            {
+                while (!world.queue_command(ParticleCommand::set_velocity(p, vec3f(i, 0, 0)))) this_thread::yield();
+            }
+            Particle spawned;
+            spawned.set_position(vec3f(p, p, p));
+            while (!world.queue_command(ParticleCommand::spawn(spawned))) this_thread::yield();
+        });
+    }
+    // Spawns are queued last, so once they all arrived every velocity command was applied.
+    while (world.get_particles().size() < 2 * producers)
+    {
+        world.step(0.001);
+    }
+    for (thread& t : threads) t.join();
+    world.queue_command(ParticleCommand::add_force(0, vec3f(0, 1'000, 0)));
+    world.queue_command(ParticleCommand::set_position(99, vec3f(1, 1, 1)));
+    world.queue_command(ParticleCommand::set_position(-1, vec3f(1, 1, 1)));
+    world.step(0.001);
+
+    bool last_wins = true;
+    for (int p = 0; p < producers; ++p)
+    {
+        if (world.get_particles()[p].get_velocity().x() != 1'000) last_wins = false;
+    }
+    if (T_Fail(last_wins, "Commands applied in queue order")) error = true;
+    if (T_Fail(world.get_particles().size() == 2 * producers, "Particles spawned")) error = true;
+    if (T_Fail(world.get_particles()[0].get_velocity().y() == 1, "Force applied before integration")) error = true;
+
+    if (error)
+    {
+        cout << "TEST COMMAND QUEUE Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST COMMAND QUEUE PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,98 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <FIZX/contact.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Settles a column of particles on a fixed one and returns the deepest overlap at the end.
+*/
+real settle_stack(int height, int iterations, bool warm_starting)
+{
+    const real radius = 0.5;
+    ParticleWorld world;
+    for (int i = 0; i < height; ++i)
+    {
+        Particle p;
+        p.set_position(vec3f(0, i * 2 * radius, 0));
+        if (i == 0) p.set_mass(-1);
+        else p.set_acceleration(vec3f(0, -9.81, 0));
+        world.get_particles().push_back(p);
+    }
+    ContactSolver solver(radius, iterations);
+    solver.set_warm_starting(warm_starting);
+    world.set_resolver([&solver](vector<Particle>& particles, real duration)
+    {
+        solver.solve(particles, duration);
+    });
+    for (int step = 0; step < 300; ++step) world.step(1.0 / 60);
+
+    real deepest = 0;
+    const vector<Particle>& particles = world.get_particles();
+    for (int i = 1; i < height; ++i)
+    {
+        real gap = particles[i].get_position().y() - particles[i - 1].get_position().y();
+        deepest = max(deepest, 2 * radius - gap);
+    }
+    return deepest;
+}
+
+int main(void)
+{
+    cout << "TEST CONTACT" << endl;
+    bool error = false;
+
+    cout << "Cache test" << endl;
+    ContactCache cache(4);
+    std::size_t first = cache.touch(3, 1);
+    cache[first].impulse = 2.5;
+    cache.touch(1, 2);
+    if (T_Fail(cache.size() == 2 && cache.find(1, 3) && cache.find(1, 3)->impulse == 2.5, "Pair found either way round")) error = true;
+    if (T_Fail(cache.evict() == 0, "Touched contacts kept")) error = true;
+
+    // Grow past the initial room while only some contacts stay live.
+    for (unsigned int i = 10; i < 110; ++i) cache.touch(i, i + 1);
+    cache.touch(1, 3);
+    if (T_Fail(cache.size() == 102 && cache.find(1, 3)->impulse == 2.5, "Contacts kept while growing")) error = true;
+    if (T_Fail(cache.evict() == 1 && !cache.find(1, 2), "Untouched contact evicted")) error = true;
+    if (T_Fail(cache.evict() == 101 && cache.size() == 0, "Everything evicted after an idle frame")) error = true;
+    if (T_Fail(cache.find(1, 3) == nullptr, "Evicted contact gone")) error = true;
+
+    cout << "Pair test" << endl;
+    vector<Particle> pair(2);
+    pair[1].set_position(vec3f(0.9, 0, 0));
+    pair[0].set_velocity(vec3f(1, 0, 0));
+    pair[1].set_velocity(vec3f(-1, 0, 0));
+    ContactSolver solver(0.5, 4);
+    solver.solve(pair, 0.01);
+    if (T_Fail(solver.contact_count() == 1, "Overlapping pair found")) error = true;
+    if (T_Fail(pair[1].get_velocity().x() - pair[0].get_velocity().x() >= 0, "Approach stopped")) error = true;
+    if (T_Fail(compare_real_equal(pair[0].get_velocity().x(), -pair[1].get_velocity().x()), "Momentum kept")) error = true;
+    if (T_Fail(solver.get_cache().find(0, 1)->impulse > 0, "Impulse cached")) error = true;
+
+    cout << "Warm starting test" << endl;
+    real cold = settle_stack(10, 4, false);
+    real cold_double = settle_stack(10, 8, false);
+    real warm = settle_stack(10, 4, true);
+    cout << "\tDeepest overlap: cold 4 iterations " << cold << ", cold 8 iterations " << cold_double
+         << ", warm 4 iterations " << warm << endl;
+    if (T_Fail(warm < cold_double, "Warm starting beats twice the iterations")) error = true;
+    if (T_Fail(warm < 0.01, "Warm started stack rests")) error = true;
+
+    if (error)
+    {
+        cout << "TEST CONTACT Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST CONTACT PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,156 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <functional>
+
+#include <FIZX/diagnostics.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * True if every field of both totals has the same bits.
+*/
+bool same_bits(const Totals& a, const Totals& b)
+{
+    bool same = a.count == b.count && a.infinite_mass_count == b.infinite_mass_count && a.finite == b.finite;
+    const real left[] = {a.kinetic_energy, a.mass, a.momentum[0], a.momentum[1], a.momentum[2], a.moment[0],
+        a.moment[1], a.moment[2], a.lower[0], a.lower[1], a.lower[2], a.upper[0], a.upper[1], a.upper[2]};
+    const real right[] = {b.kinetic_energy, b.mass, b.momentum[0], b.momentum[1], b.momentum[2], b.moment[0],
+        b.moment[1], b.moment[2], b.lower[0], b.lower[1], b.lower[2], b.upper[0], b.upper[1], b.upper[2]};
+    return same && memcmp(left, right, sizeof(left)) == 0;
+}
+
+int main(void)
+{
+    cout << "TEST DIAGNOSTICS" << endl;
+    bool error = false;
+
+    cout << "Totals test" << endl;
+    vector<Particle> particles(3);
+    particles[0].set_position(vec3f(1, 0, 0));
+    particles[0].set_velocity(vec3f(2, 0, 0));
+    particles[0].set_mass(2);
+    particles[1].set_position(vec3f(3, 2, -1));
+    particles[1].set_velocity(vec3f(0, -1, 0));
+    particles[1].set_mass(1);
+    particles[2].set_position(vec3f(-5, 0, 9));
+    particles[2].set_velocity(vec3f(100, 0, 0));
+    particles[2].set_mass(-1);
+    Diagnostics diagnostics(2);
+    const Totals& totals = diagnostics.measure(particles);
+    vec3f momentum = totals.momentum, centre = totals.centre_of_mass(), lower = totals.lower, upper = totals.upper;
+    if (T_Fail(totals.count == 3 && totals.infinite_mass_count == 1, "Counts")) error = true;
+    if (T_Fail(compare_real_equal(totals.kinetic_energy, 4.5), "Kinetic energy")) error = true;
+    if (T_Fail(momentum == vec3f(4, -1, 0) && compare_real_equal(totals.mass, 3), "Momentum and mass")) error = true;
+    if (T_Fail((centre - vec3f(5.0 / 3, 2.0 / 3, -1.0 / 3)).magnitude() < 1e-12, "Centre of mass")) error = true;
+    if (T_Fail(lower == vec3f(-5, 0, -1) && upper == vec3f(3, 2, 9) && totals.finite, "Bounds")) error = true;
+    particles.clear();
+    const Totals& empty = diagnostics.measure(particles);
+    centre = empty.centre_of_mass();
+    if (T_Fail(empty.count == 0 && empty.lower[0] > empty.upper[0] && centre == vec3f(), "No particles")) error = true;
+
+    cout << "Reproducible test" << endl;
+    mt19937 rng(7);
+    uniform_real_distribution<real> position(-1000, 1000), velocity(-50, 50), mass(0.1, 10);
+    const int count = 1'000'003;
+    particles.assign(count, Particle());
+    for (Particle& p : particles)
+    {
+        p.set_position(vec3f(position(rng), position(rng), position(rng)));
+        p.set_velocity(vec3f(velocity(rng), velocity(rng), velocity(rng)));
+        p.set_mass(mass(rng));
+    }
+    Diagnostics parallel, serial;
+    serial.set_parallel(false);
+    const Totals first = parallel.measure(particles);
+    bool reproducible = same_bits(first, serial.measure(particles));
+    for (int run = 0; run < 5; ++run) reproducible = reproducible && same_bits(first, parallel.measure(particles));
+    if (T_Fail(reproducible, "Same bits in parallel, serially and every run")) error = true;
+
+    long double energy = 0, momentum_x = 0, moment_z = 0, total_mass = 0;
+    for (const Particle& p : particles)
+    {
+        const long double m = p.get_mass();
+        const vec3f v = p.get_velocity();
+        energy += 0.5L * m * (v * v);
+        momentum_x += m * v.x();
+        moment_z += m * p.get_position().z();
+        total_mass += m;
+    }
+    const bool accurate = fabs(first.kinetic_energy - energy) < 1e-12 * energy
+        && fabs(first.momentum.x() - momentum_x) < 1e-9 * fabs(energy / 50)
+        && fabs(first.moment.z() - moment_z) < 1e-9 * total_mass * 1000 && fabs(first.mass - total_mass) < 1e-12 * total_mass;
+    if (T_Fail(accurate, "Close to an extended precision sum")) error = true;
+
+    cout << "Blow up test" << endl;
+    particles[count / 2].set_velocity(vec3f(0, numeric_limits<real>::infinity(), 0));
+    if (T_Fail(!parallel.measure(particles).finite, "Infinite velocity found")) error = true;
+    particles[count / 2].set_velocity(vec3f());
+    particles[17].set_position(vec3f(numeric_limits<real>::quiet_NaN(), 0, 0));
+    if (T_Fail(!parallel.measure(particles).finite, "NaN position found")) error = true;
+    particles[17].set_position(vec3f());
+
+    cout << "World output test" << endl;
+    {
+        ParticleWorld world;
+        world.get_particles().resize(10);
+        for (Particle& p : world.get_particles()) p.set_velocity(vec3f(1, 0, 0));
+        Diagnostics watch;
+        world.set_output(ref(watch));
+        world.step(0.5);
+        world.finish();
+        if (T_Fail(compare_real_equal(watch.get_last().kinetic_energy, 5) && compare_real_equal(watch.get_last().upper.x(), 0.5),
+            "Measured every step")) error = true;
+    }
+
+    cout << "Speed test" << endl;
+    {
+        auto start = chrono::steady_clock::now();
+        real energy_sum = 0, mass_sum = 0;
+        vec3f momentum_sum, moment_sum;
+        lower = upper = particles[0].get_position();
+        for (const Particle& p : particles) energy_sum += 0.5 * p.get_mass() * (p.get_velocity() * p.get_velocity());
+        for (const Particle& p : particles) momentum_sum += p.get_velocity() * p.get_mass();
+        for (const Particle& p : particles)
+        {
+            moment_sum += p.get_position() * p.get_mass();
+            mass_sum += p.get_mass();
+        }
+        for (const Particle& p : particles)
+        {
+            for (int d = 0; d < 3; ++d)
+            {
+                lower[d] = min(lower[d], p.get_position()[d]);
+                upper[d] = max(upper[d], p.get_position()[d]);
+            }
+        }
+        double naive = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        const Totals& fused = parallel.measure(particles);
+        vec3f fused_lower = fused.lower, fused_upper = fused.upper;
+        double one_pass = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "\t" << count << " particles: getters, one pass per metric " << naive << " s, fused " << one_pass << " s"
+             << endl;
+        if (T_Fail(fabs(fused.kinetic_energy - energy_sum) < 1e-9 * energy_sum && fused_lower == lower && fused_upper == upper,
+            "Same metrics")) error = true;
+    }
+
+    if (error)
+    {
+        cout << "TEST DIAGNOSTICS Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST DIAGNOSTICS PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,147 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <FIZX/dispatch.hpp>
+#include <FIZX/particle.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Largest difference between two arrays, relative to the largest value.
+*/
+real max_relative_error(const real* a, const real* b, int count)
+{
+    real max_error = 0, max_value = 1e-300;
+    for (int i = 0; i < count; ++i)
+    {
+        max_error = max(max_error, abs(a[i] - b[i]));
+        max_value = max(max_value, abs(a[i]));
+    }
+    return max_error / max_value;
+}
+
+int main(void)
+{
+    cout << "TEST DISPATCH" << endl;
+    bool error = false;
+
+    // Read once, on the first use of the active path.
+    setenv("FIZX_CPU_PATH", "avx9000", 1);
+    CpuPath detected = detect_cpu_path();
+    cout << "Detected path: " << cpu_path_name(detected) << endl;
+    cout << "Active path: " << cpu_path_name(get_cpu_path()) << endl;
+    if (T_Fail(get_cpu_path() == detected, "Unknown FIZX_CPU_PATH falls back to the detected path")) error = true;
+
+    cout << "Path name test" << endl;
+    for (CpuPath path : {CpuPath::scalar, CpuPath::sse42, CpuPath::avx2, CpuPath::avx512})
+    {
+        if (T_Fail(parse_cpu_path(cpu_path_name(path)) == path, "Path names round trip")) error = true;
+    }
+    bool thrown = false;
+    try { parse_cpu_path("mmx"); } catch (const invalid_argument&) { thrown = true; }
+    if (T_Fail(thrown, "Unknown path rejected")) error = true;
+    if (T_Fail(set_cpu_path(CpuPath::avx512) == detected, "Selection limited to the CPU")) error = true;
+
+    mt19937 rng(5);
+    uniform_real_distribution<real> value(-10, 10);
+    const int count = 1'003;
+
+    vector<mat3f> a(count), b(count);
+    vector<vec3f> vectors(count);
+    for (int k = 0; k < count; ++k)
+    {
+        for (int m = 0; m < 3; ++m)
+        {
+            vectors[k][m] = value(rng);
+            for (int n = 0; n < 3; ++n)
+            {
+                a[k][m][n] = value(rng);
+                b[k][m][n] = value(rng);
+            }
+        }
+    }
+    vector<Particle> particles(count);
+    for (Particle& p : particles)
+    {
+        p.set_mass(abs(value(rng)) + 0.1);
+        p.set_position(vec3f(value(rng), value(rng), value(rng)));
+        p.set_velocity(vec3f(value(rng), value(rng), value(rng)));
+        p.set_acceleration(vec3f(0, -9.81, 0));
+        p.add_force(vec3f(value(rng), value(rng), value(rng)));
+    }
+    particles[7].set_mass(-1);
+
+    cout << "Scalar reference test" << endl;
+    set_cpu_path(CpuPath::scalar);
+    vector<mat3f> expected_products(count);
+    multiply(a.data(), b.data(), expected_products.data(), count);
+    if (T_Fail(expected_products[12] == a[12] * b[12], "Batched multiply matches Matrix")) error = true;
+    vector<vec3f> expected_vectors(count);
+    transform(a[0], vectors.data(), expected_vectors.data(), count);
+    if (T_Fail(expected_vectors[12] == a[0] * vectors[12], "Transform matches Matrix")) error = true;
+    vector<vec3f> directions = vectors;
+    directions[5] = vec3f();
+    vector<vec3f> expected_units = directions;
+    normalize(expected_units.data(), count);
+    if (T_Fail(expected_units[12] == directions[12].unit() && expected_units[5] == vec3f(), "Batched normalize matches unit")) error = true;
+    vector<vec3f> fast_units = directions;
+    fast_normalize(fast_units.data(), count);
+    if (T_Fail(max_relative_error(reinterpret_cast<real*>(expected_units.data()),
+        reinterpret_cast<real*>(fast_units.data()), count * 3) < 5e-6, "Fast normalize within 5e-6")) error = true;
+    vector<Particle> expected_particles = particles;
+    Particle::integrate_batch(expected_particles.data(), count, 0.01);
+    vector<Particle> one_by_one = particles;
+    for (Particle& p : one_by_one) p.integrate(0.01);
+    if (T_Fail(max_relative_error(reinterpret_cast<real*>(one_by_one.data()),
+        reinterpret_cast<real*>(expected_particles.data()), count * 14) < 1e-15, "Batch matches integrate")) error = true;
+
+    cout << "Differential test" << endl;
+    for (CpuPath path : {CpuPath::sse42, CpuPath::avx2, CpuPath::avx512})
+    {
+        if (path > detected) break;
+        cout << "  " << cpu_path_name(path) << endl;
+        set_cpu_path(path);
+
+        vector<mat3f> products(count);
+        multiply(a.data(), b.data(), products.data(), count);
+        if (T_Fail(max_relative_error(reinterpret_cast<real*>(expected_products.data()),
+            reinterpret_cast<real*>(products.data()), count * 9) < 1e-12, "Multiply within tolerance")) error = true;
+
+        vector<vec3f> transformed(count);
+        transform(a[0], vectors.data(), transformed.data(), count);
+        if (T_Fail(max_relative_error(reinterpret_cast<real*>(expected_vectors.data()),
+            reinterpret_cast<real*>(transformed.data()), count * 3) < 1e-12, "Transform within tolerance")) error = true;
+
+        vector<vec3f> units = directions;
+        normalize(units.data(), count);
+        if (T_Fail(max_relative_error(reinterpret_cast<real*>(expected_units.data()),
+            reinterpret_cast<real*>(units.data()), count * 3) < 1e-12, "Normalize within tolerance")) error = true;
+        units = directions;
+        fast_normalize(units.data(), count);
+        if (T_Fail(max_relative_error(reinterpret_cast<real*>(fast_units.data()),
+            reinterpret_cast<real*>(units.data()), count * 3) < 1e-12, "Fast normalize within tolerance")) error = true;
+
+        vector<Particle> integrated = particles;
+        Particle::integrate_batch(integrated.data(), count, 0.01);
+        if (T_Fail(max_relative_error(reinterpret_cast<real*>(expected_particles.data()),
+            reinterpret_cast<real*>(integrated.data()), count * 14) < 1e-12, "Integration within tolerance")) error = true;
+    }
+    set_cpu_path(detected);
+
+    if (error)
+    {
+        cout << "TEST DISPATCH Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST DISPATCH PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,177 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include <FIZX/domain.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Soft repulsion between particles closer than a metre, the forces on every particle in order.
+*/
+void repel(vector<Particle>& particles, real)
+{
+    const real cutoff = 1, stiffness = 50;
+    for (Particle& self : particles)
+    {
+        vec3f sum;
+        for (const Particle& other : particles)
+        {
+            if (&other == &self) continue;
+            const vec3f d = self.get_position() - other.get_position();
+            const real square = d * d;
+            if (square >= cutoff * cutoff || square == 0) continue;
+            const real distance = sqrt(square);
+            sum += d * (stiffness * (cutoff - distance) / distance);
+        }
+        self.add_force(sum);
+    }
+}
+
+vector<Particle> make_particles(int count, real length, mt19937& rng)
+{
+    uniform_real_distribution<real> along(0, length), across(0, 4), speed(-5, 5);
+    vector<Particle> particles(count);
+    for (Particle& p : particles)
+    {
+        p.set_position(vec3f(along(rng), across(rng), across(rng)));
+        p.set_velocity(vec3f(speed(rng), speed(rng), speed(rng)));
+    }
+    return particles;
+}
+
+int main(void)
+{
+    cout << "TEST DOMAIN DECOMPOSITION" << endl;
+    bool error = false;
+
+    cout << "Layout test" << endl;
+    DomainDecomposition layout(4, 0, 40, 1.5, 100);
+    if (T_Fail(layout.domain_of(-5) == 0 && layout.domain_of(9.99) == 0 && layout.domain_of(10) == 1, "Lower domains")) error = true;
+    if (T_Fail(layout.domain_of(39) == 3 && layout.domain_of(1e9) == 3, "Last domain reaches to infinity")) error = true;
+    bool thrown = false;
+    try { DomainDecomposition(4, 0, 40, 20, 100); } catch (const invalid_argument&) { thrown = true; }
+    if (T_Fail(thrown, "Ghosts no wider than a domain")) error = true;
+
+    cout << "Matches one process test" << endl;
+    mt19937 rng(6);
+    const int count = 300, steps = 100;
+    const real duration = 0.01;
+    vector<Particle> reference = make_particles(count, 40, rng);
+    DomainDecomposition domains(4, 0, 40, 1.5, count);
+    domains.add_force_generator(repel);
+    domains.load(reference);
+    vector<std::size_t> initial(4);
+    for (int d = 0; d < 4; ++d) initial[d] = domains.domain_size(d);
+    domains.start();
+    if (T_Fail(domains.running(), "Workers forked")) error = true;
+
+    auto start = chrono::steady_clock::now();
+    domains.step(duration, steps);
+    double split = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s)
+    {
+        repel(reference, duration);
+        Particle::integrate_batch(reference.data(), reference.size(), duration);
+    }
+    double single = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\t" << count << " particles, " << steps << " steps: one process " << single << " s, 4 domains " << split
+         << " s" << endl;
+
+    vector<Particle> gathered;
+    domains.gather(gathered);
+    real worst = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        worst = max(worst, (gathered[i].get_position() - reference[i].get_position()).magnitude());
+        worst = max(worst, (gathered[i].get_velocity() - reference[i].get_velocity()).magnitude());
+    }
+    if (T_Fail(gathered.size() == count && worst < 1e-6, "Same particles as one process")) error = true;
+    std::size_t total = 0;
+    bool migrated = false;
+    for (int d = 0; d < 4; ++d)
+    {
+        total += domains.domain_size(d);
+        if (domains.domain_size(d) != initial[d]) migrated = true;
+    }
+    if (T_Fail(total == count && migrated, "Particles handed over, none lost")) error = true;
+    bool placed = true;
+    for (const Particle& p : gathered)
+    {
+        if (p.get_position().x() < -100 || p.get_position().x() > 140) placed = false;
+    }
+    if (T_Fail(placed, "Positions sane")) error = true;
+
+    domains.step(duration, 10);
+    thrown = false;
+    try { domains.step(duration, -1); } catch (const domain_error&) { thrown = true; }
+    if (T_Fail(thrown, "Negative steps refused")) error = true;
+    thrown = false;
+    try { domains.domain_size(-1); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "Negative domain checked")) error = true;
+    domains.stop();
+    if (T_Fail(!domains.running(), "Workers stopped")) error = true;
+    thrown = false;
+    try { domains.step(duration); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "No steps without workers")) error = true;
+    domains.start();
+    domains.step(duration);
+    domains.gather(gathered);
+    if (T_Fail(gathered.size() == count, "Restarted")) error = true;
+
+    cout << "Overflow test" << endl;
+    {
+        vector<Particle> crowd(80);
+        for (int i = 0; i < 80; ++i)
+        {
+            crowd[i].set_position(vec3f(i < 40 ? 5 : 15, 0, 0));
+            crowd[i].set_velocity(vec3f(i < 40 ? 1000 : 0, 0, 0));
+        }
+        DomainDecomposition small(2, 0, 20, 1, 50);
+        small.load(crowd);
+        small.start();
+        thrown = false;
+        try { small.step(0.01); } catch (const runtime_error&) { thrown = true; }
+        if (T_Fail(thrown, "Capacity overflow reported")) error = true;
+        thrown = false;
+        crowd.resize(120, crowd[0]);
+        try { small.load(crowd); } catch (const length_error&) { thrown = true; }
+        if (T_Fail(thrown, "Load checks capacity")) error = true;
+    }
+
+    cout << "2D test" << endl;
+    {
+        vector<Particle2D> flat(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            flat[i].set_position(vec2f(i * 0.1, 0));
+            flat[i].set_velocity(vec2f(1, 0));
+        }
+        DomainDecomposition2D strips(3, 0, 10, 0.5, 100);
+        strips.load(flat);
+        strips.start();
+        strips.step(0.5, 4);
+        vector<Particle2D> moved;
+        strips.gather(moved);
+        bool ok = moved.size() == 100;
+        for (int i = 0; i < 100 && ok; ++i) ok = fabs(moved[i].get_position().x() - (i * 0.1 + 2)) < 1e-12;
+        if (T_Fail(ok && strips.domain_size(2) == 53, "Every particle moved two metres")) error = true;
+    }
+
+    if (error)
+    {
+        cout << "TEST DOMAIN DECOMPOSITION Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST DOMAIN DECOMPOSITION PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,81 @@
+#include <string>
+#include <iostream>
+
+#include <FIZX/emitter.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST EMITTER" << endl;
+    bool error = false;
+
+    cout << "Distribution test" << endl;
+    Emitter emitter(1'000);
+    emitter.set_position(vec3f(10, 0, 0), vec3f(1, 2, 0));
+    emitter.set_velocity(vec3f(0, 5, 0), vec3f(0, 1, 0));
+    emitter.set_mass(2, 4);
+    emitter.set_lifetime(1, 2);
+    emitter.set_acceleration(vec3f(0, -9.81, 0));
+
+    if (T_Fail(emitter.emit(600) == 600 && emitter.size() == 600, "Particles spawned")) error = true;
+    bool in_range = true;
+    for (int i = 0; i < 600; ++i)
+    {
+        const Particle& p = emitter[i];
+        vec3f position = p.get_position();
+        vec3f velocity = p.get_velocity();
+        if (position.x() < 9 || position.x() > 11 || position.y() < -2 || position.y() > 2 || position.z() != 0) in_range = false;
+        if (velocity.y() < 4 || velocity.y() > 6 || velocity.x() != 0) in_range = false;
+        if (p.get_mass() < 2 || p.get_mass() > 4) in_range = false;
+        if (emitter.get_lifetime(i) < 1 || emitter.get_lifetime(i) > 2) in_range = false;
+        if (p.get_acceleration().y() != -9.81) in_range = false;
+    }
+    if (T_Fail(in_range, "Spawned within the ranges")) error = true;
+    if (T_Fail(emitter.emit(600) == 400 && emitter.size() == 1'000, "Spawning stops at capacity")) error = true;
+
+    Emitter same(1'000);
+    same.set_position(vec3f(10, 0, 0), vec3f(1, 2, 0));
+    same.emit(10);
+    if (T_Fail(same[9].get_position() == emitter[9].get_position(), "Same seed spawns the same particles")) error = true;
+
+    cout << "Lifetime test" << endl;
+    // Remember the spawn order of the survivors by their lifetimes.
+    int expected = 0;
+    Particle survivor;
+    for (int i = 0; i < 1'000; ++i)
+    {
+        if (emitter.get_lifetime(i) > 1.5 && expected++ == 0) survivor = emitter[i];
+    }
+    const vec3f spawn_position = survivor.get_position();
+    const vec3f spawn_velocity = survivor.get_velocity();
+    survivor.integrate(1.5);
+    int killed = emitter.update(1.5);
+    if (T_Fail(killed == 1'000 - expected && static_cast<int>(emitter.size()) == expected, "Expired particles removed")) error = true;
+    bool alive = true;
+    for (int i = 0; i < expected; ++i)
+    {
+        if (emitter.get_lifetime(i) <= 0 || emitter.get_lifetime(i) > 0.5) alive = false;
+    }
+    if (T_Fail(alive, "Survivors aged")) error = true;
+    vec3f position = emitter[0].get_position();
+    vec3f velocity = emitter[0].get_velocity();
+    bool moved = (position - spawn_position).magnitude() > 1 && (velocity - spawn_velocity).magnitude() > 1;
+    moved = moved && (position - survivor.get_position()).magnitude() < 1e-9 && (velocity - survivor.get_velocity()).magnitude() < 1e-9;
+    if (T_Fail(moved, "Survivors integrated")) error = true;
+    emitter.age(1);
+    if (T_Fail(emitter.size() == 0, "All expired")) error = true;
+
+    if (error)
+    {
+        cout << "TEST EMITTER Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST EMITTER PASSED" << endl;
+    }
+
+    return error;
+}
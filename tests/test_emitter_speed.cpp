@@ -0,0 +1,43 @@
+#include <string>
+#include <iostream>
+#include <chrono>
+
+#include <FIZX/emitter.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST EMITTER SPEED" << endl;
+    bool error = false;
+
+    cout << "Throughput test" << endl;
+    const int capacity = 1'000'000;
+    Emitter debris(capacity);
+    debris.set_lifetime(0.5, 2);
+    const Particle* storage = debris.data();
+    int operations = 0;
+    auto start = chrono::steady_clock::now();
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        operations += debris.emit(capacity);
+        operations += debris.age(0.25);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\t" << operations << " spawns and kills in " << seconds << " s ("
+         << operations / seconds / 1e6 << " million per second)" << endl;
+    if (T_Fail(debris.data() == storage && debris.capacity() == capacity, "No reallocation")) error = true;
+
+    if (error)
+    {
+        cout << "TEST EMITTER SPEED Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST EMITTER SPEED PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,150 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+#include <FIZX/export.hpp>
+#include <FIZX/mat.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+vector<Particle> make_particles(int count)
+{
+    vector<Particle> particles(count);
+    for (int i = 0; i < count; ++i)
+    {
+        particles[i].set_position(vec3f(i / 3.0, -i * 1e-9, 1e12 + i));
+        particles[i].set_velocity(vec3f(0.1 * i, 2, -0.7));
+        particles[i].set_mass(1 + i % 5);
+    }
+    return particles;
+}
+
+/**
+ * Splits a line at the separator.
+*/
+vector<string> split(const string& line, char separator)
+{
+    vector<string> values;
+    stringstream stream(line);
+    string value;
+    while (getline(stream, value, separator)) values.push_back(value);
+    return values;
+}
+
+int main(void)
+{
+    cout << "TEST CSV EXPORT" << endl;
+    bool error = false;
+
+    cout << "Shortest text test" << endl;
+    if (T_Fail(vec3f(1, 0.5, -2).to_string() == " 1 0.5 -2", "Vector text")) error = true;
+    if (T_Fail(mat3f(1, 2, 3, 4, 5, 6, 7, 8, 0.25).to_string() == " 1 2 3\n 4 5 6\n 7 8 0.25\n", "Matrix text")) error = true;
+    string appended;
+    append_real(appended, 0.1);
+    append_real(appended, 0.1f);
+    if (T_Fail(appended == "0.10.1", "Shortest text of both precisions")) error = true;
+
+    cout << "Round trip test" << endl;
+    vector<Particle> particles = make_particles(1000);
+    stringstream text;
+    CsvExporter exporter(text, {CsvExporter::Column::position, CsvExporter::Column::velocity,
+        CsvExporter::Column::inverse_mass});
+    exporter.set_chunk_size(64);
+    exporter.write_header();
+    exporter.write(particles, 7);
+    string line;
+    getline(text, line);
+    if (T_Fail(line == "frame,index,position_x,position_y,position_z,velocity_x,velocity_y,velocity_z,inverse_mass",
+        "Header")) error = true;
+    bool exact = true;
+    int rows = 0;
+    while (getline(text, line))
+    {
+        vector<string> values = split(line, ',');
+        if (values.size() != 9 || values[0] != "7" || values[1] != to_string(rows)) { exact = false; break; }
+        const Particle& p = particles[rows];
+        real expected[7] = {p.get_position()[0], p.get_position()[1], p.get_position()[2],
+            p.get_velocity()[0], p.get_velocity()[1], p.get_velocity()[2], p.get_inverse_mass()};
+        for (int k = 0; k < 7; ++k)
+        {
+            if (strtod(values[k + 2].c_str(), nullptr) != expected[k]) exact = false;
+        }
+        ++rows;
+    }
+    if (T_Fail(rows == 1000, "One row per particle")) error = true;
+    if (T_Fail(exact, "Values read back exactly")) error = true;
+    if (T_Fail(exporter.get_bytes_written() == text.str().size(), "Bytes counted")) error = true;
+
+    cout << "Parallel test" << endl;
+    stringstream serial_text, parallel_text;
+    CsvExporter serial(serial_text), parallel(parallel_text);
+    serial.set_chunk_size(100);
+    parallel.set_chunk_size(100);
+    parallel.set_parallel(true);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        serial.write(particles, frame);
+        parallel.write(particles, frame);
+    }
+    if (T_Fail(serial_text.str() == parallel_text.str(), "Parallel output in order")) error = true;
+    // 10 chunks of 100 rows, one task per thread of the pool and the caller.
+    const std::size_t threads = WorkerPool::shared().size() + 1;
+    if (T_Fail(parallel.get_task_count() == min<std::size_t>(10, threads) && parallel.get_task_count() > 1,
+        "Chunks split across the pool")) error = true;
+
+    cout << "World output test" << endl;
+    stringstream world_text;
+    CsvExporter2D world_exporter(world_text, {CsvExporter2D::Column::position}, ';');
+    {
+        ParticleWorld2D world;
+        world.get_particles().resize(2);
+        world.get_particles()[1].set_velocity(vec2f(1, 0));
+        world.set_output(ref(world_exporter));
+        world.step(0.5);
+        world.step(0.5);
+        world.finish();
+    }
+    if (T_Fail(world_text.str() == "0;0;0;0\n0;1;0.5;0\n1;0;0;0\n1;1;1;0\n", "Exported every step")) error = true;
+
+    cout << "Speed test" << endl;
+    vector<Particle> many = make_particles(100'000);
+    auto start = chrono::steady_clock::now();
+    stringstream old_text;
+    for (int i = 0; i < static_cast<int>(many.size()); ++i)
+    {
+        old_text << 0 << "," << i << "," << many[i].get_position() << "," << many[i].get_velocity() << "\n";
+    }
+    double inserted = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stringstream new_text;
+    CsvExporter fast(new_text);
+    start = chrono::steady_clock::now();
+    fast.write(many, 0);
+    double streamed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stringstream threaded_text;
+    CsvExporter threaded(threaded_text);
+    threaded.set_parallel(true);
+    start = chrono::steady_clock::now();
+    threaded.write(many, 0);
+    double in_parallel = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\t100000 particles: operator<< " << inserted << " s, streamed " << streamed << " s, parallel "
+         << in_parallel << " s" << endl;
+    if (T_Fail(new_text.str() == threaded_text.str(), "Same text")) error = true;
+
+    if (error)
+    {
+        cout << "TEST CSV EXPORT Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST CSV EXPORT PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,118 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <FIZX/gravity.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Reference all-pairs sum of the gravitational forces.
+*/
+vector<vec3f> brute_force(const vector<Particle>& particles, real G, real softening)
+{
+    vector<vec3f> forces(particles.size());
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+        for (std::size_t j = 0; j < particles.size(); ++j)
+        {
+            if (i == j) continue;
+            vec3f d = particles[j].get_position() - particles[i].get_position();
+            real r2 = d * d + softening * softening;
+            forces[i].add_scaled_vector(d, G * particles[i].get_mass() * particles[j].get_mass() / (r2 * sqrt(r2)));
+        }
+    }
+    return forces;
+}
+
+/**
+ * Largest force error relative to the largest reference force.
+*/
+real relative_error(const vector<Particle>& particles, const vector<vec3f>& expected)
+{
+    real max_force = 0, max_error = 0;
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+        vec3f error = particles[i].get_net_force() - expected[i];
+        max_error = max(max_error, sqrt(error * error));
+        max_force = max(max_force, sqrt(expected[i] * expected[i]));
+    }
+    return max_error / max_force;
+}
+
+int main(void)
+{
+    cout << "TEST GRAVITY" << endl;
+    bool error = false;
+
+    cout << "Two body test" << endl;
+    vector<Particle> pair(2);
+    pair[0].set_mass(10);
+    pair[1].set_mass(20);
+    pair[1].set_position(vec3f(2, 0, 0));
+    NBodyGravity unit_gravity(1.0);
+    unit_gravity.apply(pair);
+    if (T_Fail(pair[0].get_net_force() == vec3f(50, 0, 0), "Two body attraction")) error = true;
+    if (T_Fail(pair[1].get_net_force() == vec3f(-50, 0, 0), "Two body reaction")) error = true;
+
+    cout << "Infinite mass test" << endl;
+    pair[0].clear_forces();
+    pair[1].clear_forces();
+    pair[1].set_mass(-1);
+    unit_gravity.apply(pair);
+    if (T_Fail(pair[0].get_net_force() == vec3f(0, 0, 0), "Infinite mass is not a source")) error = true;
+    if (T_Fail(pair[1].get_net_force() == vec3f(0, 0, 0), "Infinite mass is not attracted")) error = true;
+
+    cout << "Cluster test" << endl;
+    mt19937 rng(7);
+    uniform_real_distribution<real> position(-100, 100);
+    uniform_real_distribution<real> mass(1, 10);
+    vector<Particle> cluster(2'000);
+    for (Particle& p : cluster)
+    {
+        p.set_mass(mass(rng));
+        p.set_position(vec3f(position(rng), position(rng), position(rng)));
+    }
+    // A tight clump forces the tree down to its deepest levels.
+    for (int i = 0; i < 50; ++i)
+    {
+        cluster[i].set_position(vec3f(1e-6 * i, 0, 0));
+    }
+    vector<vec3f> expected = brute_force(cluster, 1.0, 0.01);
+
+    NBodyGravity exact(1.0, 0.0, 0.01);
+    exact.apply(cluster);
+    if (T_Fail(relative_error(cluster, expected) < 1e-9, "Zero opening angle matches all-pairs")) error = true;
+
+    const OctreeNode& root = exact.get_tree().get_nodes()[0];
+    if (T_Fail(static_cast<std::size_t>(root.next) == exact.get_tree().get_nodes().size(), "Root spans the pool")) error = true;
+    if (T_Fail(root.body_end == 2'000, "Root holds every body")) error = true;
+
+    for (Particle& p : cluster) p.clear_forces();
+    NBodyGravity approximate(1.0, 0.5, 0.01);
+    approximate.apply(cluster);
+    if (T_Fail(relative_error(cluster, expected) < 1e-2, "Barnes-Hut approximation")) error = true;
+
+    cout << "Integration test" << endl;
+    pair[1].set_mass(20);
+    pair[0].clear_forces();
+    pair[1].clear_forces();
+    unit_gravity.apply(pair);
+    pair[0].integrate(1.0);
+    if (T_Fail(pair[0].get_velocity() == vec3f(5, 0, 0), "Force is integrated")) error = true;
+    if (T_Fail(pair[0].get_net_force() == vec3f(0, 0, 0), "Force is cleared")) error = true;
+
+    if (error)
+    {
+        cout << "TEST GRAVITY Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST GRAVITY PASSED" << endl;
+    }
+
+    return error;
+}
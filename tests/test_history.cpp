@@ -0,0 +1,112 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <FIZX/history.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Moves the particles under gravity with a little drag.
+*/
+void advance(vector<Particle>& particles)
+{
+    for (Particle& p : particles)
+    {
+        p.add_force(vec3f(0, -9.81, 0) * p.get_mass());
+        p.integrate(1.0 / 60.0);
+    }
+}
+
+bool same_state(const vector<Particle>& a, const vector<Particle>& b, real tolerance)
+{
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        vec3f dp = a[i].get_position() - b[i].get_position();
+        vec3f dv = a[i].get_velocity() - b[i].get_velocity();
+        for (int d = 0; d < 3; ++d)
+        {
+            if (abs(dp[d]) > tolerance || abs(dv[d]) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    cout << "TEST HISTORY" << endl;
+    bool error = false;
+
+    mt19937 rng(3);
+    uniform_real_distribution<real> spread(-50, 50);
+    vector<Particle> particles(500);
+    for (Particle& p : particles)
+    {
+        p.set_position(vec3f(spread(rng), spread(rng), spread(rng)));
+        p.set_velocity(vec3f(spread(rng), spread(rng), spread(rng)));
+    }
+
+    cout << "Lossless test" << endl;
+    History lossless(16);
+    vector<vector<Particle>> snapshots;
+    for (int step = 0; step < 100; ++step)
+    {
+        lossless.record(step, particles);
+        snapshots.push_back(particles);
+        advance(particles);
+    }
+    if (T_Fail(lossless.size() == 100, "Every step stored")) error = true;
+    vector<Particle> restored = particles;
+    lossless.load(37, restored);
+    if (T_Fail(same_state(restored, snapshots[37], 0), "Random access is exact")) error = true;
+    lossless.load(99, restored);
+    if (T_Fail(same_state(restored, snapshots[99], 0), "Newest step is exact")) error = true;
+
+    cout << "Rewind test" << endl;
+    lossless.rewind(50, particles);
+    if (T_Fail(lossless.newest_step() == 50, "Later steps dropped")) error = true;
+    for (int step = 51; step < 60; ++step)
+    {
+        advance(particles);
+        lossless.record(step, particles);
+    }
+    lossless.load(59, restored);
+    if (T_Fail(same_state(restored, particles, 0), "Recording resumes after rewind")) error = true;
+    if (T_Fail(same_state(restored, snapshots[59], 0), "Replay is deterministic")) error = true;
+
+    cout << "Quantized test" << endl;
+    const real quantum = 1e-6;
+    History quantized(32, 64 << 20, quantum);
+    for (int step = 0; step < 64; ++step)
+    {
+        quantized.record(step, snapshots[step]);
+    }
+    quantized.load(63, restored);
+    if (T_Fail(same_state(restored, snapshots[63], quantum), "Quantized error is bounded")) error = true;
+    double full_bytes = 64.0 * particles.size() * 6 * sizeof(real);
+    if (T_Fail(quantized.bytes() < 0.5 * full_bytes, "Quantized deltas are compact")) error = true;
+
+    cout << "Budget test" << endl;
+    History bounded(10, 1'000'000);
+    for (int step = 0; step < 100; ++step)
+    {
+        bounded.record(step, snapshots[step]);
+    }
+    if (T_Fail(bounded.bytes() <= 1'000'000, "Budget respected")) error = true;
+    if (T_Fail(!bounded.contains(0) && bounded.contains(99), "Oldest steps dropped first")) error = true;
+    if (T_Fail(bounded.oldest_step() % 10 == 0, "Drops whole keyframes")) error = true;
+
+    if (error)
+    {
+        cout << "TEST HISTORY Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST HISTORY PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,191 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include <FIZX/matbatch.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Largest absolute difference between the elements of two matrices.
+*/
+template <fizx::size_t MRows, fizx::size_t NCols>
+real difference(const Matrix<real, MRows, NCols>& a, const Matrix<real, MRows, NCols>& b)
+{
+    real worst = 0;
+    for (fizx::size_t m = 0; m < MRows; ++m)
+    {
+        for (fizx::size_t n = 0; n < NCols; ++n)
+        {
+            worst = max(worst, fabs(a[m][n] - b[m][n]));
+        }
+    }
+    return worst;
+}
+
+template <fizx::size_t NElems>
+Matrix<real, NElems, NElems> random_matrix(mt19937& rng)
+{
+    uniform_real_distribution<real> value(-1, 1);
+    Matrix<real, NElems, NElems> matrix;
+    for (fizx::size_t m = 0; m < NElems; ++m)
+    {
+        for (fizx::size_t n = 0; n < NElems; ++n)
+        {
+            matrix[m][n] = value(rng) + (m == n ? 3 : 0);
+        }
+    }
+    return matrix;
+}
+
+/**
+ * True if every inverse times its matrix is the identity.
+*/
+template <fizx::size_t NElems>
+bool inverts(mt19937& rng)
+{
+    using matrix = Matrix<real, NElems, NElems>;
+    vector<matrix> matrices(37);
+    for (matrix& m : matrices) m = random_matrix<NElems>(rng);
+    MatrixBatch<real, NElems, NElems> batch, inverted;
+    batch.load(matrices);
+    inverse(batch, inverted);
+    matrix identity;
+    for (fizx::size_t i = 0; i < NElems; ++i) identity[i][i] = 1;
+    bool ok = inverted.size() == matrices.size();
+    for (int k = 0; k < 37 && ok; ++k) ok = difference(inverted.get(k) * matrices[k], identity) < 1e-12;
+    return ok;
+}
+
+int main(void)
+{
+    cout << "TEST MATRIX BATCH" << endl;
+    bool error = false;
+
+    cout << "Conversion test" << endl;
+    mt19937 rng(48);
+    vector<mat3f> matrices(21), again;
+    for (mat3f& m : matrices) m = random_matrix<3>(rng);
+    mat3fBatch batch;
+    batch.load(matrices);
+    if (T_Fail(batch.size() == 21 && batch.get_stride() == 24, "Padded to the lane alignment")) error = true;
+    if (T_Fail(batch.row(1, 2)[5] == matrices[5][1][2] && batch.row(1, 2)[6] == matrices[6][1][2], "Element rows")) error = true;
+    batch.store(again);
+    bool same = again.size() == matrices.size();
+    for (int k = 0; k < 21 && same; ++k) same = again[k] == matrices[k];
+    if (T_Fail(same, "Round trip")) error = true;
+    batch.set(3, mat3f(1, 2, 3, 4, 5, 6, 7, 8, 9));
+    if (T_Fail(batch.get(3) == mat3f(1, 2, 3, 4, 5, 6, 7, 8, 9), "Set and get")) error = true;
+    bool thrown = false;
+    try { batch.get(21); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "Index checked")) error = true;
+    batch.resize(30);
+    if (T_Fail(batch.get(3) == mat3f(1, 2, 3, 4, 5, 6, 7, 8, 9) && batch.get(29) == mat3f(), "Resize keeps matrices")) error = true;
+    batch.resize(21);
+    batch.resize(22);
+    if (T_Fail(batch.get(21) == mat3f() && batch.get(20) == matrices[20], "Dropped matrices come back zero")) error = true;
+    batch.resize(21);
+    batch.set(3, matrices[3]);
+
+    cout << "Operations test" << endl;
+    vector<mat3f> others(21);
+    for (mat3f& m : others) m = random_matrix<3>(rng);
+    mat3fBatch other, out;
+    other.load(others);
+    add(batch, other, out);
+    bool ok = true;
+    for (int k = 0; k < 21; ++k) ok = ok && difference(out.get(k), matrices[k] + others[k]) < 1e-15;
+    if (T_Fail(ok, "Add")) error = true;
+    scale(batch, real(2.5), out);
+    ok = true;
+    for (int k = 0; k < 21; ++k) ok = ok && difference(out.get(k), matrices[k] * 2.5) < 1e-15;
+    if (T_Fail(ok, "Scale")) error = true;
+    out = batch;
+    out += other;
+    out *= 2;
+    ok = true;
+    for (int k = 0; k < 21; ++k) ok = ok && difference(out.get(k), (matrices[k] + others[k]) * 2) < 1e-14;
+    if (T_Fail(ok, "In place")) error = true;
+    multiply(batch, other, out);
+    ok = true;
+    for (int k = 0; k < 21; ++k) ok = ok && difference(out.get(k), matrices[k] * others[k]) < 1e-14;
+    if (T_Fail(ok, "Multiply")) error = true;
+    thrown = false;
+    try { multiply(batch, other, batch); } catch (const invalid_argument&) { thrown = true; }
+    if (T_Fail(thrown, "Product over an operand")) error = true;
+    thrown = false;
+    other.resize(20);
+    try { add(batch, other, out); } catch (const invalid_argument&) { thrown = true; }
+    if (T_Fail(thrown, "Sizes checked")) error = true;
+
+    MatrixBatch<real, 2, 3> wide(4);
+    MatrixBatch<real, 3, 2> tall;
+    wide.set(1, mat2x3f(1, 2, 3, 4, 5, 6));
+    transpose(wide, tall);
+    if (T_Fail(tall.size() == 4 && tall.get(1) == mat3x2f(1, 4, 2, 5, 3, 6), "Transpose")) error = true;
+    MatrixBatch<real, 2, 2> square;
+    multiply(wide, tall, square);
+    if (T_Fail(square.get(1) == mat2f(14, 32, 32, 77) && square.get(0) == mat2f(), "Multiply shapes")) error = true;
+
+    vec3fBatch vectors(21), transformed;
+    for (int k = 0; k < 21; ++k) vectors.set(k, vec3f(k, 1, -2));
+    multiply(batch, vectors, transformed);
+    ok = true;
+    for (int k = 0; k < 21; ++k)
+    {
+        vec3f expected = matrices[k] * vec3f(k, 1, -2);
+        ok = ok && (transformed.get_vector(k) - expected).magnitude() < 1e-14;
+    }
+    if (T_Fail(ok, "Matrix vector")) error = true;
+
+    cout << "Inverse test" << endl;
+    if (T_Fail(inverts<2>(rng), "2x2 inverse")) error = true;
+    if (T_Fail(inverts<3>(rng), "3x3 inverse")) error = true;
+    if (T_Fail(inverts<4>(rng), "4x4 inverse")) error = true;
+    batch.set(7, mat3f(1, 2, 3, 2, 4, 6, 0, 0, 1));
+    thrown = false;
+    try { inverse(batch, out); } catch (const domain_error&) { thrown = true; }
+    if (T_Fail(thrown, "Singular matrix found")) error = true;
+
+    cout << "Speed test" << endl;
+    {
+        const int count = 200'000, repeats = 20;
+        vector<mat3f> a(count), b(count), c(count);
+        for (int k = 0; k < count; ++k)
+        {
+            a[k] = random_matrix<3>(rng);
+            b[k] = random_matrix<3>(rng);
+        }
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            for (int k = 0; k < count; ++k) c[k] = a[k] * b[k];
+        }
+        double matrices = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        mat3fBatch x, y, z;
+        x.load(a);
+        y.load(b);
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) multiply(x, y, z);
+        double batched = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "\t" << count << " 3x3 products x " << repeats << ": vector of matrices " << matrices << " s, batch "
+             << batched << " s" << endl;
+        if (T_Fail(difference(z.get(count - 1), c[count - 1]) < 1e-14, "Same products")) error = true;
+    }
+
+    if (error)
+    {
+        cout << "TEST MATRIX BATCH Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST MATRIX BATCH PASSED" << endl;
+    }
+
+    return error;
+}
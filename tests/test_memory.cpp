@@ -0,0 +1,185 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+
+#include <FIZX/memory.hpp>
+#include <FIZX/contact.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+/**
+ * Forwards to operator new, counting the calls and the bytes held.
+*/
+class CountingAllocator : public Allocator
+{
+public:
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+
+    void* allocate(std::size_t size, std::size_t alignment) override
+    {
+        ++allocations;
+        bytes += size;
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void deallocate(void* pointer, std::size_t size, std::size_t alignment) override
+    {
+        bytes -= size;
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+};
+
+int main(void)
+{
+    cout << "TEST MEMORY" << endl;
+    bool error = false;
+    MemoryAccount& account = MemoryAccount::shared();
+
+    cout << "Accounting test" << endl;
+    {
+        CountingAllocator counting;
+        account.set_allocator(&counting);
+        const std::size_t before = account.get_current(Subsystem::broadphase);
+        {
+            tracked_vector<std::int32_t, Subsystem::broadphase> values;
+            for (int i = 0; i < 1000; ++i) values.push_back(i);
+            const std::size_t held = account.get_current(Subsystem::broadphase) - before;
+            if (T_Fail(held == values.capacity() * sizeof(std::int32_t), "Capacity charged")) error = true;
+            if (T_Fail(counting.allocations > 0 && counting.bytes == held, "Routed to the installed allocator")) error = true;
+            if (T_Fail(account.get_peak(Subsystem::broadphase) >= before + held, "Peak kept")) error = true;
+        }
+        if (T_Fail(account.get_current(Subsystem::broadphase) == before && counting.bytes == 0, "Released")) error = true;
+        if (T_Fail(account.get_peak(Subsystem::broadphase) > before, "Peak outlives the memory")) error = true;
+        account.reset_peaks();
+        if (T_Fail(account.get_peak(Subsystem::broadphase) == before, "Peaks reset")) error = true;
+        account.set_allocator(nullptr);
+    }
+
+    cout << "Budget test" << endl;
+    {
+        account.set_budget(account.get_total() + 1000);
+        tracked_vector<char, Subsystem::history> data(500, 'a');
+        bool refused = false;
+        try
+        {
+            data.resize(5000);
+        }
+        catch (const BudgetExceeded& exceeded)
+        {
+            refused = exceeded.subsystem == Subsystem::history && exceeded.bytes == 5000;
+        }
+        if (T_Fail(refused, "Over budget refused")) error = true;
+        if (T_Fail(data.size() == 500 && data[499] == 'a', "Container left as it was")) error = true;
+        bool caught = false;
+        try
+        {
+            tracked_vector<char, Subsystem::contacts> more(2000);
+        }
+        catch (const std::bad_alloc&)
+        {
+            caught = true;
+        }
+        if (T_Fail(caught, "Caught as bad_alloc")) error = true;
+        account.set_budget(0);
+        data.resize(5000);
+        if (T_Fail(data.size() == 5000, "No limit once lifted")) error = true;
+    }
+
+    cout << "Arena test" << endl;
+    {
+        const std::size_t before = account.get_current(Subsystem::scratch);
+        ScratchArena arena(256);
+        char* small = arena.allocate<char>(3);
+        double* aligned = arena.allocate<double>(10);
+        void* line = arena.allocate(100, 64);
+        std::int32_t* large = arena.allocate<std::int32_t>(1000);
+        bool ok = reinterpret_cast<std::uintptr_t>(aligned) % alignof(double) == 0
+            && reinterpret_cast<std::uintptr_t>(line) % 64 == 0 && small && large;
+        if (T_Fail(ok, "Aligned")) error = true;
+        for (int i = 0; i < 1000; ++i) large[i] = i;
+        const std::size_t capacity = arena.get_capacity();
+        if (T_Fail(capacity >= 4000 + 256 && arena.get_used() >= 4000 + 83, "Grew past the first block")) error = true;
+        if (T_Fail(account.get_current(Subsystem::scratch) > before + capacity - 64, "Blocks charged to scratch")) error = true;
+        arena.reset();
+        if (T_Fail(arena.get_capacity() == capacity && arena.get_used() == 0, "Merged into one block")) error = true;
+        const std::size_t merged = account.get_current(Subsystem::scratch);
+        for (int cycle = 0; cycle < 10; ++cycle)
+        {
+            arena.reset();
+            arena.allocate<char>(3);
+            arena.allocate<double>(10);
+            arena.allocate(100, 64);
+            arena.allocate<std::int32_t>(1000);
+        }
+        if (T_Fail(arena.get_capacity() == capacity && account.get_current(Subsystem::scratch) == merged,
+            "Steady cycles allocate nothing")) error = true;
+    }
+    if (T_Fail(account.get_current(Subsystem::scratch) == 0, "Arena released")) error = true;
+
+    cout << "World test" << endl;
+    {
+        mt19937 rng(5);
+        uniform_real_distribution<real> position(0, 10);
+        ParticleWorld world;
+        world.get_particles().resize(2000);
+        for (Particle& p : world.get_particles()) p.set_position(vec3f(position(rng), position(rng), position(rng)));
+        ContactSolver solver(0.3);
+        world.set_resolver([&](vector<Particle>& particles, real duration) { solver.solve(particles, duration); });
+        std::size_t scratch_bytes = 0;
+        world.set_narrowphase([&](vector<Particle>& particles, real)
+        {
+            real* temporaries = world.get_scratch().allocate<real>(particles.size());
+            for (std::size_t i = 0; i < particles.size(); ++i) temporaries[i] = 0;
+            scratch_bytes = world.get_scratch().get_used();
+        });
+        world.step(0.01);
+        world.step(0.01);
+        const std::size_t particle_bytes = world.get_particles().capacity() * sizeof(Particle);
+        if (T_Fail(account.get_current(Subsystem::particles) == particle_bytes, "Particles charged")) error = true;
+        if (T_Fail(account.get_current(Subsystem::broadphase) > 0, "Neighbour lists charged")) error = true;
+        if (T_Fail(account.get_current(Subsystem::contacts) > 0, "Contacts charged")) error = true;
+        if (T_Fail(scratch_bytes == 2000 * sizeof(real), "Scratch reset every step")) error = true;
+        cout << "\tparticles " << account.get_current(Subsystem::particles) << " B, broadphase "
+             << account.get_current(Subsystem::broadphase) << " B, contacts " << account.get_current(Subsystem::contacts)
+             << " B, scratch " << account.get_current(Subsystem::scratch) << " B, total peak " << account.get_total_peak()
+             << " B" << endl;
+
+        account.set_budget(account.get_total() + (1 << 20));
+        world.get_particles().resize(100'000);
+        bool refused = false;
+        try
+        {
+            world.step(0.01);
+        }
+        catch (const BudgetExceeded& exceeded)
+        {
+            refused = exceeded.subsystem == Subsystem::particles;
+        }
+        if (T_Fail(refused && world.get_frame() == 2, "Step refused before running")) error = true;
+        world.get_particles().resize(2000);
+        world.get_particles().shrink_to_fit();
+        world.step(0.01);
+        if (T_Fail(world.get_frame() == 3, "Steps again within the budget")) error = true;
+        account.set_budget(0);
+    }
+    if (T_Fail(account.get_current(Subsystem::particles) == 0, "World released its particles")) error = true;
+    if (T_Fail(account.get_current(Subsystem::contacts) == 0, "Solver released its contacts")) error = true;
+
+    if (error)
+    {
+        cout << "TEST MEMORY Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST MEMORY PASSED" << endl;
+    }
+
+    return error;
+}
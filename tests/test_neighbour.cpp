@@ -0,0 +1,108 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include <FIZX/neighbour.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST NEIGHBOUR LIST" << endl;
+    bool error = false;
+
+    mt19937 rng(11);
+    uniform_real_distribution<real> position(0, 20);
+    vector<Particle> particles(1'500);
+    for (Particle& p : particles)
+    {
+        p.set_position(vec3f(position(rng), position(rng), position(rng)));
+    }
+
+    cout << "Build test" << endl;
+    NeighbourList list(1.0, 0.3);
+    if (T_Fail(list.update(particles), "First update builds")) error = true;
+    const NeighbourList::index_list& offsets = list.get_offsets();
+    const NeighbourList::index_list& indices = list.get_indices();
+    bool lists_match = offsets.size() == particles.size() + 1;
+    for (std::size_t i = 0; i < particles.size() && lists_match; ++i)
+    {
+        vector<int> expected;
+        for (std::size_t j = 0; j < particles.size(); ++j)
+        {
+            vec3f d = particles[j].get_position() - particles[i].get_position();
+            if (i != j && d * d <= 1.3 * 1.3) expected.push_back(j);
+        }
+        vector<int> found(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+        sort(found.begin(), found.end());
+        lists_match = found == expected;
+    }
+    if (T_Fail(lists_match, "Lists match all-pairs search")) error = true;
+
+    cout << "Reuse test" << endl;
+    particles[0].set_position(particles[0].get_position() + vec3f(0.1, 0, 0));
+    if (T_Fail(!list.update(particles), "Small move keeps the lists")) error = true;
+    particles[0].set_position(particles[0].get_position() + vec3f(0.1, 0, 0));
+    if (T_Fail(list.update(particles), "Move past half the skin rebuilds")) error = true;
+    if (T_Fail(list.get_build_count() == 2, "Build count")) error = true;
+    particles.emplace_back();
+    if (T_Fail(list.needs_rebuild(particles), "New particle rebuilds")) error = true;
+    particles.pop_back();
+
+    cout << "Force test" << endl;
+    // Linear repulsion inside the cutoff.
+    auto repulsion = [](const Particle& self, const Particle& other)
+    {
+        vec3f d = self.get_position() - other.get_position();
+        return d * (1.0 - sqrt(d * d));
+    };
+    list.apply(particles, repulsion);
+    bool forces_match = true;
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+        vec3f expected;
+        for (std::size_t j = 0; j < particles.size(); ++j)
+        {
+            vec3f d = particles[j].get_position() - particles[i].get_position();
+            if (i != j && d * d <= 1.0) expected += repulsion(particles[i], particles[j]);
+        }
+        if (!(particles[i].get_net_force() == expected)) forces_match = false;
+    }
+    if (T_Fail(forces_match, "Forces match all-pairs evaluation")) error = true;
+
+    cout << "2D test" << endl;
+    vector<Particle2D> planar(1'000);
+    for (Particle2D& p : planar)
+    {
+        p.set_position(vec2f(position(rng), position(rng)));
+    }
+    NeighbourList2D planar_list(1.0, 0.2);
+    planar_list.build(planar);
+    lists_match = true;
+    for (std::size_t i = 0; i < planar.size() && lists_match; ++i)
+    {
+        int expected = 0;
+        for (std::size_t j = 0; j < planar.size(); ++j)
+        {
+            vec2f d = planar[j].get_position() - planar[i].get_position();
+            if (i != j && d * d <= 1.2 * 1.2) ++expected;
+        }
+        lists_match = planar_list.neighbour_count(i) == expected;
+    }
+    if (T_Fail(lists_match, "2D lists match all-pairs search")) error = true;
+
+    if (error)
+    {
+        cout << "TEST NEIGHBOUR LIST Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST NEIGHBOUR LIST PASSED" << endl;
+    }
+
+    return error;
+}
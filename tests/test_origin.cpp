@@ -0,0 +1,114 @@
+#include <string>
+#include <iostream>
+#include <cmath>
+
+#include <FIZX/origin.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST FLOATING ORIGIN" << endl;
+    bool error = false;
+
+    cout << "Conversion test" << endl;
+    Vector<double, 3> wide(1e7 + 0.25, -2.5, 3);
+    Vector<float, 3> narrow(wide);
+    if (T_Fail(narrow[1] == -2.5f && narrow[2] == 3.0f, "Elements converted")) error = true;
+    Vector<double, 3> back(narrow);
+    if (T_Fail(back[0] == static_cast<float>(1e7 + 0.25), "Converted back")) error = true;
+
+    cout << "Far from the world origin test" << endl;
+    // At 1e7 m a float is 1 m apart, a 1 mm/s crawl would never move.
+    FloatingOrigin far(FloatingOrigin::anchor_type(1e7, 0, 0));
+    int crawler = far.add(FloatingOrigin::anchor_type(1e7, 0, 0), FloatingOrigin::offset_type(0.001f, 0, 0));
+    far.set_focus(crawler);
+    for (int step = 0; step < 1000; ++step) far.integrate(0.01f);
+    double moved = far.get_position(crawler)[0] - 1e7;
+    if (T_Fail(fabs(moved - 0.01) < 1e-6, "Crawler moved 1 cm")) error = true;
+    float alone = 1e7f;
+    for (int step = 0; step < 1000; ++step) alone += 0.001f * 0.01f;
+    if (T_Fail(alone == 1e7f, "A plain float stays put")) error = true;
+
+    cout << "Long travel test" << endl;
+    // 100 km at 333 m/s, with and without rebasing.
+    const float dt = 0.01f;
+    const int steps = 30'000;
+    FloatingOrigin rebased(FloatingOrigin::anchor_type(), 256);
+    FloatingOrigin fixed(FloatingOrigin::anchor_type(), 1e12);
+    FloatingOrigin::offset_type velocity(333.3f, 0.5f, 0);
+    int a = rebased.add(FloatingOrigin::anchor_type(), velocity);
+    int b = fixed.add(FloatingOrigin::anchor_type(), velocity);
+    int companion = rebased.add(FloatingOrigin::anchor_type(0, 1, 0), velocity);
+    rebased.set_focus(a);
+    fixed.set_focus(b);
+    for (int step = 0; step < steps; ++step)
+    {
+        rebased.integrate(dt);
+        fixed.integrate(dt);
+    }
+    // Exact answer, the float velocity over the float step, summed in double.
+    double expected = static_cast<double>(velocity[0]) * static_cast<double>(dt) * steps;
+    double rebased_error = fabs(rebased.get_position(a)[0] - expected);
+    double fixed_error = fabs(fixed.get_position(b)[0] - expected);
+    cout << "\tError after " << expected / 1000 << " km: rebased " << rebased_error << " m, fixed " << fixed_error << " m" << endl;
+    if (T_Fail(rebased.get_rebase_count() > 100, "Origin followed the focus")) error = true;
+    if (T_Fail(fixed.get_rebase_count() == 0, "Fixed origin never moved")) error = true;
+    if (T_Fail(rebased_error < 0.5, "Rebased travel is accurate")) error = true;
+    if (T_Fail(rebased_error * 10 < fixed_error, "Rebasing beats a fixed origin")) error = true;
+    FloatingOrigin::anchor_type gap = rebased.get_position(companion) - rebased.get_position(a);
+    if (T_Fail(fabs(gap[1] - 1) < 1e-4 && fabs(gap[0]) < 1e-3, "Neighbours keep their spacing")) error = true;
+
+    cout << "Rebase test" << endl;
+    FloatingOrigin2D flat;
+    int p = flat.add(FloatingOrigin2D::anchor_type(5e6, 3.25));
+    flat.rebase(FloatingOrigin2D::anchor_type(5e6, 0));
+    if (T_Fail(flat.get_offset(p)[0] == 0 && flat.get_offset(p)[1] == 3.25f, "Offset shifted in double")) error = true;
+    if (T_Fail(flat.get_position(p)[0] == 5e6, "Absolute position kept")) error = true;
+    flat.set_focus_point(FloatingOrigin2D::anchor_type(5e6 + 2000, 0));
+    if (T_Fail(flat.rebase_if_needed() && flat.get_anchor()[0] == 5e6 + 2000, "Rebased to the focus point")) error = true;
+    if (T_Fail(!flat.rebase_if_needed(), "No rebase at the focus")) error = true;
+
+    cout << "Force test" << endl;
+    FloatingOrigin pushed;
+    int heavy = pushed.add(FloatingOrigin::anchor_type(), FloatingOrigin::offset_type(), 0.5f);
+    int wall = pushed.add(FloatingOrigin::anchor_type(1, 0, 0), FloatingOrigin::offset_type(), 0);
+    pushed.add_force(heavy, FloatingOrigin::offset_type(4, 0, 0));
+    pushed.add_force(wall, FloatingOrigin::offset_type(4, 0, 0));
+    pushed.integrate(1);
+    if (T_Fail(pushed.get_velocity(heavy)[0] == 2, "Force over mass")) error = true;
+    pushed.integrate(1);
+    if (T_Fail(pushed.get_velocity(heavy)[0] == 2, "Force cleared")) error = true;
+    if (T_Fail(pushed.get_position(wall)[0] == 1, "Infinite mass stays")) error = true;
+    bool thrown = false;
+    try { pushed.add_force(-1, FloatingOrigin::offset_type(1, 0, 0)); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "Negative index checked")) error = true;
+
+    cout << "Damping test" << endl;
+    FloatingOrigin damped;
+    int slowed = damped.add(FloatingOrigin::anchor_type(), FloatingOrigin::offset_type(4, 0, 0));
+    damped.set_damping(0.5f);
+    // Position first, then velocity scaled by damping^duration, as BasicParticle::integrate.
+    double speed = 4, travelled = 0;
+    for (int step = 0; step < 4; ++step)
+    {
+        damped.integrate(0.5f);
+        travelled += speed * 0.5;
+        speed *= pow(0.5, 0.5);
+    }
+    if (T_Fail(fabs(damped.get_velocity(slowed)[0] - speed) < 1e-6, "Velocity damped")) error = true;
+    if (T_Fail(fabs(damped.get_position(slowed)[0] - travelled) < 1e-5, "Damped travel")) error = true;
+
+    if (error)
+    {
+        cout << "TEST FLOATING ORIGIN Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST FLOATING ORIGIN PASSED" << endl;
+    }
+
+    return error;
+}
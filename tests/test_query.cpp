@@ -0,0 +1,224 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include <FIZX/query.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+template <int Dim>
+vector<BasicParticle<Dim>> scatter(int count, real extent, mt19937& rng)
+{
+    uniform_real_distribution<real> across(0, extent);
+    vector<BasicParticle<Dim>> particles(count);
+    for (BasicParticle<Dim>& p : particles)
+    {
+        Vector<real, Dim> position;
+        for (int d = 0; d < Dim; ++d) position[d] = across(rng);
+        p.set_position(position);
+    }
+    return particles;
+}
+
+/**
+ * Nearest hit of one ray by testing every particle.
+*/
+template <int Dim>
+typename BasicSceneQuery<Dim>::RayHit brute_raycast(const vector<BasicParticle<Dim>>& particles, real radius,
+    const typename BasicSceneQuery<Dim>::Ray& ray)
+{
+    typename BasicSceneQuery<Dim>::RayHit hit = {BasicSceneQuery<Dim>::NO_HIT, ray.max_distance};
+    const Vector<real, Dim> direction = ray.direction.unit();
+    for (int i = 0; i < static_cast<int>(particles.size()); ++i)
+    {
+        const Vector<real, Dim> offset = ray.origin - particles[i].get_position();
+        const real b = offset * direction, c = offset * offset - radius * radius;
+        if (c > 0 && b > 0) continue;
+        if (b * b - c < 0) continue;
+        const real t = max<real>(0, -b - sqrt(b * b - c));
+        if (t < hit.distance || (t == hit.distance && hit.particle == BasicSceneQuery<Dim>::NO_HIT))
+        {
+            hit.particle = i;
+            hit.distance = t;
+        }
+    }
+    return hit;
+}
+
+template <int Dim>
+bool check_random(int count, real radius, real extent, int queries, unsigned seed)
+{
+    using Query = BasicSceneQuery<Dim>;
+    mt19937 rng(seed);
+    vector<BasicParticle<Dim>> particles = scatter<Dim>(count, extent, rng);
+    Query query(radius);
+    query.build(particles);
+    bool ok = true;
+
+    uniform_real_distribution<real> across(-2, extent + 2), direction(-1, 1), size(0, 3);
+    auto point = [&]()
+    {
+        Vector<real, Dim> p;
+        for (int d = 0; d < Dim; ++d) p[d] = across(rng);
+        return p;
+    };
+
+    vector<typename Query::Ray> rays(queries);
+    for (typename Query::Ray& ray : rays)
+    {
+        ray.origin = point();
+        for (int d = 0; d < Dim; ++d) ray.direction[d] = direction(rng);
+        ray.max_distance = size(rng) * extent;
+    }
+    // Axis aligned rays take the zero direction paths.
+    rays[0].direction = Vector<real, Dim>();
+    rays[0].direction[0] = 1;
+    vector<typename Query::RayHit> hits;
+    query.raycast(rays, hits);
+    for (int r = 0; r < queries; ++r)
+    {
+        typename Query::RayHit expected = brute_raycast(particles, radius, rays[r]);
+        if (hits[r].particle != expected.particle || fabs(hits[r].distance - expected.distance) > 1e-9) ok = false;
+    }
+
+    vector<typename Query::Sphere> spheres(queries);
+    vector<typename Query::Box> boxes(queries);
+    for (int q = 0; q < queries; ++q)
+    {
+        spheres[q] = {point(), size(rng)};
+        boxes[q].lower = point();
+        boxes[q].upper = boxes[q].lower;
+        for (int d = 0; d < Dim; ++d) boxes[q].upper[d] += size(rng);
+    }
+    vector<int> offsets, indices;
+    query.overlap(spheres, offsets, indices);
+    for (int q = 0; q < queries && ok; ++q)
+    {
+        vector<int> expected;
+        for (int i = 0; i < count; ++i)
+        {
+            const real reach = spheres[q].radius + radius;
+            if (spheres[q].centre.square_distance(particles[i].get_position()) <= reach * reach) expected.push_back(i);
+        }
+        if (!equal(expected.begin(), expected.end(), indices.begin() + offsets[q], indices.begin() + offsets[q + 1])
+            || static_cast<int>(expected.size()) != offsets[q + 1] - offsets[q]) ok = false;
+    }
+    query.overlap(boxes, offsets, indices);
+    for (int q = 0; q < queries && ok; ++q)
+    {
+        vector<int> expected;
+        for (int i = 0; i < count; ++i)
+        {
+            Vector<real, Dim> closest = particles[i].get_position();
+            for (int d = 0; d < Dim; ++d) closest[d] = min(max(closest[d], boxes[q].lower[d]), boxes[q].upper[d]);
+            if (closest.square_distance(particles[i].get_position()) <= radius * radius) expected.push_back(i);
+        }
+        if (!equal(expected.begin(), expected.end(), indices.begin() + offsets[q], indices.begin() + offsets[q + 1])
+            || static_cast<int>(expected.size()) != offsets[q + 1] - offsets[q]) ok = false;
+    }
+    return ok;
+}
+
+int main(void)
+{
+    cout << "TEST SCENE QUERY" << endl;
+    bool error = false;
+
+    cout << "Ray test" << endl;
+    vector<Particle> particles(3);
+    particles[0].set_position(vec3f(5, 0, 0));
+    particles[1].set_position(vec3f(10, 0, 0));
+    particles[2].set_position(vec3f(0, 0, 0));
+    SceneQuery query(1);
+    query.build(particles);
+    if (T_Fail(query.size() == 3 && query.get_cell() >= 2, "Cells a diameter across")) error = true;
+    vector<SceneQuery::Ray> rays = {
+        {vec3f(2, 0, 0), vec3f(2, 0, 0), 100},
+        {vec3f(20, 0, 0), vec3f(-1, 0, 0), 100},
+        {vec3f(2, 0, 0), vec3f(1, 0, 0), 1.5},
+        {vec3f(0, 0.5, 0), vec3f(0, 1, 0), 100},
+        {vec3f(-3, 3, 0), vec3f(1, 0, 0), 100},
+        {vec3f(0, 5, 0), vec3f(), 100}};
+    vector<SceneQuery::RayHit> hits;
+    query.raycast(rays, hits);
+    if (T_Fail(hits[0].particle == 0 && compare_real_equal(hits[0].distance, 2), "Nearest along the ray")) error = true;
+    if (T_Fail(hits[1].particle == 1 && compare_real_equal(hits[1].distance, 9), "From outside the grid")) error = true;
+    if (T_Fail(hits[2].particle == SceneQuery::NO_HIT && hits[2].distance == 1.5, "Out of reach")) error = true;
+    if (T_Fail(hits[3].particle == 2 && hits[3].distance == 0, "Starting inside")) error = true;
+    if (T_Fail(hits[4].particle == SceneQuery::NO_HIT && hits[5].particle == SceneQuery::NO_HIT, "Misses")) error = true;
+
+    cout << "Overlap test" << endl;
+    vector<SceneQuery::Sphere> spheres = {{vec3f(7.5, 0, 0), 1.5}, {vec3f(7.5, 0, 0), 1.4}, {vec3f(0, 0, 0), 20}};
+    vector<int> offsets, indices;
+    query.overlap(spheres, offsets, indices);
+    vector<int> expected_offsets = {0, 2, 2, 5};
+    vector<int> expected_indices = {0, 1, 0, 1, 2};
+    if (T_Fail(offsets == expected_offsets && indices == expected_indices, "Spheres touching, in order")) error = true;
+    vector<SceneQuery::Box> boxes = {{vec3f(6, -1, -1), vec3f(9, 1, 1)}, {vec3f(7, 1, 0), vec3f(30, 2, 0)},
+        {vec3f(1, 1, 1), vec3f(0, 0, 0)}};
+    query.overlap(boxes, offsets, indices);
+    expected_offsets = {0, 2, 3, 3};
+    expected_indices = {0, 1, 1};
+    if (T_Fail(offsets == expected_offsets && indices == expected_indices, "Boxes touching, inverted box empty")) error = true;
+    particles.clear();
+    query.build(particles);
+    query.raycast(rays, hits);
+    query.overlap(spheres, offsets, indices);
+    if (T_Fail(hits[0].particle == SceneQuery::NO_HIT && indices.empty() && offsets.size() == 4, "Empty scene")) error = true;
+
+    cout << "Brute force test" << endl;
+    if (T_Fail(check_random<3>(2000, 0.3, 20, 500, 1), "Same as every particle in 3D")) error = true;
+    if (T_Fail(check_random<3>(300, 1, 5, 300, 2), "Dense 3D")) error = true;
+    if (T_Fail(check_random<2>(2000, 0.2, 30, 500, 3), "Same as every particle in 2D")) error = true;
+
+    cout << "Speed test" << endl;
+    {
+        mt19937 rng(4);
+        const int count = 100'000, queries = 10'000;
+        const real radius = 0.25, extent = 200;
+        vector<Particle> many = scatter<3>(count, extent, rng);
+        uniform_real_distribution<real> across(0, extent), direction(-1, 1);
+        vector<SceneQuery::Ray> batch(queries);
+        for (SceneQuery::Ray& ray : batch)
+        {
+            ray = {vec3f(across(rng), across(rng), across(rng)), vec3f(direction(rng), direction(rng), direction(rng)), 20};
+        }
+        SceneQuery scene(radius);
+        auto start = chrono::steady_clock::now();
+        scene.build(many);
+        double built = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        scene.raycast(batch, hits);
+        double batched = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        const int sampled = 100;
+        bool same = true;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < sampled; ++r)
+        {
+            SceneQuery::RayHit hit = brute_raycast(many, radius, batch[r]);
+            if (hit.particle != hits[r].particle) same = false;
+        }
+        double scanned = chrono::duration<double>(chrono::steady_clock::now() - start).count() * queries / sampled;
+        cout << "\t" << queries << " rays against " << count << " particles: build " << built << " s, batched "
+             << batched << " s, linear scan about " << scanned << " s" << endl;
+        if (T_Fail(same, "Same hits as the scan")) error = true;
+        if (T_Fail(batched < scanned, "Faster than a linear scan")) error = true;
+    }
+
+    if (error)
+    {
+        cout << "TEST SCENE QUERY Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST SCENE QUERY PASSED" << endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,121 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+#include <FIZX/scheduler.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST SCHEDULER" << endl;
+    bool error = false;
+
+    WorkerPool pool(3);
+
+    cout << "Dependency order test" << endl;
+    // a -> b, a -> c, (b, c) -> d
+    mutex order_mutex;
+    vector<string> order;
+    auto record = [&](string name)
+    {
+        return [&, name]()
+        {
+            lock_guard<mutex> lock(order_mutex);
+            order.push_back(name);
+        };
+    };
+    TaskGraph graph;
+    int a = graph.add_task("a", record("a"));
+    int b = graph.add_task("b", record("b"));
+    int c = graph.add_task("c", record("c"));
+    int d = graph.add_task("d", record("d"));
+    graph.add_dependency(a, b);
+    graph.add_dependency(a, c);
+    graph.add_dependency(b, d);
+    graph.add_dependency(c, d);
+    for (int run = 0; run < 100; ++run)
+    {
+        order.clear();
+        graph.run(pool);
+        if (T_Fail(order.size() == 4 && order.front() == "a" && order.back() == "d", "Dependencies respected"))
+        {
+            error = true;
+            break;
+        }
+    }
+
+    cout << "Concurrency test" << endl;
+    // Two independent tasks that can only finish if they run at the same time.
+    atomic<int> arrived{0};
+    TaskGraph rendezvous;
+    auto meet = [&]()
+    {
+        ++arrived;
+        while (arrived.load() < 2) this_thread::yield();
+    };
+    rendezvous.add_task("left", meet);
+    rendezvous.add_task("right", meet);
+    rendezvous.run(pool);
+    if (T_Fail(arrived.load() == 2, "Independent tasks run concurrently")) error = true;
+
+    cout << "Cycle test" << endl;
+    TaskGraph cycle;
+    int x = cycle.add_task("x", []() {});
+    int y = cycle.add_task("y", []() {});
+    cycle.add_dependency(x, y);
+    cycle.add_dependency(y, x);
+    bool thrown = false;
+    try { cycle.run(pool); } catch (const logic_error&) { thrown = true; }
+    if (T_Fail(thrown, "Cycle detected")) error = true;
+    thrown = false;
+    try { cycle.add_dependency(-1, x); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "Negative task checked")) error = true;
+
+    cout << "Exception test" << endl;
+    TaskGraph failing;
+    bool after_ran = false;
+    int fail = failing.add_task("fail", []() { throw runtime_error("task failed"); });
+    int after = failing.add_task("after", [&]() { after_ran = true; });
+    failing.add_dependency(fail, after);
+    thrown = false;
+    try { failing.run(pool); } catch (const runtime_error&) { thrown = true; }
+    if (T_Fail(thrown, "Task exception rethrown")) error = true;
+    if (T_Fail(!after_ran, "Dependents of a failed task skipped")) error = true;
+
+    cout << "Nested parallel test" << endl;
+    // Tasks of a graph on the shared pool each run a parallel loop on the same pool.
+    vector<int> values(100'000, 1);
+    atomic<long long> total{0};
+    TaskGraph nested;
+    for (int t = 0; t < 4; ++t)
+    {
+        nested.add_task("sum", [&]()
+        {
+            parallel_for(values.size(), [&](fizx::size_t begin, fizx::size_t end)
+            {
+                long long sum = 0;
+                for (int i = begin; i < end; ++i) sum += values[i];
+                total += sum;
+            }, 1'000);
+        });
+    }
+    nested.run();
+    if (T_Fail(total.load() == 400'000, "Nested parallel loops")) error = true;
+
+    if (error)
+    {
+        cout << "TEST SCHEDULER Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST SCHEDULER PASSED" << endl;
+    }
+
+    return error;
+}
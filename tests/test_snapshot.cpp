@@ -0,0 +1,121 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include <FIZX/snapshot.hpp>
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST STATE SNAPSHOT" << endl;
+    bool error = false;
+
+    cout << "Publish test" << endl;
+    StateBuffer buffer;
+    if (T_Fail(!buffer.acquire().valid(), "Nothing to view before the first publish")) error = true;
+
+    vector<Particle> particles(4);
+    for (int i = 0; i < 4; ++i) particles[i].set_position(vec3f(i, 0, 0));
+    buffer.publish(particles, 0);
+    StateView first = buffer.acquire();
+    if (T_Fail(first.valid() && first.version() == 0, "View of the published step")) error = true;
+    if (T_Fail(first.positions().size() == 4 && first.positions()[3].x() == 3, "Positions published")) error = true;
+
+    // The held view must not change while later steps are published around it.
+    const vec3f* held = first.positions().data();
+    for (int step = 1; step < 10; ++step)
+    {
+        for (Particle& p : particles) p.set_position(vec3f(step, step, step));
+        if (T_Fail(buffer.publish(particles, step), "Publishing not held up by one reader")) error = true;
+    }
+    if (T_Fail(first.positions().data() == held && first.positions()[3].x() == 3, "Held view unchanged")) error = true;
+    StateView latest = buffer.acquire();
+    if (T_Fail(latest.version() == 9 && latest.positions()[0].y() == 9, "Latest step viewed")) error = true;
+
+    // With the third slot held as well, the next step has nowhere to go.
+    if (T_Fail(buffer.publish(particles, 10), "Third slot used")) error = true;
+    StateView third = buffer.acquire();
+    if (T_Fail(!buffer.publish(particles, 11) && buffer.get_skipped() == 1, "Step skipped while all slots held")) error = true;
+    first.release();
+    if (T_Fail(!first.valid() && buffer.publish(particles, 11), "Released slot reused")) error = true;
+    if (T_Fail(latest.version() == 9 && third.version() == 10, "Held views kept their version")) error = true;
+    latest.release();
+    third.release();
+
+    cout << "Budget test" << endl;
+    {
+        // Every slot that fails to grow must be handed back.
+        MemoryAccount& account = MemoryAccount::shared();
+        vector<Particle> more(10'000);
+        account.set_budget(account.get_total() + 1);
+        int refused = 0;
+        for (int attempt = 0; attempt < 4; ++attempt)
+        {
+            try { buffer.publish(more, 100 + attempt); } catch (const BudgetExceeded&) { ++refused; }
+        }
+        account.set_budget(0);
+        StateView kept = buffer.acquire();
+        if (T_Fail(refused == 4 && kept.version() == 11, "Refused steps leave the latest")) error = true;
+        kept.release();
+        bool published = true;
+        for (int step = 0; step < 3; ++step) published = published && buffer.publish(more, 200 + step);
+        if (T_Fail(published && buffer.acquire().positions().size() == 10'000, "Slots given back")) error = true;
+    }
+
+    cout << "Concurrent reader test" << endl;
+    ParticleWorld world;
+    world.set_state_publishing(true);
+    world.get_particles().resize(1'000);
+    for (Particle& p : world.get_particles()) p.set_velocity(vec3f(1, 1, 1));
+
+    const int steps = 500;
+    atomic<bool> running(true);
+    atomic<bool> consistent(true);
+    atomic<int> views(0);
+    // Triple buffering never skips a step with a single reader.
+    thread reader([&]()
+    {
+        int last = 0;
+        while (running.load())
+        {
+            StateView view = world.get_state().acquire();
+            if (!view.valid()) continue;
+            // Every particle moves together, so a torn step would show mixed positions.
+            const StateView::vec_list& positions = view.positions();
+            real x = positions.front().x();
+            for (const vec3f& position : positions)
+            {
+                if (position.x() != x || position.z() != x) consistent = false;
+            }
+            if (view.version() < last) consistent = false;
+            last = view.version();
+            ++views;
+        }
+    });
+    for (int i = 0; i < steps || views.load() == 0; ++i) world.step(0.01);
+    running = false;
+    reader.join();
+
+    StateView final_view = world.get_state().acquire();
+    if (T_Fail(consistent.load(), "Reader never saw a torn or older step")) error = true;
+    if (T_Fail(views.load() > 0, "Reader got views")) error = true;
+    if (T_Fail(final_view.version() == world.get_frame() - 1, "Last step published")) error = true;
+    if (T_Fail(compare_real_equal(final_view.positions()[0].x(), world.get_particles()[0].get_position().x()), "Published state matches")) error = true;
+
+    if (error)
+    {
+        cout << "TEST STATE SNAPSHOT Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST STATE SNAPSHOT PASSED" << endl;
+    }
+
+    return error;
+}
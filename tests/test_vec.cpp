@@ -1,6 +1,7 @@
 #include <string>
 #include <iostream>
 #include <assert.h>
+#include <cmath>
 
 #include <FIZX/vec.hpp>
 #include "test_lib.hpp"
@@ -73,6 +74,49 @@ int main(void)
     v = vec4f(-1, 2, 4, 0.5);
     if (T_Fail(u * v == -10, "Dot product")) error = true;
 
+    cout << "Magnitude test" << endl;
+    x = vec3f(3, 4, 12);
+    if (T_Fail(x.square_magnitude() == 169 && x.magnitude() == 13, "Magnitude")) error = true;
+    if (T_Fail(fabs(x.fast_magnitude() - 13) < 13 * 5e-6, "Fast magnitude")) error = true;
+    if (T_Fail(vec3f(1, 1, 1).distance(vec3f(4, 5, 13)) == 13, "Distance")) error = true;
+    if (T_Fail(vec3f(1, 1, 1).square_distance(vec3f(4, 5, 13)) == 169, "Square distance")) error = true;
+
+    cout << "Normalize test" << endl;
+    y = x.unit();
+    if (T_Fail(y == vec3f(3.0 / 13, 4.0 / 13, 12.0 / 13), "Unit vector")) error = true;
+    x.normalize();
+    if (T_Fail(x == y, "Normalize in place")) error = true;
+    z = vec3f();
+    z.normalize();
+    if (T_Fail(z == vec3f(), "Zero vector left unchanged")) error = true;
+    z.fast_normalize();
+    if (T_Fail(z == vec3f() && vec3f().fast_magnitude() == 0, "Zero vector left unchanged by fast")) error = true;
+
+    cout << "Approximation test" << endl;
+    real worst = 0;
+    for (real value = 1e-12; value < 1e12; value *= 1.37)
+    {
+        worst = max(worst, fabs(inverse_sqrt_approx(value) * sqrt(value) - 1));
+    }
+    if (T_Fail(worst < 5e-6, "Inverse square root within 5e-6")) error = true;
+    float worst_float = 0;
+    for (float value = 1e-6f; value < 1e6f; value *= 1.37f)
+    {
+        worst_float = max(worst_float, fabs(inverse_sqrt_approx(value) * sqrt(value) - 1));
+    }
+    if (T_Fail(worst_float < 1e-5f, "Float inverse square root within 1e-5")) error = true;
+    y = vec3f(-7, 0.5, 2).fast_unit();
+    if (T_Fail(fabs(y.magnitude() - 1) < 5e-6, "Fast unit vector")) error = true;
+
+    cout << "Cross product test" << endl;
+    if (T_Fail(vec3f(1, 0, 0).cross(vec3f(0, 1, 0)) == vec3f(0, 0, 1), "Cross product")) error = true;
+    x = vec3f(2, -1, 3);
+    y = vec3f(0.5, 4, -2);
+    z = x.cross(y);
+    if (T_Fail(compare_real_equal(z * x, 0) && compare_real_equal(z * y, 0), "Cross product orthogonal")) error = true;
+    if (T_Fail(y.cross(x) == z * -1, "Cross product anticommutative")) error = true;
+    if (T_Fail(vec4f(0, 1, 0, 7).cross(vec4f(0, 0, 1, 3)) == vec4f(1, 0, 0, 0), "Homogeneous cross product")) error = true;
+
     if (error)
     {
         cout << "TEST VECTOR Ended with errors" << endl;
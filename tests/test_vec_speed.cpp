@@ -0,0 +1,90 @@
+#include <FIZX/param.hpp>
+#include <FIZX/core.hpp>
+#include <FIZX/vec.hpp>
+#include <FIZX/dispatch.hpp>
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "test_lib.hpp"
+
+using namespace fizx;
+
+/**
+ * Fills vectors with the same pseudo random directions every run.
+*/
+template <typename V>
+void fill(std::vector<V>& vectors)
+{
+    unsigned int seed = 7;
+    for (V& v : vectors)
+    {
+        for (int n = 0; n < static_cast<int>(v.size()); ++n)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            v[n] = static_cast<real>(seed >> 8) / (1 << 24) * 20 - 10;
+        }
+    }
+}
+
+/**
+ * Times repeats calls of work over count vectors and prints nanoseconds per vector.
+*/
+template <typename Work>
+void time(const char* name, std::size_t count, int repeats, Work work)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) work();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count() / (count * repeats);
+    std::cout << name << ": " << ns << " [ns/vector]" << std::endl;
+}
+
+template <typename V>
+void benchmark(const char* dimension, std::size_t count, int repeats)
+{
+    std::vector<V> source(count), vectors(count);
+    fill(source);
+    real sink = 0;
+    std::cout << dimension << ", " << count << " vectors" << std::endl;
+
+    vectors = source;
+    time("  sqrt and division", count, repeats, [&]()
+    {
+        for (V& v : vectors) v *= 1 / std::sqrt(v * v);
+    });
+    sink += vectors[1][0];
+    vectors = source;
+    time("  normalize", count, repeats, [&]()
+    {
+        for (V& v : vectors) v.normalize();
+    });
+    sink += vectors[1][0];
+    vectors = source;
+    time("  fast_normalize", count, repeats, [&]()
+    {
+        for (V& v : vectors) v.fast_normalize();
+    });
+    sink += vectors[1][0];
+    vectors = source;
+    time("  batch normalize", count, repeats, [&]()
+    {
+        normalize(vectors.data(), count);
+    });
+    sink += vectors[1][0];
+    vectors = source;
+    time("  batch fast_normalize", count, repeats, [&]()
+    {
+        fast_normalize(vectors.data(), count);
+    });
+    sink += vectors[1][0];
+    std::cout << "  (" << sink << ")" << std::endl;
+}
+
+int main(void)
+{
+    std::cout << "Path: " << cpu_path_name(get_cpu_path()) << std::endl;
+    benchmark<vec3f>("vec3f", 1024, 10000);
+    benchmark<vec4f>("vec4f", 1024, 10000);
+    return 0;
+}
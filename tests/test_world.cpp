@@ -0,0 +1,87 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <atomic>
+
+#include <FIZX/world.hpp>
+#include "test_lib.hpp"
+
+using namespace fizx;
+using namespace std;
+
+int main(void)
+{
+    cout << "TEST WORLD" << endl;
+    bool error = false;
+
+    cout << "Phase order test" << endl;
+    ParticleWorld world;
+    world.get_particles().resize(1'000);
+    vector<string> phases;
+    world.add_force_generator([&](vector<Particle>& particles, real)
+    {
+        phases.push_back("forces");
+        for (Particle& p : particles) p.add_force(vec3f(0, -10, 0));
+    });
+    world.set_broadphase([&](vector<Particle>&, real) { phases.push_back("broadphase"); });
+    world.set_narrowphase([&](vector<Particle>&, real) { phases.push_back("narrowphase"); });
+    world.set_resolver([&](vector<Particle>&, real) { phases.push_back("resolution"); });
+    world.step(0.5);
+    if (T_Fail((phases == vector<string>{"forces", "broadphase", "narrowphase", "resolution"}), "Phases run in order")) error = true;
+    if (T_Fail(world.get_particles()[999].get_velocity() == vec3f(0, -5, 0), "Particles integrated")) error = true;
+    if (T_Fail(world.get_frame() == 1, "Frame counted")) error = true;
+
+    cout << "Custom task test" << endl;
+    int integrated_seen = -1;
+    TaskGraph& graph = world.get_graph();
+    int check = graph.add_task("check", [&]() { integrated_seen = world.get_frame(); });
+    graph.add_dependency(world.get_phase_task(ParticleWorld::Phase::integration), check);
+    graph.add_dependency(check, world.get_phase_task(ParticleWorld::Phase::output));
+    world.step(0.5);
+    if (T_Fail(integrated_seen == 1, "Custom task runs within the step")) error = true;
+
+    cout << "Pipelined output test" << endl;
+    vector<int> frames;
+    vector<real> speeds;
+    atomic<int> in_flight{0};
+    bool overlapped = true;
+    world.set_output([&](const vector<Particle>& particles, fizx::size_t frame)
+    {
+        if (++in_flight != 1) overlapped = false;
+        frames.push_back(frame);
+        speeds.push_back(-particles[0].get_velocity().y());
+        --in_flight;
+    });
+    for (int s = 0; s < 5; ++s)
+    {
+        world.step(0.5);
+    }
+    world.finish();
+    if (T_Fail((frames == vector<int>{2, 3, 4, 5, 6}), "Every frame exported in order")) error = true;
+    if (T_Fail(overlapped, "One export in flight at a time")) error = true;
+    if (T_Fail(speeds.size() == 5 && speeds[0] == 15 && speeds[4] == 35, "Exports see their own frame")) error = true;
+
+    cout << "2D test" << endl;
+    if (T_Fail(sizeof(Particle2D) < sizeof(Particle), "2D particles are smaller")) error = true;
+    ParticleWorld2D planar;
+    planar.get_particles().resize(10);
+    planar.get_particles()[3].set_velocity(vec2f(1, 2));
+    planar.add_force_generator([](vector<Particle2D>& particles, real)
+    {
+        for (Particle2D& p : particles) p.add_force(vec2f(0, -10));
+    });
+    planar.step(0.5);
+    if (T_Fail(planar.get_particles()[3].get_position() == vec2f(0.5, 1), "2D position integrated")) error = true;
+    if (T_Fail(planar.get_particles()[3].get_velocity() == vec2f(1, -3), "2D velocity integrated")) error = true;
+
+    if (error)
+    {
+        cout << "TEST WORLD Ended with errors" << endl;
+    }
+    else
+    {
+        cout << "TEST WORLD PASSED" << endl;
+    }
+
+    return error;
+}